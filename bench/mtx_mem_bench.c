@@ -0,0 +1,90 @@
+/**
+ * @file mtx_mem_bench.c
+ * @brief Compares matrix allocation policies on a blocked multiply and strided column swaps
+ *
+ * Build with the library sources and OpenMP, e.g.
+ *   gcc -O2 -fopenmp -Iinclude bench/mtx_mem_bench.c mtx_*.c -lm -lpthread -o mtx_mem_bench
+ * Usage: mtx_mem_bench [n] [reps]
+ * Run under `numactl --cpunodebind=all` on a multi-socket host; explicit huge pages
+ * need reserved pages (/proc/sys/vm/nr_hugepages).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mtx_repmem.h"
+#include "mtx_actions.h"
+#include "mtx_arithmetic.h"
+#include "mtx_metrics.h"
+
+typedef struct {
+    const char *name;
+    mtx_mem_policy policy;
+} bench_case;
+
+static const bench_case cases[] = {
+    {"malloc",              {MTX_MEM_DEFAULT, MTX_PAGES_DEFAULT, 0, MTX_MEM_THRESHOLD}},
+    {"thp",                 {MTX_MEM_DEFAULT, MTX_PAGES_TRANSPARENT, 0, MTX_MEM_THRESHOLD}},
+    {"hugetlb",             {MTX_MEM_DEFAULT, MTX_PAGES_HUGE, 0, MTX_MEM_THRESHOLD}},
+    {"interleave",          {MTX_MEM_INTERLEAVE, MTX_PAGES_DEFAULT, 0, MTX_MEM_THRESHOLD}},
+    {"interleave+thp",      {MTX_MEM_INTERLEAVE, MTX_PAGES_TRANSPARENT, 0, MTX_MEM_THRESHOLD}},
+    {"first-touch",         {MTX_MEM_FIRST_TOUCH, MTX_PAGES_DEFAULT, 0, MTX_MEM_THRESHOLD}},
+    {"first-touch+thp",     {MTX_MEM_FIRST_TOUCH, MTX_PAGES_TRANSPARENT, 0, MTX_MEM_THRESHOLD}},
+    {"bind node 0",         {MTX_MEM_BIND, MTX_PAGES_DEFAULT, 0, MTX_MEM_THRESHOLD}},
+};
+
+static void fill(matrix *m, size_t n, unsigned seed) {
+    srand(seed);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            *mtx_ptr(m, i, j) = rand() / (double)RAND_MAX - 0.5;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    const size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 2048;
+    const int reps = argc > 2 ? atoi(argv[2]) : 3;
+
+    printf("n = %zu, reps = %d\n", n, reps);
+    printf("%-18s %12s %12s %12s\n", "policy", "alloc ms", "mul GF/s", "swap_cols ms");
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        uint64_t t0 = mtx_metrics_now();
+        matrix *A = mtx_alloc_policy(n, n, &cases[c].policy);
+        matrix *B = mtx_alloc_policy(n, n, &cases[c].policy);
+        matrix *C = mtx_alloc_policy(n, n, &cases[c].policy);
+        const double alloc_ms = (mtx_metrics_now() - t0) / 1e6;
+        if (!A || !B || !C) {
+            printf("%-18s allocation failed\n", cases[c].name);
+            mtx_free(A);
+            mtx_free(B);
+            mtx_free(C);
+            continue;
+        }
+
+        fill(A, n, 1);
+        fill(B, n, 2);
+
+        // Warm-up faults in any pages left untouched by the policy
+        mtx_mul2(C, A, B);
+
+        t0 = mtx_metrics_now();
+        for (int r = 0; r < reps; r++) mtx_mul2(C, A, B);
+        const double mul_s = (mtx_metrics_now() - t0) / 1e9;
+
+        t0 = mtx_metrics_now();
+        for (int r = 0; r < reps; r++) {
+            for (size_t j = 0; j + 1 < n; j += 2) mtx_swap_cols(A, j, j + 1);
+        }
+        const double swap_ms = (mtx_metrics_now() - t0) / 1e6 / reps;
+
+        printf("%-18s %12.2f %12.2f %12.2f\n", cases[c].name, alloc_ms,
+               2.0 * n * n * n * reps / mul_s / 1e9, swap_ms);
+
+        mtx_free(A);
+        mtx_free(B);
+        mtx_free(C);
+    }
+
+    return 0;
+}
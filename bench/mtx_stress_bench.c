@@ -0,0 +1,191 @@
+/**
+ * @file mtx_stress_bench.c
+ * @brief Runs mixed library calls from many threads at once and reports throughput scaling
+ *
+ * Build with the library sources and OpenMP, e.g.
+ *   gcc -O2 -fopenmp -Iinclude bench/mtx_stress_bench.c mtx_*.c -lm -lpthread -o mtx_stress_bench
+ * Usage: mtx_stress_bench [max_threads] [seconds] [n] [log]
+ * Doubles the thread count from 1 to max_threads (default: online CPUs). Each
+ * thread binds its own context, keeps OpenMP to one thread, and loops over
+ * multiply, add, norm, Gauss and LU solves, copy-on-write clones and a call
+ * that fails on purpose, on n x n matrices (default 64). The failing call
+ * checks that mtx_last_error reports this thread's own failure. log = 1
+ * keeps MTX_LOG output on to measure its cost.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "mtx_repmem.h"
+#include "mtx_actions.h"
+#include "mtx_arithmetic.h"
+#include "mtx_calcs.h"
+#include "mtx_factor.h"
+#include "mtx_context.h"
+#include "mtx_metrics.h"
+
+typedef struct {
+    size_t n;
+    int log;
+    unsigned seed;
+    unsigned long long ops;     // calls completed
+    unsigned long long wrong;   // failures not reported as this thread's own
+} worker;
+
+static atomic_int go, stop;
+
+static void fill(matrix *m, size_t n, unsigned *seed) {
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < mtx_get_width(m); j++) {
+            *mtx_ptr(m, i, j) = rand_r(seed) / (double)RAND_MAX - 0.5 + (i == j ? (double)n : 0.0);
+        }
+    }
+}
+
+static void *run(void *p) {
+    worker *w = p;
+    const size_t n = w->n;
+#ifdef _OPENMP
+    omp_set_num_threads(1);
+#endif
+
+    mtx_context *ctx = mtx_context_create();
+    if (!ctx) return NULL;
+    mtx_context_set_logging(ctx, w->log);
+    mtx_context_bind(ctx);
+
+    matrix *A = mtx_alloc(n, n), *B = mtx_alloc(n, n), *C = mtx_alloc(n, n);
+    matrix *b = mtx_alloc(1, n), *bad = mtx_alloc(n + 1, n);
+    if (!A || !B || !C || !b || !bad) goto out;
+    fill(A, n, &w->seed);
+    fill(B, n, &w->seed);
+    fill(b, n, &w->seed);
+
+    while (!atomic_load(&go)) sched_yield();
+
+    for (unsigned long long it = 0; !atomic_load_explicit(&stop, memory_order_relaxed); it++) {
+        switch (it % 7) {
+        case 0:
+            mtx_mul2(C, A, B);
+            break;
+        case 1:
+            mtx_add2(C, A, B);
+            break;
+        case 2: {
+            volatile double d = mtx_norm_fro(C);
+            (void)d;
+            break;
+        }
+        case 3:
+            mtx_free(mtx_solve_gauss(A, b));
+            break;
+        case 4: {
+            mtx_lu *lu = mtx_lu_factor(A);
+            matrix *x = mtx_copy(b);
+            if (lu && x) mtx_lu_solve(lu, x);
+            mtx_free(x);
+            mtx_lu_free(lu);
+            break;
+        }
+        case 5: {
+            matrix *c = mtx_clone(A);
+            if (c) mtx_smul(c, 0.5);
+            mtx_free(c);
+            break;
+        }
+        default:
+            mtx_clear_error();
+            if (mtx_add2(C, A, bad) != -1 || !mtx_last_error()->func ||
+                strcmp(mtx_last_error()->func, "mtx_add2") != 0) {
+                w->wrong++;
+            }
+            break;
+        }
+        w->ops++;
+    }
+
+out:
+    mtx_free(A);
+    mtx_free(B);
+    mtx_free(C);
+    mtx_free(b);
+    mtx_free(bad);
+    mtx_context_bind(NULL);
+    mtx_context_free(ctx);
+    return NULL;
+}
+
+/**
+ * @brief Runs t workers for the given time
+ * @return Calls per second over all workers, -1 if threads could not start
+ */
+static double stress(size_t t, double seconds, size_t n, int log, unsigned long long *wrong) {
+    pthread_t *th = malloc(t * sizeof(pthread_t));
+    worker *w = calloc(t, sizeof(worker));
+    if (!th || !w) {
+        free(th);
+        free(w);
+        return -1.0;
+    }
+
+    atomic_store(&go, 0);
+    atomic_store(&stop, 0);
+    size_t started = 0;
+    for (; started < t; started++) {
+        w[started] = (worker){.n = n, .log = log, .seed = 1234u + (unsigned)started};
+        if (pthread_create(&th[started], NULL, run, &w[started]) != 0) break;
+    }
+
+    const uint64_t t0 = mtx_metrics_now();
+    atomic_store(&go, 1);
+    struct timespec ts = {(time_t)seconds, (long)((seconds - (time_t)seconds) * 1e9)};
+    while (nanosleep(&ts, &ts) != 0) {}
+    atomic_store(&stop, 1);
+    for (size_t i = 0; i < started; i++) pthread_join(th[i], NULL);
+    const double s = (mtx_metrics_now() - t0) / 1e9;
+
+    unsigned long long ops = 0;
+    *wrong = 0;
+    for (size_t i = 0; i < started; i++) {
+        ops += w[i].ops;
+        *wrong += w[i].wrong;
+    }
+    free(th);
+    free(w);
+    return started == t ? ops / s : -1.0;
+}
+
+int main(int argc, char **argv) {
+    const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    const size_t max_t = argc > 1 ? strtoul(argv[1], NULL, 10) : (cpus > 0 ? (size_t)cpus : 1);
+    const double seconds = argc > 2 ? strtod(argv[2], NULL) : 1.0;
+    const size_t n = argc > 3 ? strtoul(argv[3], NULL, 10) : 64;
+    const int log = argc > 4 ? atoi(argv[4]) : 0;
+
+    // The failing calls would flood stderr otherwise
+    mtx_context_set_logging(mtx_context_default(), log);
+
+    printf("%8s %14s %10s %10s %8s\n", "threads", "calls/s", "speedup", "efficiency", "wrong");
+    double base = 0.0;
+    for (size_t t = 1; t <= max_t; t = t < max_t && 2 * t > max_t ? max_t : 2 * t) {
+        unsigned long long wrong;
+        const double rate = stress(t, seconds, n, log, &wrong);
+        if (rate < 0.0) {
+            fprintf(stderr, "could not start %zu threads\n", t);
+            return 1;
+        }
+        if (t == 1) base = rate;
+        printf("%8zu %14.0f %10.2f %9.0f%% %8llu\n", t, rate, rate / base, 100.0 * rate / base / t, wrong);
+        if (t == max_t) break;
+    }
+    return 0;
+}
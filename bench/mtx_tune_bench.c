@@ -0,0 +1,75 @@
+/**
+ * @file mtx_tune_bench.c
+ * @brief Tunes the kernel parameters for this machine and writes the profile
+ *
+ * Build with the library sources and OpenMP, e.g.
+ *   gcc -O2 -fopenmp -Iinclude bench/mtx_tune_bench.c mtx_*.c -lm -lpthread -o mtx_tune_bench
+ * Usage: mtx_tune_bench [profile] [n]
+ * The profile defaults to $MTX_TUNE_PROFILE, then $HOME/.mtx_tune. Run it with
+ * the OMP_NUM_THREADS the workload will use. n sets the size of the blocked
+ * multiply used to compare the cache-derived defaults with the tuned values.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mtx_repmem.h"
+#include "mtx_arithmetic.h"
+#include "mtx_metrics.h"
+#include "mtx_tune.h"
+
+static void show(const char *name, const mtx_tune_params *p) {
+    printf("%-10s tile %zux%zux%zu  skinny_width %zu  par_min %zu  L1 %zuK L2 %zuK L3 %zuK\n",
+           name, p->block_i, p->block_k, p->block_j, p->skinny_width, p->par_min,
+           p->l1 >> 10, p->l2 >> 10, p->l3 >> 10);
+}
+
+static double gflops(size_t n) {
+    matrix *A = mtx_alloc(n, n), *B = mtx_alloc(n, n), *C = mtx_alloc(n, n);
+    if (!A || !B || !C) {
+        mtx_free(A);
+        mtx_free(B);
+        mtx_free(C);
+        return 0.0;
+    }
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            *mtx_ptr(A, i, j) = rand() / (double)RAND_MAX - 0.5;
+            *mtx_ptr(B, i, j) = rand() / (double)RAND_MAX - 0.5;
+        }
+    }
+
+    mtx_mul2(C, A, B);
+    const uint64_t t0 = mtx_metrics_now();
+    mtx_mul2(C, A, B);
+    const double s = (mtx_metrics_now() - t0) / 1e9;
+
+    mtx_free(A);
+    mtx_free(B);
+    mtx_free(C);
+    return 2.0 * n * n * n / s / 1e9;
+}
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : NULL;
+    const size_t n = argc > 2 ? strtoul(argv[2], NULL, 10) : 1024;
+
+    mtx_tune_params defaults;
+    mtx_tune_defaults(&defaults);
+    mtx_tune_set(&defaults);
+    show("defaults", &defaults);
+    const double before = gflops(n);
+
+    if (mtx_tune_run(NULL) != 0) {
+        fprintf(stderr, "tuning failed\n");
+        return 1;
+    }
+    show("tuned", mtx_tune_get());
+    const double after = gflops(n);
+
+    printf("mul %zu: %.2f -> %.2f GF/s\n", n, before, after);
+    if (mtx_tune_save(path) != 0) {
+        fprintf(stderr, "could not write profile\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,413 @@
+#pragma once
+
+/**
+ * @file mtx.hpp
+ * @brief Header-only C++ layer over the C API: RAII matrices, buffer views and
+ * expression templates
+ *
+ * mtx::Matrix owns one matrix handle and frees it in its destructor. It moves
+ * but does not copy implicitly: clone() gives a copy-on-write handle in O(1),
+ * copy() a deep copy. Failed calls throw mtx::Error with the C return code
+ * and the thread's last error message, so temporaries are released on every
+ * path.
+ *
+ * Arithmetic on matrices builds expression objects instead of results; the
+ * assignment evaluates them with one library call and no intermediate matrix:
+ *
+ *   C = A * B + D;        // copy D into C, then mtx_gemm(C, 1, A, B, 1)
+ *   C = 2.0 * A * B - C;  // mtx_gemm(C, 2, A, B, -1), nothing copied
+ *   C += A * B;           // mtx_gemm(C, 1, A, B, 1)
+ *   C = A + 0.5 * B;      // one fused element pass
+ *
+ * Expressions refer to their operands, so evaluate them in the statement
+ * that builds them rather than keeping them in an auto variable.
+ */
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <version>
+#ifdef __cpp_lib_span
+#include <span>
+#endif
+#if defined(__cpp_lib_mdspan) && __has_include(<mdspan>)
+#include <mdspan>
+#define MTX_HAVE_MDSPAN 1
+#endif
+
+extern "C" {
+#include "mtx_repmem.h"
+#include "mtx_arithmetic.h"
+#include "mtx_logs.h"
+}
+
+namespace mtx {
+
+/**
+ * @brief Failed library call: code is the C return code (1, -1, -2, -3)
+ */
+class Error : public std::runtime_error {
+public:
+    Error(int code, const std::string &what) : std::runtime_error(what), code_(code) {}
+    int code() const noexcept { return code_; }
+
+private:
+    int code_;
+};
+
+namespace detail {
+
+/**
+ * @brief Throws for a nonzero return code, with the message of the failing call
+ */
+inline void check(int rc, const char *call) {
+    if (rc == 0) return;
+    const mtx_error *e = mtx_last_error();
+    throw Error(rc, std::string(call) + ": " + (e->func ? e->msg : "failed"));
+}
+
+/**
+ * @brief Throws for an error found by the C++ layer itself
+ */
+[[noreturn]] inline void fail(int code, const char *what) {
+    throw Error(code, what);
+}
+
+/**
+ * @brief Throws -2 if a constructor returned NULL
+ */
+inline matrix *check(matrix *m, const char *call) {
+    if (!m) check(-2, call);
+    return m;
+}
+
+} // namespace detail
+
+template <class E> struct Expr;
+
+/**
+ * @brief Owning, move-only matrix handle (row-major)
+ */
+class Matrix {
+public:
+    Matrix() noexcept = default;
+
+    /**
+     * @brief Uninitialized w x h matrix (width first, as mtx_alloc)
+     */
+    Matrix(std::size_t w, std::size_t h) : m_(detail::check(mtx_alloc(w, h), "mtx_alloc")) {}
+
+    /**
+     * @brief Takes ownership of a handle from the C API (NULL gives an empty Matrix)
+     */
+    explicit Matrix(matrix *adopt) noexcept : m_(adopt) {}
+
+    /**
+     * @brief Evaluates an expression into a new matrix
+     */
+    template <class E> Matrix(const Expr<E> &e) : Matrix(e.self().width(), e.self().height()) {
+        e.self().eval(*this);
+    }
+
+    Matrix(const Matrix &) = delete;
+    Matrix &operator=(const Matrix &) = delete;
+
+    Matrix(Matrix &&o) noexcept : m_(std::exchange(o.m_, nullptr)) {}
+
+    Matrix &operator=(Matrix &&o) noexcept {
+        if (this != &o) reset(std::exchange(o.m_, nullptr));
+        return *this;
+    }
+
+    ~Matrix() { reset(); }
+
+    static Matrix zeros(std::size_t w, std::size_t h) {
+        return Matrix(detail::check(mtx_alloc_zero(w, h), "mtx_alloc_zero"));
+    }
+
+    static Matrix identity(std::size_t n) {
+        return Matrix(detail::check(mtx_alloc_id(n, n), "mtx_alloc_id"));
+    }
+
+    /**
+     * @brief View of a caller-owned row-major buffer of w * h doubles (see mtx_wrap)
+     */
+    static Matrix wrap(double *data, std::size_t w, std::size_t h) {
+        return Matrix(detail::check(mtx_wrap(data, w, h), "mtx_wrap"));
+    }
+
+#ifdef __cpp_lib_span
+    static Matrix wrap(std::span<double> data, std::size_t w, std::size_t h) {
+        if (data.size() < w * h) detail::fail(-1, "mtx_wrap: buffer smaller than w * h");
+        return wrap(data.data(), w, h);
+    }
+#endif
+
+    /**
+     * @brief Copy-on-write handle to the same data (mtx_clone), O(1)
+     */
+    Matrix clone() const { return Matrix(detail::check(mtx_clone(m_), "mtx_clone")); }
+
+    /**
+     * @brief Deep copy (mtx_copy)
+     */
+    Matrix copy() const { return Matrix(detail::check(mtx_copy(m_), "mtx_copy")); }
+
+    std::size_t width() const noexcept { return mtx_get_width(m_); }
+    std::size_t height() const noexcept { return mtx_get_height(m_); }
+    bool empty() const noexcept { return !m_; }
+    explicit operator bool() const noexcept { return m_ != nullptr; }
+
+    /**
+     * @brief Element (i, j); unshares a cloned matrix like mtx_ptr
+     */
+    double &operator()(std::size_t i, std::size_t j) {
+        double *p = mtx_ptr(m_, i, j);
+        if (!p) detail::fail(-1, "mtx::Matrix: index out of range");
+        return *p;
+    }
+
+    double operator()(std::size_t i, std::size_t j) const {
+        const double *p = mtx_cptr(m_, i, j);
+        if (!p) detail::fail(-1, "mtx::Matrix: index out of range");
+        return *p;
+    }
+
+    /**
+     * @brief Row-major data, valid until the matrix is freed, resized or cloned and written
+     * @note The mutable overload unshares a cloned matrix first
+     */
+    double *data() { return m_ ? &(*this)(0, 0) : nullptr; }
+    const double *data() const { return m_ ? mtx_cptr(m_, 0, 0) : nullptr; }
+
+#ifdef __cpp_lib_span
+    std::span<double> span() { return {data(), m_ ? width() * height() : 0}; }
+    std::span<const double> span() const { return {data(), m_ ? width() * height() : 0}; }
+#endif
+
+#ifdef MTX_HAVE_MDSPAN
+    std::mdspan<double, std::dextents<std::size_t, 2>> view() { return {data(), height(), width()}; }
+    std::mdspan<const double, std::dextents<std::size_t, 2>> view() const { return {data(), height(), width()}; }
+#endif
+
+    matrix *get() const noexcept { return m_; }
+
+    /**
+     * @brief Gives up ownership; the caller frees the handle with mtx_free
+     */
+    matrix *release() noexcept { return std::exchange(m_, nullptr); }
+
+    void reset(matrix *m = nullptr) noexcept {
+        if (m_) mtx_free(m_);
+        m_ = m;
+    }
+
+    /**
+     * @brief Evaluates an expression into this matrix, reallocating if the shape differs
+     */
+    template <class E> Matrix &operator=(const Expr<E> &e) {
+        const E &x = e.self();
+        if (!m_ || width() != x.width() || height() != x.height()) {
+            // The expression may still read this matrix: build the result aside
+            Matrix tmp(e);
+            return *this = std::move(tmp);
+        }
+        x.eval(*this);
+        return *this;
+    }
+
+    template <class E> Matrix &operator+=(const Expr<E> &e) {
+        e.self().accumulate(*this);
+        return *this;
+    }
+
+    template <class E> Matrix &operator-=(const Expr<E> &e) {
+        (-e.self()).accumulate(*this);
+        return *this;
+    }
+
+    Matrix &operator*=(double s) {
+        mtx_smul(m_, s);
+        return *this;
+    }
+
+private:
+    matrix *m_ = nullptr;
+};
+
+/* ================== Expressions ================== */
+
+/**
+ * @brief Base of all expression nodes (CRTP)
+ */
+template <class E> struct Expr {
+    const E &self() const noexcept { return static_cast<const E &>(*this); }
+};
+
+/**
+ * @brief s * M
+ */
+struct Term : Expr<Term> {
+    const Matrix *m;
+    double s;
+
+    Term(const Matrix &mat, double scale = 1.0) noexcept : m(&mat), s(scale) {}
+
+    std::size_t width() const noexcept { return m->width(); }
+    std::size_t height() const noexcept { return m->height(); }
+
+    void eval(Matrix &dst) const {
+        detail::check(mtx_smul2(dst.get(), m->get(), s), "mtx_smul2");
+    }
+
+    void accumulate(Matrix &dst) const;
+    Term operator-() const noexcept { return Term(*m, -s); }
+};
+
+/**
+ * @brief x.s * X + y.s * Y, evaluated in one element pass
+ */
+struct Lin : Expr<Lin> {
+    Term x, y;
+
+    Lin(Term a, Term b) noexcept : x(a), y(b) {}
+
+    std::size_t width() const noexcept { return x.width(); }
+    std::size_t height() const noexcept { return x.height(); }
+
+    void eval(Matrix &dst) const { pass(dst, false); }
+
+    /**
+     * @brief dst += x.s * X + y.s * Y in the same single pass, so X or Y may be dst
+     */
+    void accumulate(Matrix &dst) const { pass(dst, true); }
+
+    Lin operator-() const noexcept { return Lin(-x, -y); }
+
+private:
+    void pass(Matrix &dst, bool add) const {
+        if (x.width() != y.width() || x.height() != y.height() ||
+            dst.width() != x.width() || dst.height() != x.height()) {
+            detail::fail(-1, "mtx::Matrix: size mismatch in element-wise expression");
+        }
+        // Element-wise, so dst may alias either operand; read before unsharing dst
+        const double *a = x.m->data(), *b = y.m->data();
+        const bool ax = x.m == &dst, by = y.m == &dst;
+        double *d = dst.data();
+        if (ax) a = d;
+        if (by) b = d;
+        const std::size_t len = dst.width() * dst.height();
+        if (add) {
+            for (std::size_t i = 0; i < len; i++) d[i] += x.s * a[i] + y.s * b[i];
+        } else {
+            for (std::size_t i = 0; i < len; i++) d[i] = x.s * a[i] + y.s * b[i];
+        }
+    }
+};
+
+/**
+ * @brief s * A * B
+ */
+struct Prod : Expr<Prod> {
+    const Matrix *a, *b;
+    double s;
+
+    Prod(const Matrix &ma, const Matrix &mb, double scale = 1.0) noexcept : a(&ma), b(&mb), s(scale) {}
+
+    std::size_t width() const noexcept { return b->width(); }
+    std::size_t height() const noexcept { return a->height(); }
+
+    void eval(Matrix &dst) const {
+        detail::check(mtx_gemm(dst.get(), s, a->get(), b->get(), 0.0), "mtx_gemm");
+    }
+
+    void accumulate(Matrix &dst) const {
+        detail::check(mtx_gemm(dst.get(), s, a->get(), b->get(), 1.0), "mtx_gemm");
+    }
+
+    Prod operator-() const noexcept { return Prod(*a, *b, -s); }
+};
+
+/**
+ * @brief p.s * A * B + t.s * T, one mtx_gemm call
+ */
+struct Gemm : Expr<Gemm> {
+    Prod p;
+    Term t;
+
+    Gemm(Prod prod, Term term) noexcept : p(prod), t(term) {}
+
+    std::size_t width() const noexcept { return p.width(); }
+    std::size_t height() const noexcept { return p.height(); }
+
+    void eval(Matrix &dst) const {
+        if (t.m == &dst) {
+            detail::check(mtx_gemm(dst.get(), p.s, p.a->get(), p.b->get(), t.s), "mtx_gemm");
+        } else if (p.a == &dst || p.b == &dst) {
+            // Copying T into dst would overwrite a factor before it is read
+            Matrix tmp(*this);
+            dst = std::move(tmp);
+        } else {
+            detail::check(mtx_assign(dst.get(), t.m->get()), "mtx_assign");
+            detail::check(mtx_gemm(dst.get(), p.s, p.a->get(), p.b->get(), t.s), "mtx_gemm");
+        }
+    }
+
+    void accumulate(Matrix &dst) const {
+        if (t.m == &dst) {
+            // dst + p + t.s * dst: fold the term into the scale of the old dst
+            detail::check(mtx_gemm(dst.get(), p.s, p.a->get(), p.b->get(), 1.0 + t.s), "mtx_gemm");
+        } else if (p.a == &dst || p.b == &dst) {
+            // The product must read dst before the term is added to it
+            Matrix tmp(*this);
+            Term(tmp).accumulate(dst);
+        } else {
+            p.accumulate(dst);
+            t.accumulate(dst);
+        }
+    }
+
+    Gemm operator-() const noexcept { return Gemm(-p, -t); }
+};
+
+inline void Term::accumulate(Matrix &dst) const {
+    Lin(Term(dst), *this).eval(dst);
+}
+
+/* ================== Operators ================== */
+
+inline Term operator*(double s, const Matrix &m) noexcept { return Term(m, s); }
+inline Term operator*(const Matrix &m, double s) noexcept { return Term(m, s); }
+inline Term operator/(const Matrix &m, double s) noexcept { return Term(m, 1.0 / s); }
+inline Term operator-(const Matrix &m) noexcept { return Term(m, -1.0); }
+inline Term operator*(double s, Term t) noexcept { return Term(*t.m, s * t.s); }
+inline Term operator*(Term t, double s) noexcept { return Term(*t.m, s * t.s); }
+
+inline Prod operator*(Term a, Term b) noexcept { return Prod(*a.m, *b.m, a.s * b.s); }
+inline Prod operator*(const Matrix &a, const Matrix &b) noexcept { return Prod(a, b); }
+inline Prod operator*(double s, Prod p) noexcept { return Prod(*p.a, *p.b, s * p.s); }
+inline Prod operator*(Prod p, double s) noexcept { return Prod(*p.a, *p.b, s * p.s); }
+
+inline Prod operator*(Term a, const Matrix &b) noexcept { return Prod(*a.m, b, a.s); }
+inline Prod operator*(const Matrix &a, Term b) noexcept { return Prod(a, *b.m, b.s); }
+
+inline Lin operator+(Term a, Term b) noexcept { return Lin(a, b); }
+inline Lin operator+(Term a, const Matrix &b) noexcept { return Lin(a, b); }
+inline Lin operator+(const Matrix &a, Term b) noexcept { return Lin(a, b); }
+inline Lin operator-(Term a, const Matrix &b) noexcept { return Lin(a, -Term(b)); }
+inline Lin operator-(const Matrix &a, Term b) noexcept { return Lin(a, -b); }
+inline Lin operator-(Term a, Term b) noexcept { return Lin(a, -b); }
+inline Lin operator+(const Matrix &a, const Matrix &b) noexcept { return Lin(a, b); }
+inline Lin operator-(const Matrix &a, const Matrix &b) noexcept { return Lin(a, -Term(b)); }
+
+inline Gemm operator+(Prod p, Term t) noexcept { return Gemm(p, t); }
+inline Gemm operator+(Term t, Prod p) noexcept { return Gemm(p, t); }
+inline Gemm operator-(Prod p, Term t) noexcept { return Gemm(p, -t); }
+inline Gemm operator-(Term t, Prod p) noexcept { return Gemm(-p, t); }
+inline Gemm operator+(Prod p, const Matrix &m) noexcept { return Gemm(p, m); }
+inline Gemm operator+(const Matrix &m, Prod p) noexcept { return Gemm(p, m); }
+inline Gemm operator-(Prod p, const Matrix &m) noexcept { return Gemm(p, -Term(m)); }
+inline Gemm operator-(const Matrix &m, Prod p) noexcept { return Gemm(-p, m); }
+
+} // namespace mtx
@@ -9,7 +9,7 @@
 /**
  * @brief Transposes a square matrix in-place
  * @param mtx Matrix to transpose (must be square)
- * @return 0 on success, 1 if NULL pointer, -1 if non-square matrix
+ * @return 0 on success, 1 if NULL pointer, -1 if non-square matrix, -2 if allocation failed
  */
 int mtx_transpose(matrix *mtx);
 
@@ -20,7 +20,7 @@ int mtx_transpose(matrix *mtx);
  * @param mtx Matrix to modify
  * @param row1 First row index (0-based)
  * @param row2 Second row index (0-based)
- * @return 0 on success, 1 if NULL pointer, -1 if invalid row indices
+ * @return 0 on success, 1 if NULL pointer, -1 if invalid row indices, -2 if allocation failed
  */
 int mtx_swap_rows(matrix *mtx, size_t row1, size_t row2);
 
@@ -29,7 +29,7 @@ int mtx_swap_rows(matrix *mtx, size_t row1, size_t row2);
  * @param mtx Matrix to modify
  * @param col1 First column index (0-based)
  * @param col2 Second column index (0-based)
- * @return 0 on success, 1 if NULL pointer, -1 if invalid column indices
+ * @return 0 on success, 1 if NULL pointer, -1 if invalid column indices, -2 if allocation failed
  */
 int mtx_swap_cols(matrix *mtx, size_t col1, size_t col2);
 
@@ -38,7 +38,7 @@ int mtx_swap_cols(matrix *mtx, size_t col1, size_t col2);
  * @param mtx Matrix to modify
  * @param row Row index to multiply (0-based)
  * @param factor Multiplication factor
- * @return 0 on success, 1 if NULL pointer, -1 if invalid row index
+ * @return 0 on success, 1 if NULL pointer, -1 if invalid row index, -2 if allocation failed
  */
 int mtx_row_mult(matrix *mtx, size_t row, double factor);
 
@@ -47,7 +47,7 @@ int mtx_row_mult(matrix *mtx, size_t row, double factor);
  * @param mtx Matrix to modify
  * @param row Row index to divide (0-based)
  * @param divisor Divisor (operation skipped if |divisor| < 1e-20)
- * @return 0 on success, 1 if NULL pointer, -1 if invalid row index or division by zero
+ * @return 0 on success, 1 if NULL pointer, -1 if invalid row index or division by zero, -2 if allocation failed
  */
 int mtx_row_div(matrix *mtx, size_t row, double divisor);
 
@@ -57,7 +57,7 @@ int mtx_row_div(matrix *mtx, size_t row, double divisor);
  * @param target_row Row to be modified (0-based)
  * @param source_row Row to multiply and add (0-based)
  * @param factor Multiplication factor for source row
- * @return 0 on success, 1 if NULL pointer, -1 if invalid row indices
+ * @return 0 on success, 1 if NULL pointer, -1 if invalid row indices, -2 if allocation failed
  */
 int mtx_row_add(matrix *mtx, size_t target_row, size_t source_row, double factor);
 
@@ -69,3 +69,77 @@ int mtx_row_add(matrix *mtx, size_t target_row, size_t source_row, double factor
  * @return Matrix norm, -1.0 if NULL pointer or invalid matrix
  */
 double mtx_norm(const matrix *mtx);
+
+/**
+ * @brief Computes the 1-norm (maximum column sum) of a matrix
+ * @param mtx Input matrix
+ * @return Matrix norm, -1.0 if NULL pointer or allocation failed
+ */
+double mtx_norm1(const matrix *mtx);
+
+/**
+ * @brief Computes the Frobenius norm sqrt(sum a_ij^2) of a matrix
+ * @param mtx Input matrix
+ * @return Matrix norm, -1.0 if NULL pointer or allocation failed
+ * @note Rescales by the largest element when the plain sum of squares
+ * overflows or underflows
+ */
+double mtx_norm_fro(const matrix *mtx);
+
+/**
+ * @brief Computes the largest absolute element max |a_ij|
+ * @param mtx Input matrix
+ * @return Largest absolute value, -1.0 if NULL pointer
+ */
+double mtx_norm_max(const matrix *mtx);
+
+/* ================== Reductions ================== */
+
+/**
+ * @brief Elements summed by one task of a parallel reduction
+ */
+#define MTX_REDUCE_CHUNK 8192
+
+/**
+ * @brief Switches bitwise-reproducible reductions on or off (default off)
+ * @param on Nonzero to enable
+ * @note All sums are pairwise within chunks of MTX_REDUCE_CHUNK elements.
+ * With reproducibility off, chunk sums are combined in whatever order the
+ * threads finish, so the last bits may vary with the thread count. With it
+ * on, chunk sums are stored and combined with compensated summation in chunk
+ * order, which costs one double per chunk and makes the result independent
+ * of the number of threads. Row sums (mtx_norm), column sums and maxima are
+ * always reproducible. Changes the calling thread's current context (see mtx_context.h).
+ */
+void mtx_set_reproducible(int on);
+
+/**
+ * @brief Give reproducible reduction mode of the current context
+ * @return 1 if enabled, 0 otherwise
+ */
+int mtx_get_reproducible(void);
+
+/**
+ * @brief Computes the trace (sum of diagonal elements) of a square matrix
+ * @param mtx Square matrix
+ * @param res Result
+ * @return 0 on success, 1 if NULL pointer, -1 if non-square matrix
+ */
+int mtx_trace(const matrix *mtx, double *res);
+
+/**
+ * @brief Computes the inner product sum a_ij * b_ij of two matrices of the same size
+ * @param A First matrix (vectors as 1 x n or n x 1)
+ * @param B Second matrix
+ * @param res Result
+ * @return 0 on success, 1 if NULL pointer, -1 if size mismatch, -2 if allocation failed
+ */
+int mtx_dot(const matrix *A, const matrix *B, double *res);
+
+/**
+ * @brief Computes the sums of all columns
+ * @param mtx Input matrix
+ * @param out Result array of mtx->w elements
+ * @return 0 on success, 1 if NULL pointer, -2 if allocation failed
+ */
+int mtx_col_sums(const matrix *mtx, double *out);
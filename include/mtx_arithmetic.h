@@ -12,17 +12,29 @@
 #define MTX_MIN_DIVISOR 1e-20
 
 /**
- * @brief Block size for matrix block multiplication
+ * @brief Block size for matrix block multiplication when the cache sizes are unknown
+ * @note The tiles actually used come from mtx_tune_get()
 */
 #define MTX_BLOCK_SIZE 32
 
+/**
+ * @brief Widest right operand the skinny kernels are compiled for
+ * @note The crossover actually used is mtx_tune_get()->skinny_width
+*/
+#define MTX_SKINNY_WIDTH 8
+
+/**
+ * @brief Default number of multiply-adds below which the matrix-vector and skinny kernels stay serial
+*/
+#define MTX_SKINNY_PAR_MIN 65536
+
 /* ================== In-place Operations ================== */
 
 /**
  * @brief Performs matrix addition (mtx1 += mtx2)
  * @param mtx1 Target matrix to modify
  * @param mtx2 Source matrix to add
- * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch, -2 if allocation failed
  */
 int mtx_add(matrix *mtx1, const matrix *mtx2);
 
@@ -30,7 +42,7 @@ int mtx_add(matrix *mtx1, const matrix *mtx2);
  * @brief Performs matrix subtraction (mtx1 -= mtx2)
  * @param mtx1 Target matrix to modify
  * @param mtx2 Source matrix to subtract
- * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch, -2 if allocation failed
  */
 int mtx_sub(matrix *mtx1, const matrix *mtx2);
 
@@ -73,7 +85,7 @@ int mtx_sub2(matrix *mtx, const matrix *mtx1, const matrix *mtx2);
  * @param mtx Destination matrix
  * @param mtx1 Source matrix
  * @param d Scaling factor
- * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch, -2 if allocation failed
  */
 int mtx_smul2(matrix *mtx, const matrix *mtx1, double d);
 
@@ -82,7 +94,7 @@ int mtx_smul2(matrix *mtx, const matrix *mtx1, double d);
  * @param mtx Destination matrix
  * @param mtx1 Source matrix
  * @param d Divisor (operation skipped if |d| < 1e-20)
- * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch, -2 if allocation failed
  */
 int mtx_sdiv2(matrix *mtx, const matrix *mtx1, double d);
 
@@ -90,8 +102,13 @@ int mtx_sdiv2(matrix *mtx, const matrix *mtx1, double d);
  * @brief Performs in-place matrix multiplication (m1 = m1 * m2)
  * @param m1 First input matrix (modified in-place) and result storage
  * @param m2 Second input matrix
- * @return 0 on success, 1 if any pointer is NULL, -1 if matrix dimensions are incompatible for multiplication
- * @note Matrices must satisfy m1->w == m2->h for multiplication
+ * @return 0 on success, 1 if any pointer is NULL, -1 if matrix dimensions are incompatible for multiplication,
+ *         -2 if allocation failed (m1 unchanged)
+ * @note Matrices must satisfy m1->w == m2->h for multiplication; m1 becomes m1->h x m2->w.
+ * Rows are computed in panels through a per-thread scratch buffer of
+ * one row tile per thread, so no full-size temporary is made except
+ * when m1 == m2. Right operands up to the tuned skinny width go to kernels
+ * that read m1 exactly once.
  */
 int mtx_mul(matrix *m1, const matrix *m2);
 
@@ -101,6 +118,60 @@ int mtx_mul(matrix *m1, const matrix *m2);
  * @param m1 First input matrix
  * @param m2 Second input matrix
  * @return 0 on success, 1 if any pointer is NULL, -1 if matrix dimensions are incompatible,
- * @note Output matrix m must have dimensions m->h == m1->h and m->w == m2->w
+ *         -2 if allocation failed
+ * @note Output matrix m must have dimensions m->h == m1->h and m->w == m2->w.
+ * m may alias m1 and/or m2; the result is always written into m's storage,
+ * and the aliased operand is staged in a per-thread scratch buffer that is
+ * reused across calls. Shapes are dispatched as in mtx_mul.
+ */
+int mtx_mul2(matrix *m, const matrix *m1, const matrix *m2);
+
+/**
+ * @brief Computes C = alpha * A * B + beta * C in one pass
+ * @param C Input/output matrix (A->h x B->w)
+ * @param alpha Scale of the product
+ * @param A First factor
+ * @param B Second factor
+ * @param beta Scale of the old C; 0 ignores its contents (NaN included)
+ * @return 0 on success, 1 if any pointer is NULL, -1 if sizes mismatch,
+ *         -2 if allocation failed
+ * @note Each thread scales its block of C and accumulates the product into
+ * it, so no temporary is allocated. C may alias A or B; the aliased operand is
+ * staged in the per-thread scratch buffer, as in mtx_mul2.
+ */
+int mtx_gemm(matrix *C, double alpha, const matrix *A, const matrix *B, double beta);
+
+/**
+ * @brief Computes the matrix-vector product y = mtx * x
+ * @param y Output array of mtx->h elements, must not overlap x
+ * @param mtx Input matrix
+ * @param x Input array of mtx->w elements
+ * @return 0 on success, 1 if any pointer is NULL
+ * @note Streams mtx once, each row reduced with SIMD, rows split across threads
+ */
+int mtx_gemv(double *y, const matrix *mtx, const double *x);
+
+/* ================== Powers and Polynomials ================== */
+
+/**
+ * @brief Computes integer matrix power (res = mtx^k)
+ * @param mtx Square input matrix
+ * @param k Exponent (k = 0 gives identity)
+ * @return Pointer to newly allocated matrix containing result,
+ *         NULL on error or if input is invalid
+ * @note Binary exponentiation: at most 2*log2(k) products, computed
+ * into ping-pong buffers allocated once up front.
+ */
+matrix *mtx_pow(const matrix *mtx, unsigned int k);
+
+/**
+ * @brief Evaluates matrix polynomial (res = c[0]*I + c[1]*mtx + ... + c[deg]*mtx^deg)
+ * @param mtx Square input matrix
+ * @param coef Array of deg + 1 coefficients, lowest degree first
+ * @param deg Polynomial degree
+ * @return Pointer to newly allocated matrix containing result,
+ *         NULL on error or if input is invalid
+ * @note Paterson-Stockmeyer scheme: about 2*sqrt(deg) matrix products
+ * instead of deg. All workspace is allocated before the first product.
  */
-int mtx_mul2(matrix *m, const matrix *m1, const matrix *m2);
\ No newline at end of file
+matrix *mtx_polyval(const matrix *mtx, const double *coef, size_t deg);
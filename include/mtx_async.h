@@ -0,0 +1,132 @@
+#pragma once
+
+#include "mtx_repmem.h"
+#include "mtx_arithmetic.h"
+#include "mtx_calcs.h"
+#include "mtx_logs.h"
+
+/**
+ * @brief Handle of a submitted operation (future)
+ *
+ * A task runs on the library worker pool once every task it depends on has
+ * finished. If a dependency fails (non-zero status), the task is not run and
+ * finishes with MTX_ASYNC_CANCELED, which propagates to its own dependents.
+ * Handles are reference counted: call mtx_task_release once the result is no
+ * longer needed; the task itself keeps running if it has not finished yet.
+ */
+struct mtx_task;
+typedef struct mtx_task mtx_task;
+
+/**
+ * @brief Task body; the returned status is reported by mtx_task_wait
+ */
+typedef int (*mtx_task_fn)(void *arg);
+
+/**
+ * @brief Status of a task skipped because one of its dependencies failed
+ */
+#define MTX_ASYNC_CANCELED (-100)
+
+/* ================== Worker Pool ================== */
+
+/**
+ * @brief Starts the worker pool
+ * @param nthreads Number of workers, 0 for the number of online CPUs
+ * @return 0 on success, -1 if the pool is already running, -2 if thread creation failed
+ * @note Submitting without calling this starts a default-sized pool. Kernels
+ * still parallelize with OpenMP inside each task, so with many concurrent tasks
+ * lower OMP_NUM_THREADS to avoid oversubscription.
+ */
+int mtx_async_init(size_t nthreads);
+
+/**
+ * @brief Runs all submitted tasks to completion and stops the workers
+ * @note Handles that were not released stay valid for mtx_task_wait and mtx_task_release.
+ * Submissions from other threads (or task bodies) fail while the shutdown is in
+ * progress; the next submission after it returns starts a new pool.
+ */
+void mtx_async_shutdown(void);
+
+/* ================== Tasks ================== */
+
+/**
+ * @brief Submits a task
+ * @param fn Task body
+ * @param arg Argument passed to fn; must stay valid until the task finishes
+ * @param deps Tasks that must finish first (NULL entries are ignored)
+ * @param ndeps Number of dependencies
+ * @return Task handle, NULL on failure or while mtx_async_shutdown is running
+ * @note Never wait for another task from inside a task body: the waiting
+ * worker is lost to the pool and the pool can deadlock. The body runs with
+ * the calling thread's current context, which must outlive the task.
+ */
+mtx_task *mtx_async_submit(mtx_task_fn fn, void *arg, mtx_task *const *deps, size_t ndeps);
+
+/**
+ * @brief Blocks until a task finishes
+ * @param t Task handle
+ * @return Status returned by the task body, MTX_ASYNC_CANCELED if skipped, 1 if NULL pointer
+ * @note For a non-zero status the error the body recorded on its worker (or a
+ * cancellation notice) becomes the calling thread's mtx_last_error
+ */
+int mtx_task_wait(mtx_task *t);
+
+/**
+ * @brief Checks whether a task has finished without blocking
+ * @param t Task handle
+ * @return 1 if finished, 0 if pending or running or NULL pointer
+ */
+int mtx_task_done(mtx_task *t);
+
+/**
+ * @brief Releases a task handle
+ * @param t Task handle (safe with NULL)
+ */
+void mtx_task_release(mtx_task *t);
+
+/* ================== Asynchronous Operations ================== */
+
+/**
+ * @brief Asynchronous mtx_mul2 (res = mtx1 * mtx2)
+ * @return Task handle; status is the mtx_mul2 return code
+ * @note Operands must stay valid and unmodified until the task finishes
+ */
+mtx_task *mtx_async_mul2(matrix *res, const matrix *mtx1, const matrix *mtx2,
+                         mtx_task *const *deps, size_t ndeps);
+
+/**
+ * @brief Asynchronous mtx_add2 (res = mtx1 + mtx2)
+ * @return Task handle; status is the mtx_add2 return code
+ */
+mtx_task *mtx_async_add2(matrix *res, const matrix *mtx1, const matrix *mtx2,
+                         mtx_task *const *deps, size_t ndeps);
+
+/**
+ * @brief Asynchronous mtx_sub2 (res = mtx1 - mtx2)
+ * @return Task handle; status is the mtx_sub2 return code
+ */
+mtx_task *mtx_async_sub2(matrix *res, const matrix *mtx1, const matrix *mtx2,
+                         mtx_task *const *deps, size_t ndeps);
+
+/**
+ * @brief Asynchronous mtx_exp
+ * @param res Receives the newly allocated exponential when the task finishes
+ * @return Task handle; status is 0 on success, -1 if mtx_exp failed
+ */
+mtx_task *mtx_async_exp(matrix **res, const matrix *mtx, double eps,
+                        mtx_task *const *deps, size_t ndeps);
+
+/**
+ * @brief Asynchronous mtx_solve_gauss
+ * @param res Receives the newly allocated solution when the task finishes
+ * @return Task handle; status is 0 on success, -1 if the solve failed
+ */
+mtx_task *mtx_async_solve_gauss(matrix **res, const matrix *A, const matrix *B,
+                                mtx_task *const *deps, size_t ndeps);
+
+/**
+ * @brief Asynchronous mtx_norm
+ * @param res Receives the norm when the task finishes
+ * @return Task handle; status is 0 on success, -1 if mtx_norm failed
+ */
+mtx_task *mtx_async_norm(double *res, const matrix *mtx, mtx_task *const *deps, size_t ndeps);
@@ -15,6 +15,9 @@
  * 
  * The function continues adding terms until the norm of the next term
  * is smaller than eps (||A^k/k!|| < eps)
+ *
+ * Symmetric input is detected and routed through mtx_fun, which costs
+ * one eigendecomposition and one multiplication; eps is not used then.
  */
 matrix *mtx_exp(const matrix *mtx, double eps);
 
@@ -36,4 +39,61 @@ matrix* mtx_solve_gauss(const matrix* A, const matrix* B);
  * @param B Right-hand side
  * @return Residual norm, -1.0 on error
  */
-double mtx_verify_solution(const matrix* A, const matrix* X, const matrix* B);
\ No newline at end of file
+double mtx_verify_solution(const matrix* A, const matrix* X, const matrix* B);
+
+/**
+ * @brief Computes the action of the matrix exponential e^(tA)*V without forming e^(tA)
+ * @param mtx Square input matrix A (n x n)
+ * @param vec Block of vectors V (n x k)
+ * @param t Time (scale) factor
+ * @param eps Relative tolerance for truncating each Taylor segment
+ * @return Pointer to newly allocated matrix e^(tA)*V (n x k),
+ *         NULL on error or if input is invalid
+ * @note Uses truncated Taylor series with scaling (Al-Mohy & Higham):
+ * e^(tA)V = (T_m(tA/s))^s V, with m and s chosen from the 1-norm of A.
+ * Only matrix-panel products are performed, so one evaluation costs
+ * O(n^2 * k * m * s) instead of the O(n^3) products of mtx_exp.
+ */
+matrix *mtx_exp_mul(const matrix *mtx, const matrix *vec, double t, double eps);
+
+/**
+ * @brief Computes e^(t_i A)*V for a sequence of time points in one call
+ * @param res Output array of count pointers, filled with newly allocated matrices (n x k)
+ * @param mtx Square input matrix A (n x n)
+ * @param vec Block of vectors V (n x k)
+ * @param t Array of time points
+ * @param count Number of time points
+ * @param eps Relative tolerance for truncating each Taylor segment
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch or invalid eps,
+ *         -2 if allocation failed (res is left filled with NULL)
+ * @note Each point is reached from the previous one by stepping with
+ * e^((t_i - t_(i-1))A), so sorted time points keep every step short.
+ */
+int mtx_exp_mul_seq(matrix **res, const matrix *mtx, const matrix *vec,
+                    const double *t, size_t count, double eps);
+
+/* ================== Matrix Functions ================== */
+
+/**
+ * @brief Computes a matrix function f(A) of a symmetric matrix
+ * @param mtx Symmetric input matrix
+ * @param f Scalar function applied to the eigenvalues
+ * @return Pointer to newly allocated matrix V*f(L)*V^T,
+ *         NULL on error, if mtx is not symmetric or if f is not finite at an eigenvalue
+ * @note Uses the eigendecomposition A = V*L*V^T from mtx_eig_sym
+ */
+matrix *mtx_fun(const matrix *mtx, double (*f)(double));
+
+/**
+ * @brief Computes the principal square root of a symmetric positive semidefinite matrix
+ * @param mtx Symmetric input matrix
+ * @return Pointer to newly allocated matrix, NULL on error or negative eigenvalue
+ */
+matrix *mtx_sqrt(const matrix *mtx);
+
+/**
+ * @brief Computes the principal logarithm of a symmetric positive definite matrix
+ * @param mtx Symmetric input matrix
+ * @return Pointer to newly allocated matrix, NULL on error or non-positive eigenvalue
+ */
+matrix *mtx_log(const matrix *mtx);
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "mtx_repmem.h"
+#include "mtx_tune.h"
+#include "mtx_logs.h"
+
+/**
+ * @brief Library configuration: allocation policy, reduction mode, kernel
+ * parameters and logging
+ *
+ * Thread-safety contract:
+ * - Any library function may run concurrently with any other, on any number
+ *   of threads, as long as no object written by one call (matrix, smatrix,
+ *   mtx_tiled, mtx_ooc handle, plan, factorization) is read or written by
+ *   another call at the same time. Read-only sharing is always allowed, and
+ *   handles from mtx_clone may be written independently.
+ * - All configuration lives in contexts; there is no other mutable global
+ *   state. Each thread uses the context it bound with mtx_context_bind, or
+ *   the process default context. mtx_mem_set_policy, mtx_set_reproducible and
+ *   mtx_tune_set change the calling thread's current context.
+ * - Changing a context is not synchronized with calls that use it: give each
+ *   service thread its own context, or configure a shared one before the
+ *   threads start.
+ * - Tasks of mtx_async run with the context that was current when they were
+ *   submitted. OpenMP threads inside a call only run kernels, which read the
+ *   configuration before the parallel region.
+ * - Failures are recorded per thread (mtx_last_error); log lines are written
+ *   whole, never interleaved; metrics are counted per thread. A task that
+ *   fails records its error on the worker, and mtx_task_wait copies it into
+ *   the waiting thread's state.
+ */
+struct mtx_context;
+typedef struct mtx_context mtx_context;
+
+/* ================== Contexts ================== */
+
+/**
+ * @brief Creates a context with the settings of the calling thread's current context
+ * @return Context, NULL if allocation failed
+ */
+mtx_context *mtx_context_create(void);
+
+/**
+ * @brief Releases a context
+ * @param ctx Context (safe with NULL and with the default context, which is never released)
+ * @note Unbinds it from the calling thread; it must not be bound on any other
+ * thread or used by pending tasks
+ */
+void mtx_context_free(mtx_context *ctx);
+
+/**
+ * @brief Give the process default context
+ * @return Default context, never NULL
+ */
+mtx_context *mtx_context_default(void);
+
+/**
+ * @brief Give the context used by calls on this thread
+ * @return Bound context, or the default one, never NULL
+ */
+mtx_context *mtx_context_current(void);
+
+/**
+ * @brief Makes ctx the context of all calls on this thread
+ * @param ctx Context, NULL for the default one
+ * @return Previously current context, to restore it later
+ */
+mtx_context *mtx_context_bind(mtx_context *ctx);
+
+/* ================== Settings ================== */
+
+/**
+ * @brief Sets the allocation policy of a context
+ * @param ctx Context
+ * @param policy New policy, NULL restores the default (malloc for every size)
+ * @return 0 on success, 1 if ctx is NULL
+ */
+int mtx_context_set_policy(mtx_context *ctx, const mtx_mem_policy *policy);
+
+/**
+ * @brief Reads the allocation policy of a context
+ * @return 0 on success, 1 if any pointer is NULL
+ */
+int mtx_context_get_policy(const mtx_context *ctx, mtx_mem_policy *policy);
+
+/**
+ * @brief Selects reproducible reductions for a context (see mtx_set_reproducible)
+ * @return 0 on success, 1 if ctx is NULL
+ */
+int mtx_context_set_reproducible(mtx_context *ctx, int on);
+
+/**
+ * @brief Give the reduction mode of a context
+ * @return 1 if reproducible, 0 if not or ctx is NULL
+ */
+int mtx_context_get_reproducible(const mtx_context *ctx);
+
+/**
+ * @brief Sets the kernel parameters of a context
+ * @param ctx Context
+ * @param params New parameters, NULL for cache-derived defaults
+ * @return 0 on success, 1 if ctx is NULL, -1 if a value is out of range
+ */
+int mtx_context_set_tune(mtx_context *ctx, const mtx_tune_params *params);
+
+/**
+ * @brief Give the kernel parameters of a context
+ * @return Parameters, NULL if ctx is NULL
+ */
+const mtx_tune_params *mtx_context_get_tune(const mtx_context *ctx);
+
+/**
+ * @brief Turns log output for calls on a context on or off
+ * @return 0 on success, 1 if ctx is NULL
+ * @note Errors are still recorded in mtx_last_error when logging is off
+ */
+int mtx_context_set_logging(mtx_context *ctx, int on);
+
+/**
+ * @brief Give the logging switch of a context
+ * @return 1 if logging, 0 if not or ctx is NULL
+ */
+int mtx_context_get_logging(const mtx_context *ctx);
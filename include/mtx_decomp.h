@@ -0,0 +1,78 @@
+#pragma once
+
+#include "mtx_repmem.h"
+#include "mtx_arithmetic.h"
+#include "mtx_actions.h"
+#include "mtx_logs.h"
+
+/**
+ * @brief Relative tolerance used to recognise symmetric input
+ */
+#define MTX_SYM_TOL 1e-14
+
+/**
+ * @brief Subproblem size below which the divide-and-conquer eigensolver
+ * switches to implicit QL iteration
+ */
+#define MTX_DC_MIN_SIZE 32
+
+/* ================== Structure Checks ================== */
+
+/**
+ * @brief Checks whether a matrix is symmetric
+ * @param mtx Matrix to check
+ * @return 1 if square and |a_ij - a_ji| <= MTX_SYM_TOL * (|a_ij| + |a_ji|) for all i, j,
+ *         0 otherwise (including NULL pointer)
+ */
+int mtx_is_symmetric(const matrix *mtx);
+
+/* ================== Symmetric Eigenproblem ================== */
+
+/**
+ * @brief Computes eigenvalues and eigenvectors of a symmetric matrix
+ * @param mtx Symmetric matrix (n x n), only the lower triangle is referenced
+ * @param eval Output array of n eigenvalues in ascending order
+ * @param evec Output matrix (n x n) whose columns are the orthonormal eigenvectors,
+ *        may be NULL if only eigenvalues are needed
+ * @return 0 on success, 1 if any required pointer is NULL, -1 if size mismatch,
+ *         -2 if allocation failed, -3 if the iteration did not converge
+ * @note Householder reduction to tridiagonal form followed by Cuppen's
+ * divide-and-conquer on the tridiagonal matrix. The reduction updates and
+ * the eigenvector back-transformations run in parallel when built with OpenMP.
+ */
+int mtx_eig_sym(const matrix *mtx, double *eval, matrix *evec);
+
+/* ================== Orthogonal Factorizations ================== */
+
+/**
+ * @brief Computes the thin QR factorization of a tall matrix (mtx = Q * R)
+ * @param mtx Input matrix (h x w), h >= w
+ * @param Q Output matrix with orthonormal columns (h x w)
+ * @param R Output upper triangular matrix (w x w), may be NULL
+ * @return 0 on success, 1 if any required pointer is NULL, -1 if size mismatch,
+ *         -2 if allocation failed
+ * @note Householder reflections, so Q stays orthonormal to working precision
+ */
+int mtx_qr(const matrix *mtx, matrix *Q, matrix *R);
+
+/* ================== Low-rank Approximation ================== */
+
+/**
+ * @brief Computes the k leading singular triplets with a randomized range finder
+ * @param mtx Input matrix A (h x w)
+ * @param k Number of singular triplets, 0 < k <= min(h, w)
+ * @param oversample Extra sample columns p (5-10 is usually enough)
+ * @param power_iters Number of power iterations q (1-2 for slowly decaying spectra)
+ * @param seed Seed of the Gaussian test matrix, drawn as by mtx_rand_normal, so
+ *        results do not depend on the thread count
+ * @param U Output left singular vectors (h x k), may be NULL
+ * @param s Output singular values (k) in descending order
+ * @param Vt Output right singular vectors as rows (k x w), may be NULL
+ * @return 0 on success, 1 if any required pointer is NULL, -1 if size mismatch,
+ *         -2 if allocation failed, -3 if the small SVD did not converge
+ * @note Halko-Martinsson-Tropp: Y = (A*A^T)^q * A * Omega, Q = orth(Y),
+ * B = Q^T * A, then an SVD of the small B. Costs O(h * w * (k + p)) and reads A
+ * in 2q + 2 sequential row passes, each of which touches every element once.
+ */
+int mtx_svd_rand(const matrix *mtx, size_t k, size_t oversample, size_t power_iters,
+                 unsigned long seed, matrix *U, double *s, matrix *Vt);
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "mtx_repmem.h"
+#include "mtx_arithmetic.h"
+#include "mtx_logs.h"
+
+/**
+ * @brief Largest multiplier |l_ij| an updated LU factor may carry before it is refactored
+ */
+#define MTX_LU_MAX_GROWTH 1e3
+
+/**
+ * @brief Relative cancellation in an updated pivot, |new| < tol * (|old| + |change|),
+ * that triggers refactorization
+ */
+#define MTX_UPDATE_PIVOT_TOL 1e-8
+
+/* ================== LU Factorization ================== */
+
+/**
+ * @brief LU factors with partial pivoting (P*A = L*U) of a square matrix,
+ * reusable for any number of solves and updatable in O(n^2)
+ * @note Keeps a copy of A alongside the factors so that an update that
+ * would lose accuracy can refactor instead.
+ */
+struct mtx_lu;
+typedef struct mtx_lu mtx_lu;
+
+/**
+ * @brief Factors a square matrix
+ * @param A Square matrix (n x n)
+ * @return Factors, NULL if not square, allocation failed or singular
+ * @note O(n^3); the trailing update of each step runs in parallel
+ */
+mtx_lu *mtx_lu_factor(const matrix *A);
+
+/**
+ * @brief Solves A*X = B with the current factors
+ * @param lu Factors
+ * @param B Right-hand side (n x m), overwritten by X
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch, -2 if allocation failed
+ * @note O(n^2 * m)
+ */
+int mtx_lu_solve(const mtx_lu *lu, matrix *B);
+
+/**
+ * @brief Applies a rank-1 change A := A + u*v^T to the factors
+ * @param lu Factors
+ * @param u Column vector of n elements
+ * @param v Row vector of n elements
+ * @return 0 on success, 1 if any pointer is NULL, -2 if allocation failed,
+ *         -3 if the updated matrix is singular (factors and A are then left updated
+ *         but unusable until the next successful update)
+ * @note Bennett's algorithm in O(n^2) without re-pivoting. If a pivot cancels
+ * (MTX_UPDATE_PIVOT_TOL) or a multiplier exceeds MTX_LU_MAX_GROWTH, the
+ * updated A is refactored with partial pivoting in O(n^3) instead.
+ */
+int mtx_lu_update(mtx_lu *lu, const double *u, const double *v);
+
+/**
+ * @brief Replaces row r of A, as a rank-1 update
+ * @param lu Factors
+ * @param r Row index (0-based)
+ * @param row New row of n elements
+ * @return Same codes as mtx_lu_update, -1 if invalid row index
+ */
+int mtx_lu_set_row(mtx_lu *lu, size_t r, const double *row);
+
+/**
+ * @brief Give the number of refactorizations triggered by updates
+ * @return Count, 0 if pointer is NULL
+ */
+size_t mtx_lu_refactors(const mtx_lu *lu);
+
+/**
+ * @brief Releases LU factors
+ * @param lu Factors (safe with NULL)
+ */
+void mtx_lu_free(mtx_lu *lu);
+
+/* ================== Cholesky Factorization ================== */
+
+/**
+ * @brief Cholesky factor (A = R^T * R) of a symmetric positive definite matrix
+ * @note Also keeps a copy of A for refactorization
+ */
+struct mtx_chol;
+typedef struct mtx_chol mtx_chol;
+
+/**
+ * @brief Factors a symmetric positive definite matrix
+ * @param A Symmetric matrix (n x n), only the upper triangle is referenced
+ * @return Factor, NULL if not square, allocation failed or not positive definite
+ */
+mtx_chol *mtx_chol_factor(const matrix *A);
+
+/**
+ * @brief Solves A*X = B with the current factor
+ * @param ch Factor
+ * @param B Right-hand side (n x m), overwritten by X
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch
+ */
+int mtx_chol_solve(const mtx_chol *ch, matrix *B);
+
+/**
+ * @brief Rank-1 update A := A + x*x^T
+ * @param ch Factor
+ * @param x Vector of n elements
+ * @return 0 on success, 1 if any pointer is NULL, -2 if allocation failed (ch unchanged)
+ * @note O(n^2) Givens sweep; always stable
+ */
+int mtx_chol_update(mtx_chol *ch, const double *x);
+
+/**
+ * @brief Rank-1 downdate A := A - x*x^T
+ * @param ch Factor
+ * @param x Vector of n elements
+ * @return 0 on success, 1 if any pointer is NULL, -2 if allocation failed,
+ *         -3 if the result would not be positive definite (ch unchanged)
+ * @note O(n^2) hyperbolic sweep after checking ||R^-T x|| < 1. When the
+ * margin 1 - ||R^-T x||^2 is below MTX_UPDATE_PIVOT_TOL, the downdated A is
+ * refactored in O(n^3) instead.
+ */
+int mtx_chol_downdate(mtx_chol *ch, const double *x);
+
+/**
+ * @brief Give the number of refactorizations triggered by downdates
+ * @return Count, 0 if pointer is NULL
+ */
+size_t mtx_chol_refactors(const mtx_chol *ch);
+
+/**
+ * @brief Releases a Cholesky factor
+ * @param ch Factor (safe with NULL)
+ */
+void mtx_chol_free(mtx_chol *ch);
+
+/* ================== Woodbury Identity ================== */
+
+/**
+ * @brief Solves (A + U*V^T) X = B using the factors of A
+ * @param lu Factors of A (n x n)
+ * @param U Left factor of the correction (n x k)
+ * @param V Right factor of the correction (n x k)
+ * @param B Right-hand side (n x m), overwritten by X
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch,
+ *         -2 if allocation failed, -3 if I + V^T A^-1 U is singular
+ * @note O(n^2 (k + m) + k^3): A^-1 U and A^-1 B come from the factors, and
+ * only the k x k capacitance matrix is factored. lu is not modified, so the
+ * same factors serve any number of different corrections.
+ */
+int mtx_lu_solve_woodbury(const mtx_lu *lu, const matrix *U, const matrix *V, matrix *B);
+
+/**
+ * @brief Updates an explicit inverse: Ainv := (A + U*V^T)^-1
+ * @param Ainv Inverse of A (n x n), overwritten
+ * @param U Left factor of the correction (n x k)
+ * @param V Right factor of the correction (n x k)
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch,
+ *         -2 if allocation failed, -3 if I + V^T Ainv U is singular (Ainv unchanged)
+ * @note O(n^2 k + k^3) by the Sherman-Morrison-Woodbury formula
+ */
+int mtx_inverse_update(matrix *Ainv, const matrix *U, const matrix *V);
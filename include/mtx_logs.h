@@ -5,59 +5,89 @@
 /**
  * @def MTX_DEBUG
  * @brief Debug mode switch (1 = enabled, 0 = disabled)
- * @details When enabled, all logging operations will be active. 
- * When disabled, all logging macros become no-ops for zero runtime overhead.
+ * @details When enabled, all logging operations will be active.
+ * When disabled, MTX_LOG becomes a no-op for zero runtime overhead and
+ * MTX_LOG_ERROR only records the per-thread error state.
  */
 #define MTX_DEBUG 1
 
 /**
  * @def MTX_LOG_FILE
  * @brief Path to the log file
- * @note The directory must exist before logging starts
+ * @note The directory must exist before logging starts; the file is opened
+ * once, by the first message, and kept open
  */
 #define MTX_LOG_FILE "data/mtx_log.txt"
 
+/**
+ * @brief Longest error message kept in the per-thread error state, with the terminator
+ */
+#define MTX_ERROR_LEN 256
+
+/**
+ * @brief Last error reported on a thread
+ */
+typedef struct {
+    const char *func;           // failing library function, NULL if none since the last clear
+    char msg[MTX_ERROR_LEN];    // message as logged
+} mtx_error;
+
+/**
+ * @brief Give the last error reported by a library call on the calling thread
+ * @return Error state of this thread, never NULL
+ * @note Calls that succeed leave it untouched: clear it with mtx_clear_error
+ * before a call to tell whether that call failed
+ */
+const mtx_error *mtx_last_error(void);
+
+/**
+ * @brief Clears the error state of the calling thread
+ */
+void mtx_clear_error(void);
+
+/**
+ * @brief Records an error in the calling thread's error state (used by MTX_LOG_ERROR)
+ */
+void mtx_set_error(const char *func, const char *msg);
+
+/**
+ * @brief Writes one log line (used by MTX_LOG and MTX_LOG_ERROR)
+ * @param error Nonzero for an error, which is also recorded with mtx_set_error
+ * @param func Reporting function
+ * @param msg Message
+ * @note Lines from concurrent threads never interleave. Errors are flushed at
+ * once and echoed to stderr; informational lines are buffered. Nothing is
+ * written for calls on a context with logging turned off.
+ */
+void mtx_log_write(int error, const char *func, const char *msg);
+
 #if MTX_DEBUG
     /**
      * @def MTX_LOG(msg)
      * @brief Logs an informational message
      * @param msg The message string to log
-     * @details Writes to both log file and stdout. 
-     * Creates/append to the file specified in MTX_LOG_FILE.
+     * @details Appends to the file specified in MTX_LOG_FILE.
      */
-    #define MTX_LOG(msg) do { \
-        FILE *f = fopen(MTX_LOG_FILE, "a"); \
-        if (f) { \
-            fprintf(f, "[MTX] %s\n", msg); \
-            fclose(f); \
-        } \
-    } while (0)
+    #define MTX_LOG(msg) mtx_log_write(0, __func__, msg)
 
     /**
      * @def MTX_LOG_ERROR(msg)
      * @brief Logs an error message
      * @param msg The error message to log
-     * @details Writes to both log file and stderr.
-     * Creates/append to the file specified in MTX_LOG_FILE.
+     * @details Records it as the calling thread's last error, then appends it
+     * to the file specified in MTX_LOG_FILE and writes it to stderr.
      */
-    #define MTX_LOG_ERROR(msg) do { \
-        FILE *f = fopen(MTX_LOG_FILE, "a"); \
-        if (f) { \
-            fprintf(f, "[MTX_ERROR] %s\n", msg); \
-            fclose(f); \
-        } \
-        fprintf(stderr, "[MTX_ERROR] %s\n", msg); \
-    } while (0)
+    #define MTX_LOG_ERROR(msg) mtx_log_write(1, __func__, msg)
 #else
     /**
      * @def MTX_LOG(msg)
      * @brief Empty macro when debugging is disabled
      */
-    #define MTX_LOG(msg) 
-    
+    #define MTX_LOG(msg)
+
     /**
      * @def MTX_LOG_ERROR(msg)
-     * @brief Empty macro when debugging is disabled
+     * @brief Only records the calling thread's last error when debugging is disabled
      */
-    #define MTX_LOG_ERROR(msg)
-#endif
\ No newline at end of file
+    #define MTX_LOG_ERROR(msg) mtx_set_error(__func__, msg)
+#endif
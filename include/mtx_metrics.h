@@ -0,0 +1,192 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+
+/**
+ * @def MTX_METRICS
+ * @brief Metrics switch (1 = enabled, 0 = disabled)
+ * @details When enabled, instrumented functions record call counts, bytes moved,
+ * FLOPs and latency into per-thread counters. When disabled, the recording
+ * macros become no-ops for zero runtime overhead.
+ */
+#define MTX_METRICS 1
+
+/**
+ * @brief Number of latency histogram buckets; bucket b counts calls taking [2^b, 2^(b+1)) ns
+ */
+#define MTX_METRICS_BUCKETS 40
+
+/**
+ * @brief Instrumented operations: public functions and internal kernels
+ */
+#define MTX_METRIC_OPS(X) \
+    X(ALLOC, "mtx_alloc") \
+    X(ASSIGN, "mtx_assign") \
+    X(COPY, "mtx_copy") \
+    X(SET_ZERO, "mtx_set_zero") \
+    X(ADD, "mtx_add") \
+    X(SUB, "mtx_sub") \
+    X(SMUL, "mtx_smul") \
+    X(ADD2, "mtx_add2") \
+    X(SUB2, "mtx_sub2") \
+    X(SMUL2, "mtx_smul2") \
+    X(MUL, "mtx_mul") \
+    X(MUL2, "mtx_mul2") \
+    X(GEMM, "mtx_gemm") \
+    X(BLOCK_MUL, "mtx_block_mul") \
+    X(GEMV, "mtx_gemv") \
+    X(POW, "mtx_pow") \
+    X(POLYVAL, "mtx_polyval") \
+    X(TRANSPOSE, "mtx_transpose") \
+    X(SWAP_ROWS, "mtx_swap_rows") \
+    X(SWAP_COLS, "mtx_swap_cols") \
+    X(ROW_MULT, "mtx_row_mult") \
+    X(ROW_DIV, "mtx_row_div") \
+    X(ROW_ADD, "mtx_row_add") \
+    X(NORM, "mtx_norm") \
+    X(NORM1, "mtx_norm1") \
+    X(NORM_FRO, "mtx_norm_fro") \
+    X(NORM_MAX, "mtx_norm_max") \
+    X(TRACE, "mtx_trace") \
+    X(DOT, "mtx_dot") \
+    X(COL_SUMS, "mtx_col_sums") \
+    X(EXP, "mtx_exp") \
+    X(EXP_MUL, "mtx_exp_mul_seq") \
+    X(FUN, "mtx_fun") \
+    X(SOLVE_GAUSS, "mtx_solve_gauss") \
+    X(GAUSS_ELIM, "mtx_gauss_elim") \
+    X(VERIFY, "mtx_verify_solution") \
+    X(EIG_SYM, "mtx_eig_sym") \
+    X(QR, "mtx_qr") \
+    X(SVD_RAND, "mtx_svd_rand") \
+    X(OOC_MUL, "mtx_ooc_mul") \
+    X(OOC_LU, "mtx_ooc_lu") \
+    X(PLAN_EXEC, "mtx_plan_execute") \
+    X(STRUCT_MUL, "mtx_struct_mul") \
+    X(STRUCT_SOLVE, "mtx_struct_solve") \
+    X(BAND_FACTOR, "mtx_band_factor") \
+    X(TRIDIAG_SOLVE, "mtx_tridiag_solve") \
+    X(LU_FACTOR, "mtx_lu_factor") \
+    X(LU_SOLVE, "mtx_lu_solve") \
+    X(LU_UPDATE, "mtx_lu_update") \
+    X(CHOL_FACTOR, "mtx_chol_factor") \
+    X(CHOL_UPDATE, "mtx_chol_update") \
+    X(WOODBURY, "mtx_lu_solve_woodbury") \
+    X(INV_UPDATE, "mtx_inverse_update") \
+    X(TILED_MUL, "mtx_tiled_mul") \
+    X(TILED_LU, "mtx_tiled_lu") \
+    X(RAND_UNIFORM, "mtx_rand_uniform") \
+    X(RAND_NORMAL, "mtx_rand_normal")
+
+/**
+ * @brief Operation identifiers (MTX_OP_ADD, MTX_OP_MUL, ...)
+ */
+typedef enum {
+#define MTX_METRIC_ENUM(id, name) MTX_OP_##id,
+    MTX_METRIC_OPS(MTX_METRIC_ENUM)
+#undef MTX_METRIC_ENUM
+    MTX_OP_COUNT
+} mtx_op;
+
+/**
+ * @brief Counters of one operation
+ */
+typedef struct {
+    uint64_t calls;                         // completed calls
+    uint64_t bytes;                         // bytes read and written by the operation
+    uint64_t flops;                         // floating point operations
+    uint64_t ns_total;                      // cumulative latency, nanoseconds
+    uint64_t hist[MTX_METRICS_BUCKETS];     // latency histogram, log2 nanoseconds
+} mtx_op_stats;
+
+/**
+ * @brief Snapshot of all counters, summed over threads
+ */
+typedef struct {
+    mtx_op_stats op[MTX_OP_COUNT];
+} mtx_metrics;
+
+/* ================== Recording ================== */
+
+/**
+ * @brief Reads the monotonic clock
+ * @return Nanoseconds since an arbitrary fixed point
+ */
+uint64_t mtx_metrics_now(void);
+
+/**
+ * @brief Adds one completed call to the calling thread's counters
+ * @param op Operation identifier
+ * @param t0 Start time returned by mtx_metrics_now
+ * @param bytes Bytes moved by the call
+ * @param flops Floating point operations performed by the call
+ * @note Only the owning thread writes its counters, so recording needs no locks
+ * or atomic read-modify-write instructions
+ */
+void mtx_metrics_record(mtx_op op, uint64_t t0, uint64_t bytes, uint64_t flops);
+
+#if MTX_METRICS
+    /**
+     * @def MTX_METRIC_BEGIN(op)
+     * @brief Starts timing an operation in the current scope
+     */
+    #define MTX_METRIC_BEGIN(op) const uint64_t mtx_metric_t0_##op = mtx_metrics_now()
+
+    /**
+     * @def MTX_METRIC_END(op, bytes, flops)
+     * @brief Records a completed call started with MTX_METRIC_BEGIN(op)
+     */
+    #define MTX_METRIC_END(op, bytes, flops) \
+        mtx_metrics_record(MTX_OP_##op, mtx_metric_t0_##op, (uint64_t)(bytes), (uint64_t)(flops))
+#else
+    #define MTX_METRIC_BEGIN(op)
+    #define MTX_METRIC_END(op, bytes, flops) ((void)0)
+#endif
+
+/**
+ * @brief Bytes touched by an (h x k) * (k x w) product
+ */
+#define MTX_MUL_BYTES(h, k, w) (((h) * (k) + (k) * (w) + (h) * (w)) * sizeof(double))
+
+/**
+ * @brief Floating point operations of an (h x k) * (k x w) product
+ */
+#define MTX_MUL_FLOPS(h, k, w) (2 * (h) * (k) * (w))
+
+/* ================== Sampling ================== */
+
+/**
+ * @brief Returns the name of an operation
+ * @param op Operation identifier
+ * @return Function or kernel name, "unknown" for invalid identifiers
+ */
+const char *mtx_metrics_op_name(mtx_op op);
+
+/**
+ * @brief Takes a snapshot of all counters accumulated since the last reset
+ * @param out Snapshot to fill
+ * @return 0 on success, 1 if NULL pointer
+ */
+int mtx_metrics_get(mtx_metrics *out);
+
+/**
+ * @brief Resets all counters; later snapshots only include calls made after the reset
+ */
+void mtx_metrics_reset(void);
+
+/**
+ * @brief Writes a snapshot as a JSON object
+ * @param f Output stream
+ * @param m Snapshot to export
+ * @return 0 on success, 1 if any pointer is NULL, -1 on write error
+ */
+int mtx_metrics_export_json(FILE *f, const mtx_metrics *m);
+
+/**
+ * @brief Writes a snapshot in the Prometheus text exposition format
+ * @param f Output stream
+ * @param m Snapshot to export
+ * @return 0 on success, 1 if any pointer is NULL, -1 on write error
+ */
+int mtx_metrics_export_prometheus(FILE *f, const mtx_metrics *m);
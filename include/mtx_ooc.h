@@ -0,0 +1,143 @@
+#pragma once
+
+#include "mtx_repmem.h"
+#include "mtx_arithmetic.h"
+#include "mtx_actions.h"
+#include "mtx_logs.h"
+
+/**
+ * @brief Out-of-core matrix stored as square tiles in a file on local disk
+ *
+ * Tile file format (native byte order):
+ * - header of MTX_OOC_HEADER bytes: magic "MTXTILE1", then uint64 height, width, tile size
+ * - tiles in row-major tile order; tile (ti, tj) is tile * tile doubles, row-major,
+ *   zero-padded at the right and bottom edges of the matrix
+ *
+ * Tiles are accessed through a per-handle LRU cache of bounded size. Dirty tiles
+ * are written back on eviction, mtx_ooc_flush and mtx_ooc_close.
+ */
+struct mtx_ooc;
+typedef struct mtx_ooc mtx_ooc;
+
+/**
+ * @brief Size of the tile file header; keeps tiles page aligned
+ */
+#define MTX_OOC_HEADER 4096
+
+/**
+ * @brief Smallest number of tiles the cache is allowed to hold
+ */
+#define MTX_OOC_MIN_TILES 4
+
+/* ================== Files ================== */
+
+/**
+ * @brief Creates a zero-filled tile file
+ * @param path File path (created or truncated)
+ * @param w Number of columns
+ * @param h Number of rows
+ * @param tile Tile edge length
+ * @param cache_bytes Memory budget of the tile cache (at least MTX_OOC_MIN_TILES tiles are kept)
+ * @return Handle, NULL on failure
+ */
+mtx_ooc *mtx_ooc_create(const char *path, size_t w, size_t h, size_t tile, size_t cache_bytes);
+
+/**
+ * @brief Opens an existing tile file
+ * @param path File path
+ * @param cache_bytes Memory budget of the tile cache
+ * @return Handle, NULL on failure or if the file is not a tile file
+ */
+mtx_ooc *mtx_ooc_open(const char *path, size_t cache_bytes);
+
+/**
+ * @brief Writes back all dirty cached tiles
+ * @param m Handle
+ * @return 0 on success, 1 if NULL pointer, -1 on I/O error
+ */
+int mtx_ooc_flush(mtx_ooc *m);
+
+/**
+ * @brief Flushes and closes a tile file, releasing the cache
+ * @param m Handle (safe with NULL)
+ * @return 0 on success, -1 on I/O error (the handle is released anyway)
+ */
+int mtx_ooc_close(mtx_ooc *m);
+
+/**
+ * @brief Give tile file matrix width
+ * @return 0, if pointer is NULL, matrix width, if all is fine
+ */
+size_t mtx_ooc_get_width(const mtx_ooc *m);
+
+/**
+ * @brief Give tile file matrix height
+ * @return 0, if pointer is NULL, matrix height, if all is fine
+ */
+size_t mtx_ooc_get_height(const mtx_ooc *m);
+
+/**
+ * @brief Give tile edge length
+ * @return 0, if pointer is NULL, tile size, if all is fine
+ */
+size_t mtx_ooc_get_tile(const mtx_ooc *m);
+
+/* ================== Tile Access ================== */
+
+/**
+ * @brief Copies tile (ti, tj) into buf (tile * tile doubles, row-major, zero-padded)
+ * @return 0 on success, 1 if NULL pointer, -1 if invalid tile index, -2 on I/O or cache error
+ */
+int mtx_ooc_read_tile(mtx_ooc *m, size_t ti, size_t tj, double *buf);
+
+/**
+ * @brief Overwrites tile (ti, tj) from buf (tile * tile doubles, row-major)
+ * @return 0 on success, 1 if NULL pointer, -1 if invalid tile index, -2 on I/O or cache error
+ */
+int mtx_ooc_write_tile(mtx_ooc *m, size_t ti, size_t tj, const double *buf);
+
+/**
+ * @brief Copies an in-core matrix into a tile file of the same size
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch, -2 on I/O or cache error
+ */
+int mtx_ooc_from_matrix(mtx_ooc *dst, const matrix *src);
+
+/**
+ * @brief Copies a tile file into an in-core matrix of the same size
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch, -2 on I/O or cache error
+ */
+int mtx_ooc_to_matrix(matrix *dst, mtx_ooc *src);
+
+/* ================== Tiled Algorithms ================== */
+
+/**
+ * @brief Tiled matrix multiplication (C = A * B)
+ * @param C Output tile file (A->h x B->w), must differ from A and B
+ * @param A First operand
+ * @param B Second operand
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size or tile size mismatch,
+ *         -2 on I/O or cache error
+ * @note The tiles needed for the next step are announced to the kernel with
+ * posix_fadvise(WILLNEED), so disk reads overlap with the current tile products
+ */
+int mtx_ooc_mul(mtx_ooc *C, mtx_ooc *A, mtx_ooc *B);
+
+/**
+ * @brief In-place tiled LU factorization with partial pivoting (P*A = L*U)
+ * @param A Square tile file, overwritten by unit lower L and upper U
+ * @param piv Output array of n row interchanges: row i was swapped with row piv[i]
+ * @return 0 on success, 1 if any pointer is NULL, -1 if non-square,
+ *         -2 on I/O or cache error, -3 if the matrix is singular
+ * @note Right-looking by tile columns. The pivot search walks a whole tile column,
+ * so the cache should hold one tile column plus three tiles to avoid re-reading it.
+ */
+int mtx_ooc_lu(mtx_ooc *A, size_t *piv);
+
+/**
+ * @brief Solves A*X = B using the factors from mtx_ooc_lu
+ * @param LU Factored tile file (n x n)
+ * @param piv Row interchanges from mtx_ooc_lu
+ * @param B In-core right-hand side (n x m), overwritten by X
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch, -2 on I/O or cache error
+ */
+int mtx_ooc_lu_solve(mtx_ooc *LU, const size_t *piv, matrix *B);
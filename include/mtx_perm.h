@@ -0,0 +1,113 @@
+#pragma once
+
+#include "mtx_repmem.h"
+#include "mtx_logs.h"
+
+/**
+ * @brief Permutation of n indices
+ *
+ * Stored as an index vector p: applied to rows, row i of P*A is row p[i] of A;
+ * applied to columns, column j of A*P is column p[j] of A. Swaps and
+ * compositions only touch the index vector; matrix data moves once, when the
+ * permutation is applied, or never, when a kernel reads through it.
+ */
+struct mtx_perm;
+typedef struct mtx_perm mtx_perm;
+
+/* ================== Allocation ================== */
+
+/**
+ * @brief Allocates an identity permutation
+ * @param n Number of indices
+ * @return New permutation, NULL on failure
+ */
+mtx_perm *mtx_perm_alloc(size_t n);
+
+/**
+ * @brief Creates a copy of a permutation
+ * @return New permutation, NULL on failure
+ */
+mtx_perm *mtx_perm_copy(const mtx_perm *p);
+
+/**
+ * @brief Releases a permutation
+ * @param p Permutation (safe with NULL)
+ */
+void mtx_perm_free(mtx_perm *p);
+
+/**
+ * @brief Resets a permutation to the identity
+ * @param p Permutation
+ */
+void mtx_perm_set_id(mtx_perm *p);
+
+/**
+ * @brief Give permutation size
+ * @return 0, if pointer is NULL, number of indices, if all is fine
+ */
+size_t mtx_perm_size(const mtx_perm *p);
+
+/**
+ * @brief Give the source index of position i
+ * @return p[i], or i if the pointer is NULL or i is out of range
+ */
+size_t mtx_perm_get(const mtx_perm *p, size_t i);
+
+/* ================== Index Operations ================== */
+
+/**
+ * @brief Exchanges positions i and j in O(1)
+ * @return 0 on success, 1 if NULL pointer, -1 if invalid indices
+ */
+int mtx_perm_swap(mtx_perm *p, size_t i, size_t j);
+
+/**
+ * @brief Composes two permutations: res = a * b (apply b first, then a)
+ * @param res Result, may alias a or b
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch, -2 if allocation failed
+ */
+int mtx_perm_compose(mtx_perm *res, const mtx_perm *a, const mtx_perm *b);
+
+/**
+ * @brief Computes the inverse permutation
+ * @param res Result, may alias p
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch, -2 if allocation failed
+ */
+int mtx_perm_inverse(mtx_perm *res, const mtx_perm *p);
+
+/* ================== Application ================== */
+
+/**
+ * @brief Gathers rows: dst = P * src
+ * @param dst Result (same size as src), must not alias src
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch or aliasing, -2 if allocation failed
+ */
+int mtx_perm_rows(matrix *dst, const mtx_perm *p, const matrix *src);
+
+/**
+ * @brief Gathers columns: dst = src * P
+ * @param dst Result (same size as src), must not alias src
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch or aliasing, -2 if allocation failed
+ * @note Walks both matrices row by row, so unlike repeated mtx_swap_cols calls
+ * every access except the in-row gather is sequential
+ */
+int mtx_perm_cols(matrix *dst, const mtx_perm *p, const matrix *src);
+
+/**
+ * @brief Permutes rows in place (mtx = P * mtx) by following cycles
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch, -2 if allocation failed
+ */
+int mtx_perm_rows_inplace(matrix *mtx, const mtx_perm *p);
+
+/**
+ * @brief Permutes columns in place (mtx = mtx * P) one row at a time
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch, -2 if allocation failed
+ */
+int mtx_perm_cols_inplace(matrix *mtx, const mtx_perm *p);
+
+/**
+ * @brief Computes res = (P * A) * B reading the rows of A through the permutation
+ * @param res Result (A->h x B->w), must not alias A or B
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch or aliasing, -2 if allocation failed
+ */
+int mtx_perm_mul(matrix *res, const mtx_perm *p, const matrix *A, const matrix *B);
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "mtx_repmem.h"
+#include "mtx_arithmetic.h"
+#include "mtx_logs.h"
+
+/**
+ * @brief Recorded sequence of matrix operations replayed on same-shaped data
+ *
+ * Usage:
+ * 1. declare matrix slots with mtx_plan_matrix (shapes are fixed per slot);
+ * 2. record operations on slot ids; shapes are checked while recording;
+ * 3. mtx_plan_compile picks kernels and allocates every slot and workspace;
+ * 4. load inputs (mtx_plan_get, or mtx_plan_bind for caller-owned storage)
+ *    and call mtx_plan_execute as often as needed.
+ *
+ * Execution performs no argument checks, no allocation and no logging on success.
+ * The exception is a multiply whose output slot and an operand slot are bound to
+ * the same matrix or buffer: the operand is snapshot into per-thread scratch first.
+ */
+struct mtx_plan;
+typedef struct mtx_plan mtx_plan;
+
+/* ================== Recording ================== */
+
+/**
+ * @brief Creates an empty plan
+ * @return New plan, NULL on failure
+ */
+mtx_plan *mtx_plan_create(void);
+
+/**
+ * @brief Releases a plan with its slots and workspace (bound matrices are not freed)
+ * @param plan Plan (safe with NULL)
+ */
+void mtx_plan_free(mtx_plan *plan);
+
+/**
+ * @brief Declares a matrix slot
+ * @param plan Plan being recorded
+ * @param w Number of columns
+ * @param h Number of rows
+ * @return Slot id (>= 0), -1 if invalid arguments or the plan is compiled, -2 if allocation failed
+ */
+int mtx_plan_matrix(mtx_plan *plan, size_t w, size_t h);
+
+/**
+ * @brief Records dst = a * b
+ * @return 0 on success, 1 if NULL plan, -1 if invalid slot, shape mismatch,
+ *         dst aliasing an operand or compiled plan, -2 if allocation failed
+ */
+int mtx_plan_mul(mtx_plan *plan, int dst, int a, int b);
+
+/**
+ * @brief Records dst = a + b (dst may alias an operand)
+ * @return Same codes as mtx_plan_mul
+ */
+int mtx_plan_add(mtx_plan *plan, int dst, int a, int b);
+
+/**
+ * @brief Records dst = a - b (dst may alias an operand)
+ * @return Same codes as mtx_plan_mul
+ */
+int mtx_plan_sub(mtx_plan *plan, int dst, int a, int b);
+
+/**
+ * @brief Records dst = src
+ * @return Same codes as mtx_plan_mul
+ */
+int mtx_plan_copy(mtx_plan *plan, int dst, int src);
+
+/**
+ * @brief Records *out = mtx_norm(a)
+ * @param out Receives the norm on every execution; must outlive the plan
+ * @return Same codes as mtx_plan_mul
+ */
+int mtx_plan_norm(mtx_plan *plan, int a, double *out);
+
+/**
+ * @brief Records the solution of A*X = B by Gaussian elimination into X
+ * @return Same codes as mtx_plan_mul
+ */
+int mtx_plan_solve(mtx_plan *plan, int X, int A, int B);
+
+/* ================== Execution ================== */
+
+/**
+ * @brief Selects kernels and allocates all unbound slots and workspace
+ * @param plan Recorded plan
+ * @return 0 on success, 1 if NULL plan, -1 if already compiled, -2 if allocation failed
+ */
+int mtx_plan_compile(mtx_plan *plan);
+
+/**
+ * @brief Uses caller-owned storage for a slot instead of plan-owned storage
+ * @param plan Plan (compiled or not)
+ * @param slot Slot id
+ * @param mtx Matrix of the slot's shape, NULL to return to plan-owned storage
+ * @return 0 on success, 1 if NULL plan, -1 if invalid slot or shape mismatch,
+ *         -2 if unbinding a compiled plan's slot could not allocate its storage
+ * @note The matrix must stay valid while the plan executes with it
+ */
+int mtx_plan_bind(mtx_plan *plan, int slot, matrix *mtx);
+
+/**
+ * @brief Returns the matrix currently used for a slot
+ * @return Matrix, NULL if invalid slot or the slot has no storage yet (plan not compiled)
+ * @note A clone of it keeps the current values; the next run writes a private copy
+ */
+matrix *mtx_plan_get(mtx_plan *plan, int slot);
+
+/**
+ * @brief Runs all recorded operations in order
+ * @param plan Compiled plan
+ * @return 0 on success, 1 if NULL plan, -1 if not compiled, -2 if a shared destination
+ *         could not be unshared or an aliased operand could not be snapshot, -3 if a
+ *         solve met a singular matrix
+ */
+int mtx_plan_execute(mtx_plan *plan);
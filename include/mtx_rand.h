@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdint.h>
+#include "mtx_repmem.h"
+#include "mtx_logs.h"
+
+/**
+ * @brief Counter-based random matrices
+ *
+ * Every element is a pure function of (seed, stream, element index): Philox4x32-10
+ * turns the counter (index / 2, stream) under the key seed into 128 random bits,
+ * which give elements 2b and 2b + 1 of the row-major data. Fills therefore run
+ * in parallel, in any order, and give the same matrix for a seed whatever the
+ * thread count or schedule. Distinct seeds give independent matrices, so Monte
+ * Carlo runs can use the run number as the seed.
+ */
+
+/* ================== Fills ================== */
+
+/**
+ * @brief Fills a matrix with uniform samples in [lo, hi)
+ * @param mtx Matrix to overwrite
+ * @param lo Lower bound
+ * @param hi Upper bound
+ * @param seed Seed
+ * @return 0 on success, 1 if pointer is NULL, -2 if allocation failed
+ */
+int mtx_rand_uniform(matrix *mtx, double lo, double hi, uint64_t seed);
+
+/**
+ * @brief Fills a matrix with normal samples (Box-Muller on each Philox block)
+ * @param mtx Matrix to overwrite
+ * @param mean Mean
+ * @param sd Standard deviation
+ * @param seed Seed
+ * @return 0 on success, 1 if pointer is NULL, -2 if allocation failed
+ */
+int mtx_rand_normal(matrix *mtx, double mean, double sd, uint64_t seed);
+
+/* ================== Structured Matrices ================== */
+
+/**
+ * @brief Creates a random orthogonal matrix, Haar distributed
+ * @param n Matrix size
+ * @param seed Seed
+ * @return n x n matrix, NULL if n is zero or allocation failed
+ * @note Q of the QR factorization of a normal matrix, with the column signs
+ * fixed so that diag(R) > 0
+ */
+matrix *mtx_rand_orthogonal(size_t n, uint64_t seed);
+
+/**
+ * @brief Creates a random symmetric positive definite matrix with a given condition number
+ * @param n Matrix size
+ * @param cond 2-norm condition number, >= 1
+ * @param seed Seed
+ * @return n x n matrix Q * diag(l) * Q^T with Q random orthogonal and eigenvalues
+ *         l geometrically spaced from 1 down to 1 / cond, NULL if n is zero,
+ *         cond < 1 or allocation failed
+ */
+matrix *mtx_rand_spd(size_t n, double cond, uint64_t seed);
+
+/**
+ * @brief Creates a random matrix with a given condition number
+ * @param w Number of columns
+ * @param h Number of rows
+ * @param cond 2-norm condition number, >= 1
+ * @param seed Seed
+ * @return h x w matrix U * diag(s) * V^T with U, V random orthonormal columns and
+ *         singular values s geometrically spaced from 1 down to 1 / cond, NULL
+ *         if a dimension is zero, cond < 1 or allocation failed
+ */
+matrix *mtx_rand_cond(size_t w, size_t h, double cond, uint64_t seed);
@@ -19,8 +19,84 @@ typedef struct matrix matrix;
  */
 matrix* mtx_alloc(size_t w, size_t h);
 
+/**
+ * @brief Creates a matrix over an existing row-major buffer, without copying
+ * @param data Buffer of w * h doubles, element (i, j) at data[w * i + j]
+ * @param w Number of columns
+ * @param h Number of rows
+ * @return Matrix handle, NULL if data is NULL, a dimension is zero or allocation failed
+ * @note The buffer stays owned by the caller and must outlive the handle;
+ * mtx_free releases only the handle. Library calls write straight into the
+ * buffer, except after mtx_clone (the writer gets a private copy) and in
+ * operations that widen the matrix, which move it to library memory.
+ */
+matrix *mtx_wrap(double *data, size_t w, size_t h);
+
 int mtx_assign(matrix *mtx1, const matrix *mtx2);
 
+/* ================== Allocation Policies ================== */
+
+/**
+ * @brief Default size from which matrix data is mapped with the active policy (2 MiB);
+ * smaller matrices always use malloc
+ */
+#define MTX_MEM_THRESHOLD (2u << 20)
+
+/**
+ * @brief NUMA placement of matrix data
+ */
+typedef enum {
+    MTX_MEM_DEFAULT = 0,    // kernel default (local node of the faulting thread)
+    MTX_MEM_INTERLEAVE,     // pages interleaved round-robin over all online nodes
+    MTX_MEM_FIRST_TOUCH,    // rows touched by the OpenMP threads that later own them
+    MTX_MEM_BIND            // pages bound to mtx_mem_policy.node
+} mtx_mem_placement;
+
+/**
+ * @brief Page size of matrix data
+ */
+typedef enum {
+    MTX_PAGES_DEFAULT = 0,  // base pages
+    MTX_PAGES_TRANSPARENT,  // 2 MiB aligned mapping advised with MADV_HUGEPAGE
+    MTX_PAGES_HUGE          // explicit MAP_HUGETLB pages, transparent if none are reserved
+} mtx_mem_pages;
+
+/**
+ * @brief Allocation policy for matrix data
+ */
+typedef struct {
+    mtx_mem_placement placement;
+    mtx_mem_pages pages;
+    int node;               // target node of MTX_MEM_BIND
+    size_t threshold;       // data size in bytes from which the policy applies
+} mtx_mem_policy;
+
+/**
+ * @brief Sets the policy used by mtx_alloc and everything built on it
+ * @param policy New policy, NULL restores the default (malloc for every size)
+ * @note Changes the calling thread's current context (see mtx_context.h)
+ */
+void mtx_mem_set_policy(const mtx_mem_policy *policy);
+
+/**
+ * @brief Reads the policy used by mtx_alloc on this thread
+ * @param policy Output policy
+ */
+void mtx_mem_get_policy(mtx_mem_policy *policy);
+
+/**
+ * @brief Allocates uninitialized matrix with an explicit allocation policy
+ * @param w Number of columns
+ * @param h Number of rows
+ * @param policy Policy for this matrix, NULL for the one of the current context
+ * @return Pointer to allocated matrix, NULL on failure
+ * @note Placement and huge page requests are best effort: if the system refuses
+ * them (no NUMA, no reserved huge pages) the matrix is still allocated with base
+ * pages and the failure is logged. Data mapped with MTX_MEM_FIRST_TOUCH is zero-filled
+ * by the OpenMP threads, row block by row block.
+ */
+matrix *mtx_alloc_policy(size_t w, size_t h, const mtx_mem_policy *policy);
+
 /**
  * @brief Creates a deep copy of matrix
  * @param mtx Source matrix to copy
@@ -28,9 +104,27 @@ int mtx_assign(matrix *mtx1, const matrix *mtx2);
  */
 matrix* mtx_copy(const matrix* mtx);
 
+/**
+ * @brief Creates a copy-on-write handle to the same matrix data
+ * @param mtx Source matrix
+ * @return New handle, NULL on failure
+ * @note O(1): the handles share one buffer until either is written through
+ * mtx_ptr or any library function that modifies it, which first gives the
+ * writer a private copy. Handles are released with mtx_free in any order and
+ * from any thread; the share count is atomic. Writing one handle while
+ * another thread clones that same handle is a data race, as with any write.
+ */
+matrix* mtx_clone(const matrix* mtx);
+
+/**
+ * @brief Tells whether the data of a matrix is currently shared with a clone
+ * @return 1 if shared, 0 otherwise (or if pointer is NULL)
+ */
+int mtx_is_shared(const matrix* mtx);
+
 /**
  * @brief Releases matrix memory
- * @param m Matrix to deallocate (safe with NULL)
+ * @param m Matrix to deallocate (safe with NULL); shared data is freed with its last handle
  */
 void mtx_free(matrix* m);
 
@@ -41,7 +135,8 @@ void mtx_free(matrix* m);
  * @param mtx Target matrix
  * @param i Row index (0-based)
  * @param j Column index (0-based)
- * @return Pointer to element, NULL on invalid indices
+ * @return Pointer to element, NULL on invalid indices or if a shared matrix could not be unshared
+ * @note Unshares a cloned matrix; the pointer stays valid until the matrix is freed or resized
  */
 double* mtx_ptr(matrix* mtx, size_t i, size_t j);
 
@@ -88,7 +183,7 @@ matrix* mtx_alloc_id(size_t w, size_t h);
 /**
  * @brief Reads matrix from stdin
  * @param mtx Matrix to populate
- * @return 0 on success, -1 on error
+ * @return 0 on success, -1 on error, -2 if allocation failed
  */
 int mtx_input(matrix* mtx);
 
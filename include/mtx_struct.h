@@ -0,0 +1,222 @@
+#pragma once
+
+#include "mtx_repmem.h"
+#include "mtx_arithmetic.h"
+#include "mtx_logs.h"
+
+/**
+ * @brief Square matrix stored by structure, without its structural zeros
+ *
+ * Layouts (n x n, all row-major):
+ * - MTX_DIAG: n diagonal entries
+ * - MTX_BANDED: kl sub- and ku superdiagonals; row i holds columns
+ *   i - kl .. i + ku at offset (kl + ku + 1) * i + (j - i + kl)
+ * - MTX_SYM_PACKED: lower triangle, row i holds columns 0..i at offset i(i+1)/2;
+ *   a_ij for j > i reads a_ji
+ * - MTX_TRI_LOWER: lower triangle, same packing as MTX_SYM_PACKED
+ * - MTX_TRI_UPPER: upper triangle, row i holds columns i..n-1
+ */
+struct smatrix;
+typedef struct smatrix smatrix;
+
+/**
+ * @brief Storage layouts of structured matrices
+ */
+typedef enum {
+    MTX_DIAG,
+    MTX_BANDED,
+    MTX_SYM_PACKED,
+    MTX_TRI_LOWER,
+    MTX_TRI_UPPER
+} mtx_layout;
+
+/* ================== Allocation ================== */
+
+/**
+ * @brief Allocates a zero diagonal matrix
+ * @param n Order
+ * @return New matrix, NULL on failure
+ */
+smatrix *mtx_diag_alloc(size_t n);
+
+/**
+ * @brief Allocates an identity matrix with n stored entries
+ * @param n Order
+ * @return New matrix, NULL on failure
+ */
+smatrix *mtx_diag_alloc_id(size_t n);
+
+/**
+ * @brief Allocates a zero banded matrix
+ * @param n Order
+ * @param kl Number of subdiagonals
+ * @param ku Number of superdiagonals
+ * @return New matrix, NULL on failure
+ */
+smatrix *mtx_band_alloc(size_t n, size_t kl, size_t ku);
+
+/**
+ * @brief Allocates a zero packed symmetric matrix
+ * @param n Order
+ * @return New matrix, NULL on failure
+ */
+smatrix *mtx_sym_alloc(size_t n);
+
+/**
+ * @brief Allocates a zero packed triangular matrix
+ * @param n Order
+ * @param upper 1 for upper triangular, 0 for lower triangular
+ * @return New matrix, NULL on failure
+ */
+smatrix *mtx_tri_alloc(size_t n, int upper);
+
+/**
+ * @brief Releases a structured matrix
+ * @param s Matrix to deallocate (safe with NULL)
+ */
+void mtx_struct_free(smatrix *s);
+
+/* ================== Accessors ================== */
+
+/**
+ * @brief Give storage layout
+ * @return Layout, MTX_DIAG if pointer is NULL
+ */
+mtx_layout mtx_struct_layout(const smatrix *s);
+
+/**
+ * @brief Give matrix order
+ * @return 0, if pointer is NULL, order, if all is fine
+ */
+size_t mtx_struct_order(const smatrix *s);
+
+/**
+ * @brief Gets mutable pointer to a stored element
+ * @param s Target matrix
+ * @param i Row index (0-based)
+ * @param j Column index (0-based)
+ * @return Pointer to element (for symmetric storage, to the stored mirror when j > i),
+ *         NULL on invalid indices or if (i, j) is a structural zero
+ */
+double *mtx_struct_ptr(smatrix *s, size_t i, size_t j);
+
+/**
+ * @brief Reads an element
+ * @return Element value, 0.0 for structural zeros, NULL pointer or invalid indices
+ */
+double mtx_struct_get(const smatrix *s, size_t i, size_t j);
+
+/* ================== Conversion ================== */
+
+/**
+ * @brief Extracts the structured part of a square dense matrix
+ * @param mtx Dense square matrix
+ * @param layout Target layout
+ * @param kl Number of subdiagonals (MTX_BANDED only)
+ * @param ku Number of superdiagonals (MTX_BANDED only)
+ * @return New structured matrix, NULL on failure
+ * @note Entries outside the structure are dropped; symmetric storage takes the lower triangle
+ */
+smatrix *mtx_struct_from_dense(const matrix *mtx, mtx_layout layout, size_t kl, size_t ku);
+
+/**
+ * @brief Expands a structured matrix into a new dense matrix
+ * @return New dense matrix (n x n), NULL on failure
+ */
+matrix *mtx_struct_to_dense(const smatrix *s);
+
+/* ================== Kernels ================== */
+
+/**
+ * @brief Computes res = S * B touching only stored entries
+ * @param res Dense result (n x m), must not alias B
+ * @param s Structured matrix (n x n)
+ * @param B Dense operand (n x m)
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch or aliasing, -2 if allocation failed
+ */
+int mtx_struct_mul(matrix *res, const smatrix *s, const matrix *B);
+
+/**
+ * @brief Adds a structured matrix to a dense one (mtx += S)
+ * @param mtx Dense square matrix (n x n)
+ * @param s Structured matrix (n x n)
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch, -2 if allocation failed
+ */
+int mtx_struct_add(matrix *mtx, const smatrix *s);
+
+/**
+ * @brief Adds two structured matrices of the same layout (res = a + b)
+ * @param res Result, same layout, order and bandwidths as the operands; may alias them
+ * @return 0 on success, 1 if any pointer is NULL, -1 if layout or size mismatch
+ */
+int mtx_struct_add2(smatrix *res, const smatrix *a, const smatrix *b);
+
+/**
+ * @brief Solves S * X = B in place
+ * @param s Structured matrix (n x n)
+ * @param B Right-hand side (n x m), overwritten by X
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch,
+ *         -2 if allocation failed, -3 if singular (or not positive definite)
+ * @note Diagonal: scaling. Triangular: substitution. Banded: mtx_band_factor
+ * followed by mtx_band_lu_solve. Symmetric: packed Cholesky, so the matrix
+ * must be positive definite.
+ */
+int mtx_struct_solve(const smatrix *s, matrix *B);
+
+/* ================== Banded Solvers ================== */
+
+/**
+ * @brief LU factors of a banded matrix, reusable for any number of right-hand sides
+ */
+struct mtx_band_lu;
+typedef struct mtx_band_lu mtx_band_lu;
+
+/**
+ * @brief Banded LU factorization with partial pivoting (P*A = L*U)
+ * @param s Banded matrix (MTX_BANDED)
+ * @return Factors, NULL if not banded, allocation failed or singular
+ * @note O(n * kl * (kl + ku)) time and n * (2kl + ku + 1) doubles: pivoting
+ * widens U to kl + ku superdiagonals
+ */
+mtx_band_lu *mtx_band_factor(const smatrix *s);
+
+/**
+ * @brief Solves A*X = B with factors from mtx_band_factor
+ * @param lu Factors
+ * @param B Right-hand side (n x m), overwritten by X
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch, -2 if allocation failed
+ */
+int mtx_band_lu_solve(const mtx_band_lu *lu, matrix *B);
+
+/**
+ * @brief Releases banded LU factors
+ * @param lu Factors (safe with NULL)
+ */
+void mtx_band_lu_free(mtx_band_lu *lu);
+
+/**
+ * @brief Solves a tridiagonal system with the Thomas algorithm
+ * @param dl Subdiagonal, dl[i] = a(i, i-1); dl[0] is not referenced
+ * @param d Diagonal, d[i] = a(i, i)
+ * @param du Superdiagonal, du[i] = a(i, i+1); du[n-1] is not referenced
+ * @param B Right-hand side (n x m), overwritten by X
+ * @return 0 on success, 1 if any pointer is NULL, -2 if allocation failed, -3 on zero pivot
+ * @note No pivoting: intended for diagonally dominant or symmetric positive
+ * definite systems. O(n * m) time, 2n doubles of workspace.
+ */
+int mtx_tridiag_solve(const double *dl, const double *d, const double *du, matrix *B);
+
+/**
+ * @brief Parallel partitioned (SPIKE) tridiagonal solver
+ * @param dl Subdiagonal, as in mtx_tridiag_solve
+ * @param d Diagonal
+ * @param du Superdiagonal
+ * @param B Right-hand side (n x m), overwritten by X
+ * @param parts Number of row blocks, 0 for the number of OpenMP threads
+ * @return 0 on success, 1 if any pointer is NULL, -2 if allocation failed, -3 on zero pivot
+ * @note Each block is solved independently together with its two coupling
+ * spikes, a banded system of 2 * parts interface unknowns is solved, and the
+ * blocks are corrected in parallel. Same stability requirements as
+ * mtx_tridiag_solve; 4n doubles of workspace.
+ */
+int mtx_tridiag_solve_par(const double *dl, const double *d, const double *du, matrix *B, size_t parts);
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "mtx_repmem.h"
+#include "mtx_arithmetic.h"
+#include "mtx_logs.h"
+
+/**
+ * @brief In-core matrix stored as contiguous square tiles (tile-major layout)
+ *
+ * Tiles of MTX_TILE x MTX_TILE doubles are kept in row-major tile order; tile
+ * (ti, tj) is row-major and zero-padded at the right and bottom edges, the
+ * same layout as mtx_ooc tile files. Every kernel keeps the padding zero, so
+ * tile products never need edge cases. A column of a tile spans 64 cache
+ * lines of one 32 KiB block instead of one line per matrix row, and tile
+ * kernels run in parallel over independent tiles.
+ */
+struct mtx_tiled;
+typedef struct mtx_tiled mtx_tiled;
+
+/**
+ * @brief Tile edge length; one tile (32 KiB) fits in L1, three in L2
+ */
+#define MTX_TILE 64
+
+/* ================== Storage ================== */
+
+/**
+ * @brief Allocates a zero tiled matrix
+ * @param w Number of columns
+ * @param h Number of rows
+ * @return Tiled matrix, NULL if a dimension is zero or allocation failed
+ */
+mtx_tiled *mtx_tiled_alloc(size_t w, size_t h);
+
+/**
+ * @brief Releases a tiled matrix
+ * @param t Tiled matrix (safe with NULL)
+ */
+void mtx_tiled_free(mtx_tiled *t);
+
+/**
+ * @brief Give tiled matrix width
+ * @return 0, if pointer is NULL, matrix width, if all is fine
+ */
+size_t mtx_tiled_get_width(const mtx_tiled *t);
+
+/**
+ * @brief Give tiled matrix height
+ * @return 0, if pointer is NULL, matrix height, if all is fine
+ */
+size_t mtx_tiled_get_height(const mtx_tiled *t);
+
+/**
+ * @brief Get pointer to element (i, j)
+ * @return Pointer to element, NULL if out of bounds
+ */
+double *mtx_tiled_ptr(mtx_tiled *t, size_t i, size_t j);
+
+/**
+ * @brief Get pointer to tile (ti, tj): MTX_TILE * MTX_TILE doubles, row-major
+ * @return Pointer to the tile, NULL if out of bounds
+ * @note Entries outside the matrix must stay zero
+ */
+double *mtx_tiled_tile(mtx_tiled *t, size_t ti, size_t tj);
+
+/**
+ * @brief Copies a row-major matrix into a tiled matrix of the same size
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch
+ */
+int mtx_tiled_from_matrix(mtx_tiled *dst, const matrix *src);
+
+/**
+ * @brief Copies a tiled matrix into a row-major matrix of the same size
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch, -2 if allocation failed
+ */
+int mtx_tiled_to_matrix(matrix *dst, const mtx_tiled *src);
+
+/* ================== Element-wise Operations ================== */
+
+/**
+ * @brief res = a + b
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch
+ * @note res may be a or b
+ */
+int mtx_tiled_add2(mtx_tiled *res, const mtx_tiled *a, const mtx_tiled *b);
+
+/**
+ * @brief res = a - b
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch
+ * @note res may be a or b
+ */
+int mtx_tiled_sub2(mtx_tiled *res, const mtx_tiled *a, const mtx_tiled *b);
+
+/**
+ * @brief res = a * d
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch
+ * @note res may be a
+ */
+int mtx_tiled_smul2(mtx_tiled *res, const mtx_tiled *a, double d);
+
+/* ================== Tiled Algorithms ================== */
+
+/**
+ * @brief Transposition (res = src^T)
+ * @param res Output (src->h x src->w), must differ from src
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch or res is src
+ * @note Each tile is transposed in cache into its mirrored position
+ */
+int mtx_tiled_transpose(mtx_tiled *res, const mtx_tiled *src);
+
+/**
+ * @brief Matrix multiplication (C = A * B)
+ * @param C Output (A->h x B->w), must differ from A and B
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch or C aliases an operand
+ * @note Threads own result tiles, so all three operands are read and written
+ * one contiguous tile at a time
+ */
+int mtx_tiled_mul(mtx_tiled *C, const mtx_tiled *A, const mtx_tiled *B);
+
+/**
+ * @brief In-place LU factorization with partial pivoting (P*A = L*U)
+ * @param A Square tiled matrix, overwritten by unit lower L and upper U
+ * @param piv Output array of n row interchanges: row i was swapped with row piv[i]
+ * @return 0 on success, 1 if any pointer is NULL, -1 if non-square, -3 if singular
+ * @note Right-looking by tile columns, as mtx_ooc_lu: the pivot search walks
+ * one tile column, and the interchanges, the U tile row and the trailing
+ * tile updates run in parallel over tiles.
+ */
+int mtx_tiled_lu(mtx_tiled *A, size_t *piv);
+
+/**
+ * @brief Solves A*X = B using the factors from mtx_tiled_lu
+ * @param LU Factored tiled matrix (n x n)
+ * @param piv Row interchanges from mtx_tiled_lu
+ * @param B Row-major right-hand side (n x m), overwritten by X
+ * @return 0 on success, 1 if any pointer is NULL, -1 if size mismatch, -2 if allocation failed
+ */
+int mtx_tiled_lu_solve(const mtx_tiled *LU, const size_t *piv, matrix *B);
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stddef.h>
+#include "mtx_repmem.h"
+#include "mtx_logs.h"
+
+/**
+ * @brief Machine-dependent kernel parameters
+ *
+ * Read by the multiplication kernels at the start of every call, from the
+ * calling thread's context (see mtx_context.h). The first read loads the
+ * profile named by the MTX_TUNE_PROFILE environment variable (default
+ * $HOME/.mtx_tune) into the default context; if there is none, or it was
+ * written on another CPU model, the parameters are derived from the detected
+ * cache sizes.
+ *
+ * par_min is a single cutoff shared by every OpenMP region, calibrated on
+ * matrix-vector products: it is the multiply-add count at which the threaded
+ * product first beats the serial one. Other kernels compare their own work
+ * estimate against it (multiply-adds of the trailing update in LU and
+ * Cholesky, n * n * m in the solves, elements in the random fills), so it is
+ * only a rough threshold for them.
+ */
+typedef struct {
+    size_t block_i;      // blocked multiply: rows of the result per tile
+    size_t block_k;      // blocked multiply: inner dimension per tile
+    size_t block_j;      // blocked multiply: columns of the result per tile
+    size_t skinny_width; // widest right operand sent to the skinny kernels (<= MTX_SKINNY_WIDTH)
+    size_t par_min;      // work below which a kernel stays serial (see above)
+    size_t l1, l2, l3;   // data cache sizes in bytes, 0 if unknown
+} mtx_tune_params;
+
+/**
+ * @brief Environment variable naming the profile file
+ */
+#define MTX_TUNE_ENV "MTX_TUNE_PROFILE"
+
+/* ================== Parameters ================== */
+
+/**
+ * @brief Give the active parameters, loading the profile on first use
+ * @return Pointer to the active parameters, never NULL
+ */
+const mtx_tune_params *mtx_tune_get(void);
+
+/**
+ * @brief Replaces the active parameters
+ * @param params New parameters, NULL to go back to cache-derived defaults
+ * @return 0 on success, -1 if a value is out of range
+ * @note Changes the calling thread's current context
+ */
+int mtx_tune_set(const mtx_tune_params *params);
+
+/**
+ * @brief Derives parameters from cache sizes alone
+ * @param params Output parameters
+ * @note Sizes come from /sys/devices/system/cpu/cpu0/cache, then CPUID on x86;
+ * unknown sizes fall back to MTX_BLOCK_SIZE tiles
+ */
+void mtx_tune_defaults(mtx_tune_params *params);
+
+/* ================== Profiles ================== */
+
+/**
+ * @brief Loads a profile into the current context
+ * @param path Profile file, NULL for the default location
+ * @return 0 on success, 1 if no default location, -1 if malformed or written on another CPU model,
+ *         -2 if the file cannot be read
+ */
+int mtx_tune_load(const char *path);
+
+/**
+ * @brief Saves the active parameters
+ * @param path Profile file, NULL for the default location
+ * @return 0 on success, 1 if no default location, -2 if the file cannot be written
+ * @note The file is plain "key value" lines tagged with the CPU model name
+ */
+int mtx_tune_save(const char *path);
+
+/**
+ * @brief Benchmarks candidate parameters on this machine and makes the best active
+ * @param path Profile file to write, NULL to keep the result in memory only
+ * @return 0 on success, -2 if allocation failed or the profile cannot be written
+ *         (nothing is saved if a benchmark could not allocate)
+ * @note Times the blocked multiply over tile shapes, the skinny kernels
+ * against the blocked one for each width, and serial against threaded
+ * matrix-vector products for growing sizes. Takes a few seconds; run it
+ * once per machine, not in production paths.
+ */
+int mtx_tune_run(const char *path);
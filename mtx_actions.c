@@ -2,16 +2,14 @@
 #include "mtx_arithmetic.h"
 #include "mtx_actions.h"
 #include "mtx_logs.h"
+#include "mtx_metrics.h"
+#include "mtx_internal.h"
 #include <math.h>
-
-
-struct matrix
-{
-    double *data; // data + w * i + j
-    size_t w, h;    
-};
+#include <float.h>
+#include <stdlib.h>
 
 int mtx_transpose(matrix *mtx) {
+    MTX_METRIC_BEGIN(TRANSPOSE);
     if (!mtx || !mtx->data) {
         MTX_LOG_ERROR("Null matrix in transpose");
         return 1;
@@ -21,6 +19,7 @@ int mtx_transpose(matrix *mtx) {
         MTX_LOG_ERROR("Non-square matrix in transpose");
         return -1;
     }
+    if (mtx_unshare(mtx, 1) != 0) return -2;
     
     for (size_t i = 0; i < mtx->h; i++) {
         for (size_t j = i + 1; j < mtx->w; j++) {
@@ -31,10 +30,12 @@ int mtx_transpose(matrix *mtx) {
     }
 
     MTX_LOG("Matrix transposed");
+    MTX_METRIC_END(TRANSPOSE, 2 * mtx->w * mtx->h * sizeof(double), 0);
     return 0;
 }
 
 int mtx_swap_rows(matrix *mtx, size_t row1, size_t row2) {
+    MTX_METRIC_BEGIN(SWAP_ROWS);
     if (!mtx || !mtx->data) {
         MTX_LOG_ERROR("Null matrix in row swap");
         return 1;
@@ -43,6 +44,7 @@ int mtx_swap_rows(matrix *mtx, size_t row1, size_t row2) {
         MTX_LOG_ERROR("Invalid row indices in swap");
         return -1;
     }
+    if (mtx_unshare(mtx, 1) != 0) return -2;
     
     for (size_t j = 0; j < mtx->w; j++) {
         double tmp = mtx->data[row1 * mtx->w + j];
@@ -51,10 +53,12 @@ int mtx_swap_rows(matrix *mtx, size_t row1, size_t row2) {
     }
 
     MTX_LOG("Rows were swapped");
+    MTX_METRIC_END(SWAP_ROWS, 4 * mtx->w * sizeof(double), 0);
     return 0;
 }
 
 int mtx_swap_cols(matrix *mtx, size_t col1, size_t col2) {
+    MTX_METRIC_BEGIN(SWAP_COLS);
     if (!mtx || !mtx->data) {
         MTX_LOG_ERROR("Null matrix in column swap");
         return 1;
@@ -63,6 +67,7 @@ int mtx_swap_cols(matrix *mtx, size_t col1, size_t col2) {
         MTX_LOG_ERROR("Invalid column indices in swap");
         return -1;
     }
+    if (mtx_unshare(mtx, 1) != 0) return -2;
     
     for (size_t i = 0; i < mtx->h; i++) {
         double tmp = mtx->data[i * mtx->w + col1];
@@ -71,10 +76,12 @@ int mtx_swap_cols(matrix *mtx, size_t col1, size_t col2) {
     }
 
     MTX_LOG("Columns were swapped");
+    MTX_METRIC_END(SWAP_COLS, 4 * mtx->h * sizeof(double), 0);
     return 0;
 }
 
 int mtx_row_mult(matrix *mtx, size_t row, double factor) {
+    MTX_METRIC_BEGIN(ROW_MULT);
     if (!mtx || !mtx->data) {
         MTX_LOG_ERROR("Null matrix in row multiply");
         return 1;
@@ -83,16 +90,19 @@ int mtx_row_mult(matrix *mtx, size_t row, double factor) {
         MTX_LOG_ERROR("Invalid row index in multiply");
         return -1;
     }
+    if (mtx_unshare(mtx, 1) != 0) return -2;
     
     for (size_t j = 0; j < mtx->w; j++) {
         mtx->data[row * mtx->w + j] *= factor;
     }
 
     MTX_LOG("Row was multiplied");
+    MTX_METRIC_END(ROW_MULT, 2 * mtx->w * sizeof(double), mtx->w);
     return 0;
 }
 
 int mtx_row_div(matrix *mtx, size_t row, double divisor) {
+    MTX_METRIC_BEGIN(ROW_DIV);
     if (!mtx || !mtx->data) {
         MTX_LOG_ERROR("Null matrix in row division");
         return 1;
@@ -105,16 +115,19 @@ int mtx_row_div(matrix *mtx, size_t row, double divisor) {
         MTX_LOG_ERROR("Division by zero in row division");
         return -1;
     }
+    if (mtx_unshare(mtx, 1) != 0) return -2;
     
     for (size_t j = 0; j < mtx->w; j++) {
         mtx->data[row * mtx->w + j] /= divisor;
     }
 
     MTX_LOG("Row was divided");
+    MTX_METRIC_END(ROW_DIV, 2 * mtx->w * sizeof(double), mtx->w);
     return 0;
 }
 
 int mtx_row_add(matrix *mtx, size_t target_row, size_t source_row, double factor) {
+    MTX_METRIC_BEGIN(ROW_ADD);
     if (!mtx || !mtx->data) {
         MTX_LOG_ERROR("Null matrix in row addition");
         return 1;
@@ -123,6 +136,7 @@ int mtx_row_add(matrix *mtx, size_t target_row, size_t source_row, double factor
         MTX_LOG_ERROR("Invalid row indices in addition");
         return -1;
     }
+    if (mtx_unshare(mtx, 1) != 0) return -2;
     
     for (size_t j = 0; j < mtx->w; j++) {
         mtx->data[target_row * mtx->w + j] += 
@@ -130,26 +144,344 @@ int mtx_row_add(matrix *mtx, size_t target_row, size_t source_row, double factor
     }
 
     MTX_LOG("Rows were added");
+    MTX_METRIC_END(ROW_ADD, 3 * mtx->w * sizeof(double), 2 * mtx->w);
+    return 0;
+}
+
+/* ================== Reductions ================== */
+
+void mtx_set_reproducible(int on) {
+    mtx_context_set_reproducible(mtx_context_current(), on);
+}
+
+int mtx_get_reproducible(void) {
+    return mtx_context_current()->reproducible;
+}
+
+typedef enum {
+    MTX_RED_SUM,    // x[i]
+    MTX_RED_ABS,    // |x[i]|
+    MTX_RED_SQ,     // x[i]^2
+    MTX_RED_SSQ,    // (x[i] * scale)^2
+    MTX_RED_DOT     // x[i] * y[i]
+} mtx_reduce_kind;
+
+// Below this length pairwise recursion stops and eight independent
+// accumulators run over the block, which the compiler can vectorize
+#define MTX_PAIRWISE_BLOCK 128
+// Column sums split the rows into at most this many parts
+#define MTX_REDUCE_PARTS 64
+
+#define MTX_PAIRWISE_BASE(term) do { \
+        for (; i + 8 <= n; i += 8) { \
+            for (size_t r = 0; r < 8; r++) { const size_t k = i + r; acc[r] += (term); } \
+        } \
+        for (size_t k = i; k < n; k++) acc[k & 7] += (term); \
+    } while (0)
+
+static double mtx_pairwise(const double *x, const double *y, size_t n, mtx_reduce_kind kind, double scale) {
+    if (n > MTX_PAIRWISE_BLOCK) {
+        size_t half = (n / 2 + 7) & ~(size_t)7;
+        return mtx_pairwise(x, y, half, kind, scale)
+             + mtx_pairwise(x + half, y ? y + half : NULL, n - half, kind, scale);
+    }
+
+    double acc[8] = {0.0};
+    size_t i = 0;
+    switch (kind) {
+    case MTX_RED_SUM: MTX_PAIRWISE_BASE(x[k]); break;
+    case MTX_RED_ABS: MTX_PAIRWISE_BASE(fabs(x[k])); break;
+    case MTX_RED_SQ:  MTX_PAIRWISE_BASE(x[k] * x[k]); break;
+    case MTX_RED_SSQ: MTX_PAIRWISE_BASE((x[k] * scale) * (x[k] * scale)); break;
+    case MTX_RED_DOT: MTX_PAIRWISE_BASE(x[k] * y[k]); break;
+    }
+    return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+}
+
+/**
+ * @brief Neumaier step: adds v to the compensated sum (s, c)
+ */
+static inline void mtx_kahan_add(double *s, double *c, double v) {
+    double t = *s + v;
+    *c += fabs(*s) >= fabs(v) ? (*s - t) + v : (v - t) + *s;
+    *s = t;
+}
+
+/**
+ * @brief Reduces n elements in chunks of MTX_REDUCE_CHUNK, in parallel when there is more than one
+ * @return 0 on success, -2 if reproducible mode could not allocate its partials
+ */
+static int mtx_reduce(const double *x, const double *y, size_t n, mtx_reduce_kind kind, double scale, double *res) {
+    const size_t nchunks = (n + MTX_REDUCE_CHUNK - 1) / MTX_REDUCE_CHUNK;
+    if (nchunks <= 1) {
+        *res = mtx_pairwise(x, y, n, kind, scale);
+        return 0;
+    }
+
+    if (!mtx_context_current()->reproducible) {
+        double sum = 0.0;
+        #pragma omp parallel for schedule(static) reduction(+:sum)
+        for (size_t c = 0; c < nchunks; c++) {
+            const size_t off = c * MTX_REDUCE_CHUNK;
+            const size_t len = n - off < MTX_REDUCE_CHUNK ? n - off : MTX_REDUCE_CHUNK;
+            sum += mtx_pairwise(x + off, y ? y + off : NULL, len, kind, scale);
+        }
+        *res = sum;
+        return 0;
+    }
+
+    double *part = malloc(nchunks * sizeof(double));
+    if (!part) return -2;
+
+    #pragma omp parallel for schedule(static)
+    for (size_t c = 0; c < nchunks; c++) {
+        const size_t off = c * MTX_REDUCE_CHUNK;
+        const size_t len = n - off < MTX_REDUCE_CHUNK ? n - off : MTX_REDUCE_CHUNK;
+        part[c] = mtx_pairwise(x + off, y ? y + off : NULL, len, kind, scale);
+    }
+
+    double s = 0.0, comp = 0.0;
+    for (size_t c = 0; c < nchunks; c++) mtx_kahan_add(&s, &comp, part[c]);
+    free(part);
+    *res = s + comp;
+    return 0;
+}
+
+/**
+ * @brief Largest |x[i]| over n elements
+ */
+static double mtx_reduce_max(const double *x, size_t n) {
+    double m = 0.0;
+    #pragma omp parallel for schedule(static) reduction(max:m) if(n > MTX_REDUCE_CHUNK)
+    for (size_t i = 0; i < n; i++) {
+        const double v = fabs(x[i]);
+        if (v > m) m = v;
+    }
+    return m;
+}
+
+/**
+ * @brief Adds row[from..to) (or its absolute values) into the compensated sums (s, c)
+ */
+static inline void mtx_col_accum(double *restrict s, double *restrict c, const double *row,
+                                 size_t from, size_t to, int absval) {
+    if (absval) {
+        for (size_t j = from; j < to; j++) mtx_kahan_add(s + j, c + j, fabs(row[j]));
+    } else {
+        for (size_t j = from; j < to; j++) mtx_kahan_add(s + j, c + j, row[j]);
+    }
+}
+
+/**
+ * @brief Compensated column sums of a row-major panel (h x w)
+ * @param mu Subtracted from the diagonal before summing
+ * @param absval Nonzero to sum absolute values
+ * @return 0 on success, -2 if allocation failed
+ * @note The rows are split into a number of parts that depends only on the
+ * panel shape, and parts are merged in order, so the result does not
+ * depend on the thread count
+ */
+static int mtx_panel_col_sums(const double *p, size_t w, size_t h, double mu, int absval, double *out) {
+    size_t rows = MTX_REDUCE_CHUNK / w;
+    if (rows == 0) rows = 1;
+    size_t parts = (h + rows - 1) / rows;
+    if (parts > MTX_REDUCE_PARTS) parts = MTX_REDUCE_PARTS;
+    if (parts == 0) parts = 1;
+    rows = (h + parts - 1) / parts;
+
+    double *buf = calloc(2 * parts * w, sizeof(double));
+    if (!buf) return -2;
+
+    #pragma omp parallel for schedule(static) if(parts > 1)
+    for (size_t q = 0; q < parts; q++) {
+        double *restrict s = buf + 2 * w * q;
+        double *restrict c = s + w;
+        const size_t end = (q + 1) * rows < h ? (q + 1) * rows : h;
+        for (size_t i = q * rows; i < end; i++) {
+            const double *row = p + w * i;
+            const size_t d = mu != 0.0 && i < w ? i : w;
+            mtx_col_accum(s, c, row, 0, d, absval);
+            if (d < w) {
+                mtx_kahan_add(s + d, c + d, absval ? fabs(row[d] - mu) : row[d] - mu);
+                mtx_col_accum(s, c, row, d + 1, w, absval);
+            }
+        }
+    }
+
+    for (size_t j = 0; j < w; j++) {
+        double s = 0.0, c = 0.0;
+        for (size_t q = 0; q < parts; q++) {
+            mtx_kahan_add(&s, &c, buf[2 * w * q + j]);
+            c += buf[2 * w * q + w + j];
+        }
+        out[j] = s + c;
+    }
+    free(buf);
     return 0;
 }
 
+double mtx_panel_norm_inf(const double *p, size_t w, size_t h) {
+    double norm = 0.0;
+    #pragma omp parallel for schedule(static) reduction(max:norm) if(w * h > MTX_REDUCE_CHUNK)
+    for (size_t i = 0; i < h; i++) {
+        const double row_sum = mtx_pairwise(p + w * i, NULL, w, MTX_RED_ABS, 1.0);
+        if (row_sum > norm) norm = row_sum;
+    }
+    return norm;
+}
+
+double mtx_panel_norm1(const double *p, size_t w, size_t h, double mu) {
+    double *col = malloc(w * sizeof(double));
+    if (!col || mtx_panel_col_sums(p, w, h, mu, 1, col) != 0) {
+        free(col);
+        return -1.0;
+    }
+
+    double norm = 0.0;
+    for (size_t j = 0; j < w; j++) {
+        if (col[j] > norm) norm = col[j];
+    }
+    free(col);
+    return norm;
+}
+
 double mtx_norm(const matrix *mtx) {
+    MTX_METRIC_BEGIN(NORM);
     if (!mtx || !mtx->data) {
         MTX_LOG_ERROR("Null matrix in norm calculation");
         return -1.0;
     }
     
-    double max_norm = 0.0;
-    for (size_t i = 0; i < mtx->h; i++) {
-        double row_sum = 0.0;
-        for (size_t j = 0; j < mtx->w; j++) {
-            row_sum += fabs(mtx->data[i * mtx->w + j]);
-        }
-        if (row_sum > max_norm) {
-            max_norm = row_sum;
-        }
-    }
+    double max_norm = mtx_panel_norm_inf(mtx->data, mtx->w, mtx->h);
 
     MTX_LOG("Matrix norm calculated");
+    MTX_METRIC_END(NORM, mtx->w * mtx->h * sizeof(double), mtx->w * mtx->h);
     return max_norm;
-}
\ No newline at end of file
+}
+
+double mtx_norm1(const matrix *mtx) {
+    MTX_METRIC_BEGIN(NORM1);
+    if (!mtx || !mtx->data) {
+        MTX_LOG_ERROR("Null matrix in 1-norm calculation");
+        return -1.0;
+    }
+
+    double norm = mtx_panel_norm1(mtx->data, mtx->w, mtx->h, 0.0);
+    if (norm < 0.0) {
+        MTX_LOG_ERROR("Allocation in 1-norm calculation failed");
+        return -1.0;
+    }
+
+    MTX_LOG("Matrix 1-norm calculated");
+    MTX_METRIC_END(NORM1, mtx->w * mtx->h * sizeof(double), mtx->w * mtx->h);
+    return norm;
+}
+
+double mtx_norm_fro(const matrix *mtx) {
+    MTX_METRIC_BEGIN(NORM_FRO);
+    if (!mtx || !mtx->data) {
+        MTX_LOG_ERROR("Null matrix in Frobenius norm calculation");
+        return -1.0;
+    }
+
+    const size_t n = mtx->w * mtx->h;
+    double ssq;
+    if (mtx_reduce(mtx->data, NULL, n, MTX_RED_SQ, 1.0, &ssq) != 0) {
+        MTX_LOG_ERROR("Allocation in Frobenius norm calculation failed");
+        return -1.0;
+    }
+    double norm = sqrt(ssq);
+
+    // Squares left the representable range: redo the sum relative to the largest element
+    if (isinf(ssq) || ssq < DBL_MIN / DBL_EPSILON) {
+        const double big = mtx_reduce_max(mtx->data, n);
+        if (big == 0.0 || isinf(big)) {
+            norm = big;
+        } else if (mtx_reduce(mtx->data, NULL, n, MTX_RED_SSQ, 1.0 / big, &ssq) != 0) {
+            MTX_LOG_ERROR("Allocation in Frobenius norm calculation failed");
+            return -1.0;
+        } else {
+            norm = big * sqrt(ssq);
+        }
+    }
+
+    MTX_LOG("Matrix Frobenius norm calculated");
+    MTX_METRIC_END(NORM_FRO, n * sizeof(double), 2 * n);
+    return norm;
+}
+
+double mtx_norm_max(const matrix *mtx) {
+    MTX_METRIC_BEGIN(NORM_MAX);
+    if (!mtx || !mtx->data) {
+        MTX_LOG_ERROR("Null matrix in max norm calculation");
+        return -1.0;
+    }
+
+    double norm = mtx_reduce_max(mtx->data, mtx->w * mtx->h);
+
+    MTX_LOG("Matrix max norm calculated");
+    MTX_METRIC_END(NORM_MAX, mtx->w * mtx->h * sizeof(double), mtx->w * mtx->h);
+    return norm;
+}
+
+int mtx_trace(const matrix *mtx, double *res) {
+    MTX_METRIC_BEGIN(TRACE);
+    if (!mtx || !mtx->data || !res) {
+        MTX_LOG_ERROR("Null pointer in trace calculation");
+        return 1;
+    }
+    if (mtx->w != mtx->h) {
+        MTX_LOG_ERROR("Non-square matrix in trace calculation");
+        return -1;
+    }
+
+    double s = 0.0, c = 0.0;
+    for (size_t i = 0; i < mtx->h; i++) {
+        mtx_kahan_add(&s, &c, *mtx_cat(mtx, i, i));
+    }
+    *res = s + c;
+
+    MTX_LOG("Matrix trace calculated");
+    MTX_METRIC_END(TRACE, mtx->h * sizeof(double), mtx->h);
+    return 0;
+}
+
+int mtx_dot(const matrix *A, const matrix *B, double *res) {
+    MTX_METRIC_BEGIN(DOT);
+    if (!A || !A->data || !B || !B->data || !res) {
+        MTX_LOG_ERROR("Null pointer in inner product");
+        return 1;
+    }
+    const int vectors = (A->w == 1 || A->h == 1) && (B->w == 1 || B->h == 1);
+    if (A->w * A->h != B->w * B->h || (!vectors && A->w != B->w)) {
+        MTX_LOG_ERROR("Size mismatch in inner product");
+        return -1;
+    }
+
+    const size_t n = A->w * A->h;
+    if (mtx_reduce(A->data, B->data, n, MTX_RED_DOT, 1.0, res) != 0) {
+        MTX_LOG_ERROR("Allocation in inner product failed");
+        return -2;
+    }
+
+    MTX_LOG("Inner product calculated");
+    MTX_METRIC_END(DOT, 2 * n * sizeof(double), 2 * n);
+    return 0;
+}
+
+int mtx_col_sums(const matrix *mtx, double *out) {
+    MTX_METRIC_BEGIN(COL_SUMS);
+    if (!mtx || !mtx->data || !out) {
+        MTX_LOG_ERROR("Null pointer in column sums");
+        return 1;
+    }
+
+    if (mtx_panel_col_sums(mtx->data, mtx->w, mtx->h, 0.0, 0, out) != 0) {
+        MTX_LOG_ERROR("Allocation in column sums failed");
+        return -2;
+    }
+
+    MTX_LOG("Column sums calculated");
+    MTX_METRIC_END(COL_SUMS, mtx->w * (mtx->h + 1) * sizeof(double), mtx->w * mtx->h);
+    return 0;
+}
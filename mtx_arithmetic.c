@@ -1,16 +1,17 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "mtx_arithmetic.h"
+#include "mtx_tune.h"
 #include "mtx_logs.h"
-
-struct matrix
-{
-    double *data; // data + w * i + j
-    size_t w, h;    
-};
+#include "mtx_metrics.h"
+#include "mtx_internal.h"
 
 int mtx_add(matrix *mtx1, const matrix *mtx2) {
+    MTX_METRIC_BEGIN(ADD);
     if (!mtx1 || !mtx2 || !mtx1->data || !mtx2->data) {
         MTX_LOG_ERROR("Null matrix pointer in addition");
         return 1;
@@ -19,15 +20,18 @@ int mtx_add(matrix *mtx1, const matrix *mtx2) {
         MTX_LOG_ERROR("Matrix size mismatch in addition");
         return -1;
     }
+    if (mtx_unshare(mtx1, 1) != 0) return -2;
 
     for (size_t i = 0; i < mtx1->h * mtx1->w; i++) {
         mtx1->data[i] += mtx2->data[i];
     }
     MTX_LOG("Matrix addition completed");
+    MTX_METRIC_END(ADD, 3 * mtx1->w * mtx1->h * sizeof(double), mtx1->w * mtx1->h);
     return 0;
 }
 
 int mtx_sub(matrix *mtx1, const matrix *mtx2) {
+    MTX_METRIC_BEGIN(SUB);
     if (!mtx1 || !mtx2 || !mtx1->data || !mtx2->data) {
         MTX_LOG_ERROR("Null matrix pointer in subtraction");
         return 1;
@@ -36,24 +40,29 @@ int mtx_sub(matrix *mtx1, const matrix *mtx2) {
         MTX_LOG_ERROR("Matrix size mismatch in subtraction");
         return -1;
     }
+    if (mtx_unshare(mtx1, 1) != 0) return -2;
 
     for (size_t i = 0; i < mtx1->h * mtx1->w; i++) {
         mtx1->data[i] -= mtx2->data[i];
     }
     MTX_LOG("Matrix subtraction completed");
+    MTX_METRIC_END(SUB, 3 * mtx1->w * mtx1->h * sizeof(double), mtx1->w * mtx1->h);
     return 0;
 }
 
 void mtx_smul(matrix *mtx, double d) {
+    MTX_METRIC_BEGIN(SMUL);
     if (!mtx || !mtx->data) {
         MTX_LOG_ERROR("Null matrix in scalar multiplication");
         return;
     }
+    if (mtx_unshare(mtx, 1) != 0) return;
     
     for (size_t i = 0; i < mtx->h * mtx->w; i++) {
         mtx->data[i] *= d;
     }
     MTX_LOG("Matrix scalar multiplication completed");
+    MTX_METRIC_END(SMUL, 2 * mtx->w * mtx->h * sizeof(double), mtx->w * mtx->h);
 }
 
 int mtx_sdiv(matrix *mtx, double d) {
@@ -73,6 +82,7 @@ int mtx_sdiv(matrix *mtx, double d) {
 }
 
 int mtx_add2(matrix *mtx, const matrix *mtx1, const matrix *mtx2) {
+    MTX_METRIC_BEGIN(ADD2);
     if (!mtx || !mtx1 || !mtx2 || !mtx->data || !mtx1->data || !mtx2->data) {
         MTX_LOG_ERROR("Null matrix pointer in add2 operation");
         return 1;
@@ -85,15 +95,18 @@ int mtx_add2(matrix *mtx, const matrix *mtx1, const matrix *mtx2) {
         MTX_LOG_ERROR("Destination matrix size mismatch in add2");
         return -1;
     }
+    if (mtx_unshare(mtx, 1) != 0) return -2;
 
     for (size_t i = 0; i < mtx->h * mtx->w; i++) {
         mtx->data[i] = mtx1->data[i] + mtx2->data[i];
     }
     MTX_LOG("Matrix add2 operation completed");
+    MTX_METRIC_END(ADD2, 3 * mtx->w * mtx->h * sizeof(double), mtx->w * mtx->h);
     return 0;
 }
 
 int mtx_sub2(matrix *mtx, const matrix *mtx1, const matrix *mtx2) {
+    MTX_METRIC_BEGIN(SUB2);
     if (!mtx || !mtx1 || !mtx2 || !mtx->data || !mtx1->data || !mtx2->data) {
         MTX_LOG_ERROR("Null matrix pointer in sub2 operation");
         return 1;
@@ -106,15 +119,18 @@ int mtx_sub2(matrix *mtx, const matrix *mtx1, const matrix *mtx2) {
         MTX_LOG_ERROR("Destination matrix size mismatch in sub2");
         return -1;
     }
+    if (mtx_unshare(mtx, 1) != 0) return -2;
 
     for (size_t i = 0; i < mtx->h * mtx->w; i++) {
         mtx->data[i] = mtx1->data[i] - mtx2->data[i];
     }
     MTX_LOG("Matrix sub2 operation completed");
+    MTX_METRIC_END(SUB2, 3 * mtx->w * mtx->h * sizeof(double), mtx->w * mtx->h);
     return 0;
 }
 
 int mtx_smul2(matrix *mtx, const matrix *mtx1, double d) {
+    MTX_METRIC_BEGIN(SMUL2);
     if (!mtx || !mtx1 || !mtx->data || !mtx1->data) {
         MTX_LOG_ERROR("Null matrix pointer in smul2 operation");
         return 1;
@@ -123,11 +139,13 @@ int mtx_smul2(matrix *mtx, const matrix *mtx1, double d) {
         MTX_LOG_ERROR("Matrix size mismatch in smul2");
         return -1;
     }
+    if (mtx_unshare(mtx, 1) != 0) return -2;
 
     for (size_t i = 0; i < mtx->h * mtx->w; i++) {
         mtx->data[i] = mtx1->data[i] * d;
     }
     MTX_LOG("Matrix smul2 operation completed");
+    MTX_METRIC_END(SMUL2, 2 * mtx->w * mtx->h * sizeof(double), mtx->w * mtx->h);
     return 0;
 }
 
@@ -145,33 +163,53 @@ int mtx_sdiv2(matrix *mtx, const matrix *mtx1, double d) {
         return -1;
     }
 
-    mtx_smul2(mtx, mtx1, 1.0/d);
+    int rc = mtx_smul2(mtx, mtx1, 1.0/d);
+    if (rc != 0) return rc;
 
     MTX_LOG("Matrix sdiv2 operation completed");
     return 0;
 }
 
 /**
- * @brief unsafe function for block matrix calculations
- * Cant be used outside
+ * @brief dest = alpha * (P * mtx1) * mtx2 + beta * dest, blocked; beta == 0 ignores the old dest
+ * @note Each thread scales its own dest row block before accumulating into
+ * it, so the sum needs no temporary. dest must not alias either operand.
  */
-void mtx_block_mul(matrix *dest, const matrix *mtx1, const matrix *mtx2){
-    for(size_t ii = 0; ii < mtx1->h; ii += MTX_BLOCK_SIZE){
-        size_t i_end = ii+MTX_BLOCK_SIZE > mtx1->h ? mtx1->h : ii+MTX_BLOCK_SIZE;
+static void mtx_block_gemm_rows(matrix *dest, double alpha, const matrix *mtx1, const size_t *rows,
+                                const matrix *mtx2, double beta) {
+    const size_t h = mtx1->h, n = mtx1->w, w = mtx2->w;
+    const mtx_tune_params *tp = mtx_tune_get();
+    const size_t bi = tp->block_i, bk = tp->block_k, bj = tp->block_j;
+
+    // Row blocks are split statically, like first-touch placement, so each thread
+    // clears and writes the dest rows on its own node
+    #pragma omp parallel for schedule(static)
+    for(size_t ii = 0; ii < h; ii += bi){
+        size_t i_end = ii+bi > h ? h : ii+bi;
+
+        if (beta == 0.0) {
+            memset(mtx_row(dest, ii), 0, (i_end - ii) * w * sizeof(double));
+        } else if (beta != 1.0) {
+            double *d = mtx_row(dest, ii);
+            for (size_t j = 0; j < (i_end - ii) * w; j++) d[j] *= beta;
+        }
+
+        for(size_t kk = 0; kk < n; kk += bk){
+            size_t k_end = kk+bk > n ? n : kk+bk;
 
-        for(size_t jj = 0; jj < mtx2->w; jj += MTX_BLOCK_SIZE){
-            size_t j_end = jj+MTX_BLOCK_SIZE > mtx2->w ? mtx2->w : jj+MTX_BLOCK_SIZE;
+            for(size_t jj = 0; jj < w; jj += bj){
+                size_t j_end = jj+bj > w ? w : jj+bj;
 
-            for(size_t kk = 0; kk < mtx1->w; kk += MTX_BLOCK_SIZE){
-                size_t k_end = kk+MTX_BLOCK_SIZE > mtx2->w ? mtx2->w : kk+MTX_BLOCK_SIZE;
+                for(size_t i = ii; i < i_end; ++i) {
+                    double *restrict d = mtx_row(dest, i);
+                    const double *a = mtx_crow(mtx1, rows ? rows[i] : i);
 
-                for(size_t i = 0; i < i_end; ++i) {
-                    for(size_t j = 0; j < j_end; ++j) {
-                        double sum = 0;
-                        for(size_t k = 0; k < k_end; ++k) {
-                            sum += (*mtx_cptr(mtx1, i, k)) * (*mtx_cptr(mtx2, k, j));
+                    for(size_t k = kk; k < k_end; ++k) {
+                        const double aik = alpha * a[k];
+                        const double *restrict b = mtx_crow(mtx2, k);
+                        for(size_t j = jj; j < j_end; ++j) {
+                            d[j] += aik * b[j];
                         }
-                        *mtx_ptr((matrix*)dest, i, j) = sum;
                     }
                 }
             }
@@ -179,73 +217,399 @@ void mtx_block_mul(matrix *dest, const matrix *mtx1, const matrix *mtx2){
     }
 }
 
+/**
+ * @brief unsafe function for block matrix calculations
+ * Cant be used outside (declared in mtx_internal.h)
+ */
+void mtx_block_mul_rows(matrix *dest, const matrix *mtx1, const size_t *rows, const matrix *mtx2){
+    MTX_METRIC_BEGIN(BLOCK_MUL);
+    const size_t h = mtx1->h, n = mtx1->w, w = mtx2->w;
+    mtx_block_gemm_rows(dest, 1.0, mtx1, rows, mtx2, 0.0);
+    MTX_METRIC_END(BLOCK_MUL, MTX_MUL_BYTES(h, n, w), MTX_MUL_FLOPS(h, n, w));
+}
+
+void mtx_block_mul(matrix *dest, const matrix *mtx1, const matrix *mtx2){
+    mtx_block_mul_rows(dest, mtx1, NULL, mtx2);
+}
+
+void mtx_gemv_rows(double *restrict y, const matrix *mtx, const size_t *rows, const double *restrict x) {
+    const size_t h = mtx->h, n = mtx->w;
+
+    #pragma omp parallel for schedule(static) if(h * n > mtx_tune_get()->par_min)
+    for (size_t i = 0; i < h; i++) {
+        const double *restrict a = mtx_crow(mtx, rows ? rows[i] : i);
+        double sum = 0.0;
+        #pragma omp simd reduction(+:sum)
+        for (size_t k = 0; k < n; k++) {
+            sum += a[k] * x[k];
+        }
+        y[i] = sum;
+    }
+}
+
+// One output row of a product with a W-column right operand: the W sums stay
+// in registers while the row of A streams past
+#define MTX_SKINNY_ROW(W) \
+    static void mtx_skinny_row_##W(double *restrict d, const double *restrict a, \
+                                   const double *restrict b, size_t n) { \
+        double acc[W] = {0.0}; \
+        for (size_t k = 0; k < n; k++) { \
+            const double ak = a[k]; \
+            const double *restrict bk = b + W * k; \
+            for (size_t j = 0; j < W; j++) acc[j] += ak * bk[j]; \
+        } \
+        for (size_t j = 0; j < W; j++) d[j] = acc[j]; \
+    }
+
+MTX_SKINNY_ROW(2)
+MTX_SKINNY_ROW(3)
+MTX_SKINNY_ROW(4)
+MTX_SKINNY_ROW(5)
+MTX_SKINNY_ROW(6)
+MTX_SKINNY_ROW(7)
+MTX_SKINNY_ROW(8)
+
+#undef MTX_SKINNY_ROW
+
+static void (*const mtx_skinny_rows[MTX_SKINNY_WIDTH + 1])(double *restrict, const double *restrict,
+                                                           const double *restrict, size_t) = {
+    NULL, NULL, mtx_skinny_row_2, mtx_skinny_row_3, mtx_skinny_row_4,
+    mtx_skinny_row_5, mtx_skinny_row_6, mtx_skinny_row_7, mtx_skinny_row_8
+};
+
+void mtx_skinny_mul_rows(matrix *dest, const matrix *mtx1, const size_t *rows, const matrix *mtx2) {
+    const size_t h = mtx1->h, n = mtx1->w, w = mtx2->w;
+    void (*row_fn)(double *restrict, const double *restrict, const double *restrict, size_t) = mtx_skinny_rows[w];
+
+    #pragma omp parallel for schedule(static) if(h * n * w > mtx_tune_get()->par_min)
+    for (size_t i = 0; i < h; i++) {
+        row_fn(mtx_row(dest, i), mtx_crow(mtx1, rows ? rows[i] : i), mtx2->data, n);
+    }
+}
+
+void mtx_mul_kernel_rows(matrix *dest, const matrix *mtx1, const size_t *rows, const matrix *mtx2) {
+    if (mtx2->w == 1) {
+        mtx_gemv_rows(dest->data, mtx1, rows, mtx2->data);
+    } else if (mtx2->w <= mtx_tune_get()->skinny_width) {
+        mtx_skinny_mul_rows(dest, mtx1, rows, mtx2);
+    } else {
+        mtx_block_mul_rows(dest, mtx1, rows, mtx2);
+    }
+}
+
+void mtx_mul_kernel(matrix *dest, const matrix *mtx1, const matrix *mtx2) {
+    mtx_mul_kernel_rows(dest, mtx1, NULL, mtx2);
+}
+
+int mtx_gemv(double *y, const matrix *mtx, const double *x) {
+    MTX_METRIC_BEGIN(GEMV);
+    if (!y || !x || !mtx || !mtx->data) {
+        MTX_LOG_ERROR("Null pointer in gemv");
+        return 1;
+    }
+
+    mtx_gemv_rows(y, mtx, NULL, x);
+
+    MTX_LOG("Matrix-vector product completed");
+    MTX_METRIC_END(GEMV, MTX_MUL_BYTES(mtx->h, mtx->w, 1), MTX_MUL_FLOPS(mtx->h, mtx->w, 1));
+    return 0;
+}
+
+/**
+ * @brief mtx1 := mtx1 * mtx2 one row panel at a time, mtx2 distinct from mtx1
+ * @return 0 on success, -2 if allocation failed (mtx1 unchanged)
+ * @note Row i of the product depends only on row i of mtx1, so each panel is
+ * computed into thread-local scratch and copied over its own rows. When the
+ * rows get narrower the panels go top-down, when they get wider the storage
+ * is grown first and the panels go bottom-up; either way a panel only lands
+ * on rows that were already consumed.
+ */
+static int mtx_mul_panels(matrix *mtx1, const matrix *mtx2) {
+    const size_t h = mtx1->h, n = mtx1->w, w = mtx2->w;
+#ifdef _OPENMP
+    const size_t rows = mtx_tune_get()->block_i * (size_t)omp_get_max_threads();
+#else
+    const size_t rows = mtx_tune_get()->block_i;
+#endif
+    const size_t panels = (h + rows - 1) / rows;
+
+    double *buf = mtx_scratch((rows < h ? rows : h) * w);
+    if (!buf) return -2;
+    if (w > n && mtx_reserve_data(mtx1, h * w) != 0) return -2;
+
+    for (size_t p = 0; p < panels; p++) {
+        const size_t q = w > n ? panels - 1 - p : p;
+        const size_t i0 = q * rows;
+        const size_t r = h - i0 < rows ? h - i0 : rows;
+
+        const matrix src = {.data = mtx1->data + i0 * n, .w = n, .h = r, .map_len = 0};
+        matrix dst = {.data = buf, .w = w, .h = r, .map_len = 0};
+        mtx_mul_kernel(&dst, &src, mtx2);
+        memcpy(mtx1->data + i0 * w, buf, r * w * sizeof(double));
+    }
+
+    if (w < n) mtx_reserve_data(mtx1, h * w);
+    mtx1->w = w;
+    return 0;
+}
+
 int mtx_mul(matrix *mtx1, const matrix *mtx2) {
+    MTX_METRIC_BEGIN(MUL);
     if(!mtx1 || !mtx1->data || !mtx2 || !mtx2->data) {
         MTX_LOG_ERROR("Null matrix pointer in mul operation");
-        return -1;
+        return 1;
     }
 
     if(mtx1->w != mtx2->h) {
         MTX_LOG_ERROR("Matrix size mismatch for multiplication");
-        return -2;
+        return -1;
     }
+    if (mtx_unshare(mtx1, 1) != 0) return -2;
 
-    matrix *temp = mtx_alloc(mtx2->w, mtx1->h);
-    if(!temp) {
+    const size_t h = mtx1->h, n = mtx1->w;
+    if(mtx1 == mtx2) {
+        // Squaring reads every row of the operand for every output row
+        double *copy = mtx_scratch(n * n);
+        if(!copy) {
+            MTX_LOG_ERROR("Allocation in mul failed");
+            return -2;
+        }
+        memcpy(copy, mtx1->data, n * n * sizeof(double));
+        const matrix a = {.data = copy, .w = n, .h = n, .map_len = 0};
+        mtx_mul_kernel(mtx1, &a, &a);
+    } else if(mtx_mul_panels(mtx1, mtx2) != 0) {
         MTX_LOG_ERROR("Allocation in mul failed");
-        return -3;
+        return -2;
     }
 
-    mtx_block_mul(temp, mtx1, mtx2);
-    
-    if(mtx_assign(mtx1, temp) != 0) {
-        mtx_free(temp);
-        return -4;
-    }
-    
-    mtx_free(temp);
+    MTX_METRIC_END(MUL, MTX_MUL_BYTES(h, n, mtx2->w), MTX_MUL_FLOPS(h, n, mtx2->w));
     return 0;
 }
 
 
 int mtx_mul2 (matrix *mtx, const matrix *mtx1, const matrix *mtx2){
+    MTX_METRIC_BEGIN(MUL2);
     if(!mtx1 || !mtx1->data || !mtx2 || !mtx2->data || !mtx || !mtx->data){
         MTX_LOG_ERROR("Null matrix pointer in mul2 operation");
         return 1;
     }
 
-    if(mtx1->w != mtx2->h || mtx->w != mtx1->w || mtx->h != mtx2->h){
+    if(mtx1->w != mtx2->h){
         MTX_LOG_ERROR("Incompatible matrix sizes for mul2");
         return -1;
     }
 
+    if(mtx->w != mtx2->w || mtx->h != mtx1->h) {
+        MTX_LOG_ERROR("Result matrix has wrong dimensions");
+        return -1;
+    }
+    if (mtx_unshare(mtx, 1) != 0) return -2;
 
-    matrix *temp = NULL;
-    matrix *result = NULL;
-
-    if(mtx == mtx1 || mtx == mtx2) {
-        temp = mtx_alloc(mtx2->w, mtx1->h);
-        if(!temp) {
+    if(mtx == mtx1 && mtx != mtx2) {
+        // mtx2 is square here, so the product fits the rows it replaces
+        if(mtx_mul_panels(mtx, mtx2) != 0) {
             MTX_LOG_ERROR("Allocation for temp matrix failed");
-            return -1;
+            return -2;
         }
-        result = temp;
-    } 
-    else {
-        if(mtx->w != mtx2->w || mtx->h != mtx1->h) {
-            MTX_LOG_ERROR("Result matrix has wrong dimensions");
-            return -1;
+    } else if(mtx == mtx1 || mtx == mtx2) {
+        // The result overwrites an operand read by every output row: snapshot it
+        const size_t len = mtx->w * mtx->h;
+        double *copy = mtx_scratch(len);
+        if(!copy) {
+            MTX_LOG_ERROR("Allocation for temp matrix failed");
+            return -2;
         }
-        result = mtx;
+        memcpy(copy, mtx->data, len * sizeof(double));
+        const matrix snap = {.data = copy, .w = mtx->w, .h = mtx->h, .map_len = 0};
+        mtx_mul_kernel(mtx, mtx == mtx1 ? &snap : mtx1, &snap);
+    } else {
+        mtx_mul_kernel(mtx,mtx1,mtx2);
     }
 
-    mtx_block_mul(result,mtx1,mtx2);
+    MTX_METRIC_END(MUL2, MTX_MUL_BYTES(mtx1->h, mtx1->w, mtx2->w), MTX_MUL_FLOPS(mtx1->h, mtx1->w, mtx2->w));
+    return 0;
+}
+
+int mtx_gemm(matrix *C, double alpha, const matrix *A, const matrix *B, double beta) {
+    MTX_METRIC_BEGIN(GEMM);
+    if (!C || !C->data || !A || !A->data || !B || !B->data) {
+        MTX_LOG_ERROR("Null matrix pointer in gemm");
+        return 1;
+    }
+    if (A->w != B->h || C->h != A->h || C->w != B->w) {
+        MTX_LOG_ERROR("Matrix size mismatch in gemm");
+        return -1;
+    }
+    if (mtx_unshare(C, beta != 0.0 || C == A || C == B) != 0) return -2;
 
-    if(temp){
-        mtx_free(mtx);
-        mtx = mtx_copy(temp);
-        mtx_free(temp);
+    const size_t h = A->h, n = A->w, w = B->w;
+    if (C == A || C == B) {
+        // The operand is read by every output row while C is being written: snapshot it
+        double *copy = mtx_scratch(h * w);
+        if (!copy) {
+            MTX_LOG_ERROR("Allocation in gemm failed");
+            return -2;
+        }
+        memcpy(copy, C->data, h * w * sizeof(double));
+        const matrix snap = {.data = copy, .w = w, .h = h, .map_len = 0};
+        mtx_block_gemm_rows(C, alpha, C == A ? &snap : A, NULL, C == B ? &snap : B, beta);
+    } else if (alpha == 1.0 && beta == 0.0) {
+        mtx_mul_kernel(C, A, B);
+    } else {
+        mtx_block_gemm_rows(C, alpha, A, NULL, B, beta);
     }
 
+    MTX_LOG("Matrix gemm completed");
+    MTX_METRIC_END(GEMM, MTX_MUL_BYTES(h, n, w) + h * w * sizeof(double), MTX_MUL_FLOPS(h, n, w) + 2 * h * w);
     return 0;
-}
\ No newline at end of file
+}
+
+matrix *mtx_pow(const matrix *mtx, unsigned int k) {
+    MTX_METRIC_BEGIN(POW);
+    if (!mtx || !mtx->data) {
+        MTX_LOG_ERROR("Null matrix pointer in pow operation");
+        return NULL;
+    }
+    if (mtx->w != mtx->h) {
+        MTX_LOG_ERROR("Non-square matrix in pow operation");
+        return NULL;
+    }
+
+    matrix *res = mtx_alloc_id(mtx->w, mtx->h);
+    if (!res) {
+        MTX_LOG_ERROR("Allocation in pow failed");
+        return NULL;
+    }
+    if (k == 0) {
+        return res;
+    }
+
+    matrix *base = mtx_copy(mtx);
+    matrix *temp = mtx_alloc(mtx->w, mtx->h);
+    if (!base || !temp) {
+        MTX_LOG_ERROR("Allocation in pow failed");
+        if (base) mtx_free(base);
+        if (temp) mtx_free(temp);
+        mtx_free(res);
+        return NULL;
+    }
+
+    int res_is_id = 1;
+    size_t products = 0;
+    matrix *swap;
+    while (k) {
+        if (k & 1u) {
+            if (res_is_id) {
+                mtx_assign(res, base);
+                res_is_id = 0;
+            } else {
+                mtx_block_mul(temp, res, base);
+                swap = res; res = temp; temp = swap;
+                products++;
+            }
+        }
+        k >>= 1;
+        if (k) {
+            mtx_block_mul(temp, base, base);
+            swap = base; base = temp; temp = swap;
+            products++;
+        }
+    }
+
+    mtx_free(base);
+    mtx_free(temp);
+    MTX_LOG("Matrix power calculated");
+    MTX_METRIC_END(POW, products * MTX_MUL_BYTES(mtx->w, mtx->w, mtx->w), products * MTX_MUL_FLOPS(mtx->w, mtx->w, mtx->w));
+    return res;
+}
+
+/**
+ * @brief Adds one Paterson-Stockmeyer group: res += sum_j coef[j] * pows[j], j < cnt
+ * pows[0] is the identity and is never read.
+ */
+static void mtx_poly_add_group(matrix *res, const matrix **pows, const double *coef, size_t cnt) {
+    const size_t n = res->w;
+
+    for (size_t i = 0; i < n; i++) {
+        res->data[n * i + i] += coef[0];
+    }
+    for (size_t j = 1; j < cnt; j++) {
+        if (coef[j] == 0.0) continue;
+        for (size_t i = 0; i < n * n; i++) {
+            res->data[i] += coef[j] * pows[j]->data[i];
+        }
+    }
+}
+
+matrix *mtx_polyval(const matrix *mtx, const double *coef, size_t deg) {
+    MTX_METRIC_BEGIN(POLYVAL);
+    if (!mtx || !mtx->data || !coef) {
+        MTX_LOG_ERROR("Null pointer in polyval operation");
+        return NULL;
+    }
+    if (mtx->w != mtx->h) {
+        MTX_LOG_ERROR("Non-square matrix in polyval operation");
+        return NULL;
+    }
+
+    const size_t n = mtx->w;
+    matrix *res = mtx_alloc_zero(n, n);
+    if (!res) {
+        MTX_LOG_ERROR("Allocation in polyval failed");
+        return NULL;
+    }
+    if (deg == 0) {
+        mtx_poly_add_group(res, NULL, coef, 1);
+        return res;
+    }
+
+    // s = ceil(sqrt(deg + 1)) powers, r = ceil((deg + 1) / s) Horner steps in mtx^s
+    const size_t s = (size_t)ceil(sqrt((double)(deg + 1)));
+    const size_t r = (deg + s) / s;
+
+    const matrix **pows = calloc(s + 1, sizeof(matrix*));
+    matrix *temp = mtx_alloc(n, n);
+    int failed = !pows || !temp;
+    if (!failed) {
+        pows[1] = mtx;
+        for (size_t j = 2; j <= s && !failed; j++) {
+            matrix *p = mtx_alloc(n, n);
+            if (!p) {
+                failed = 1;
+                break;
+            }
+            mtx_block_mul(p, pows[j - 1], mtx);
+            pows[j] = p;
+        }
+    }
+
+    if (!failed) {
+        size_t last = (r - 1) * s;
+        mtx_poly_add_group(res, pows, coef + last, deg + 1 - last);
+
+        for (size_t q = r - 1; q-- > 0;) {
+            mtx_block_mul(temp, res, pows[s]);
+            matrix *swap = res; res = temp; temp = swap;
+            mtx_poly_add_group(res, pows, coef + q * s, s);
+        }
+    } else {
+        MTX_LOG_ERROR("Allocation in polyval failed");
+        mtx_free(res);
+        res = NULL;
+    }
+
+    if (pows) {
+        for (size_t j = 2; j <= s; j++) {
+            if (pows[j]) mtx_free((matrix*)pows[j]);
+        }
+        free(pows);
+    }
+    if (temp) mtx_free(temp);
+
+    if (res) {
+        const size_t products = s - 1 + r - 1;
+        MTX_LOG("Matrix polynomial calculated");
+        MTX_METRIC_END(POLYVAL, products * MTX_MUL_BYTES(n, n, n), products * MTX_MUL_FLOPS(n, n, n));
+    }
+    return res;
+}
@@ -0,0 +1,381 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "mtx_async.h"
+#include "mtx_actions.h"
+#include "mtx_context.h"
+#include "mtx_logs.h"
+
+struct mtx_task
+{
+    mtx_task_fn fn;
+    void *arg;
+    int own_arg;                // free arg after the body ran
+    mtx_context *ctx;           // context of the submitting thread, bound while the body runs
+
+    atomic_int refs;            // user handle + scheduler
+    size_t pending;             // unfinished dependencies
+    int failed;                 // a dependency failed
+    int done;
+    int status;
+    mtx_error err;              // error recorded by a failed body on its worker
+
+    mtx_task **dependents;      // tasks waiting for this one
+    size_t ndependents, cap;
+    mtx_task *next;             // ready queue link
+};
+
+/**
+ * @brief Worker pool; all task bookkeeping is done under lock
+ */
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t work;        // ready queue became non-empty or stop
+    pthread_cond_t finished;    // some task finished
+    pthread_t *threads;
+    size_t nthreads;
+    int running, stop;
+    mtx_task *head, *tail;      // FIFO ready queue
+} mtx_pool = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER,
+              NULL, 0, 0, 0, NULL, NULL};
+
+static void mtx_task_unref(mtx_task *t) {
+    if (atomic_fetch_sub_explicit(&t->refs, 1, memory_order_acq_rel) == 1) {
+        free(t->dependents);
+        free(t);
+    }
+}
+
+/**
+ * @brief Appends a task to the ready queue (lock held)
+ */
+static void mtx_pool_push(mtx_task *t) {
+    t->next = NULL;
+    if (mtx_pool.tail) mtx_pool.tail->next = t;
+    else mtx_pool.head = t;
+    mtx_pool.tail = t;
+    pthread_cond_signal(&mtx_pool.work);
+}
+
+static void *mtx_pool_worker(void *unused) {
+    (void)unused;
+    pthread_mutex_lock(&mtx_pool.lock);
+    for (;;) {
+        while (!mtx_pool.head && !mtx_pool.stop) {
+            pthread_cond_wait(&mtx_pool.work, &mtx_pool.lock);
+        }
+        if (!mtx_pool.head) break;
+
+        mtx_task *t = mtx_pool.head;
+        mtx_pool.head = t->next;
+        if (!mtx_pool.head) mtx_pool.tail = NULL;
+        pthread_mutex_unlock(&mtx_pool.lock);
+
+        int status = MTX_ASYNC_CANCELED;
+        if (!t->failed) {
+            mtx_context *prev = mtx_context_bind(t->ctx);
+            mtx_clear_error();
+            status = t->fn(t->arg);
+            if (status != 0) t->err = *mtx_last_error();
+            mtx_context_bind(prev);
+        }
+        if (t->own_arg) free(t->arg);
+
+        pthread_mutex_lock(&mtx_pool.lock);
+        t->status = status;
+        t->done = 1;
+        for (size_t i = 0; i < t->ndependents; i++) {
+            mtx_task *d = t->dependents[i];
+            if (status != 0) d->failed = 1;
+            if (--d->pending == 0) mtx_pool_push(d);
+        }
+        pthread_cond_broadcast(&mtx_pool.finished);
+        pthread_mutex_unlock(&mtx_pool.lock);
+
+        mtx_task_unref(t);
+        pthread_mutex_lock(&mtx_pool.lock);
+    }
+    pthread_mutex_unlock(&mtx_pool.lock);
+    return NULL;
+}
+
+/**
+ * @brief Starts the workers (lock held)
+ */
+static int mtx_pool_start(size_t nthreads) {
+    if (nthreads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = cpus > 0 ? (size_t)cpus : 1;
+    }
+
+    mtx_pool.threads = malloc(nthreads * sizeof(pthread_t));
+    if (!mtx_pool.threads) return -2;
+
+    mtx_pool.stop = 0;
+    mtx_pool.nthreads = 0;
+    for (size_t i = 0; i < nthreads; i++) {
+        if (pthread_create(&mtx_pool.threads[i], NULL, mtx_pool_worker, NULL) != 0) break;
+        mtx_pool.nthreads++;
+    }
+    if (mtx_pool.nthreads == 0) {
+        free(mtx_pool.threads);
+        mtx_pool.threads = NULL;
+        return -2;
+    }
+
+    mtx_pool.running = 1;
+    return 0;
+}
+
+int mtx_async_init(size_t nthreads) {
+    pthread_mutex_lock(&mtx_pool.lock);
+    if (mtx_pool.running) {
+        pthread_mutex_unlock(&mtx_pool.lock);
+        MTX_LOG_ERROR("Worker pool is already running");
+        return -1;
+    }
+
+    int rc = mtx_pool_start(nthreads);
+    pthread_mutex_unlock(&mtx_pool.lock);
+
+    if (rc != 0) MTX_LOG_ERROR("Failed to start worker pool");
+    else MTX_LOG("Worker pool started");
+    return rc;
+}
+
+void mtx_async_shutdown(void) {
+    pthread_mutex_lock(&mtx_pool.lock);
+    if (!mtx_pool.running || mtx_pool.stop) {
+        pthread_mutex_unlock(&mtx_pool.lock);
+        return;
+    }
+    mtx_pool.stop = 1;
+    pthread_cond_broadcast(&mtx_pool.work);
+    pthread_mutex_unlock(&mtx_pool.lock);
+
+    // Workers only leave once the ready queue is empty, and every blocked task
+    // becomes ready when its last dependency finishes
+    for (size_t i = 0; i < mtx_pool.nthreads; i++) {
+        pthread_join(mtx_pool.threads[i], NULL);
+    }
+
+    pthread_mutex_lock(&mtx_pool.lock);
+    free(mtx_pool.threads);
+    mtx_pool.threads = NULL;
+    mtx_pool.nthreads = 0;
+    mtx_pool.running = 0;
+    mtx_pool.stop = 0;
+    pthread_mutex_unlock(&mtx_pool.lock);
+    MTX_LOG("Worker pool stopped");
+}
+
+/**
+ * @brief Registers t as a dependent of dep (lock held)
+ * @return 0 on success, -2 if allocation failed
+ */
+static int mtx_task_add_dependent(mtx_task *dep, mtx_task *t) {
+    if (dep->ndependents == dep->cap) {
+        size_t cap = dep->cap ? 2 * dep->cap : 4;
+        mtx_task **d = realloc(dep->dependents, cap * sizeof(mtx_task*));
+        if (!d) return -2;
+        dep->dependents = d;
+        dep->cap = cap;
+    }
+    dep->dependents[dep->ndependents++] = t;
+    return 0;
+}
+
+static mtx_task *mtx_async_submit_impl(mtx_task_fn fn, void *arg, int own_arg,
+                                       mtx_task *const *deps, size_t ndeps) {
+    if (!fn || (ndeps && !deps)) {
+        MTX_LOG_ERROR("Invalid arguments in task submission");
+        if (own_arg) free(arg);
+        return NULL;
+    }
+
+    mtx_task *t = calloc(1, sizeof(mtx_task));
+    if (!t) {
+        MTX_LOG_ERROR("Failed to allocate task");
+        if (own_arg) free(arg);
+        return NULL;
+    }
+    t->fn = fn;
+    t->arg = arg;
+    t->own_arg = own_arg;
+    t->ctx = mtx_context_current();
+    atomic_init(&t->refs, 2);
+
+    pthread_mutex_lock(&mtx_pool.lock);
+    if (mtx_pool.stop) {
+        // Shutdown is joining workers that will not look at the queue again
+        pthread_mutex_unlock(&mtx_pool.lock);
+        MTX_LOG_ERROR("Worker pool is shutting down");
+        if (own_arg) free(arg);
+        free(t);
+        return NULL;
+    }
+    if (!mtx_pool.running && mtx_pool_start(0) != 0) {
+        pthread_mutex_unlock(&mtx_pool.lock);
+        MTX_LOG_ERROR("Failed to start worker pool");
+        if (own_arg) free(arg);
+        free(t);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < ndeps; i++) {
+        mtx_task *dep = deps[i];
+        if (!dep) continue;
+        if (dep->done) {
+            if (dep->status != 0) t->failed = 1;
+        } else if (mtx_task_add_dependent(dep, t) == 0) {
+            t->pending++;
+        } else {
+            // Cannot track the dependency: refuse to run out of order
+            t->failed = 1;
+            MTX_LOG_ERROR("Failed to register task dependency");
+        }
+    }
+    if (t->pending == 0) mtx_pool_push(t);
+    pthread_mutex_unlock(&mtx_pool.lock);
+
+    return t;
+}
+
+mtx_task *mtx_async_submit(mtx_task_fn fn, void *arg, mtx_task *const *deps, size_t ndeps) {
+    return mtx_async_submit_impl(fn, arg, 0, deps, ndeps);
+}
+
+int mtx_task_wait(mtx_task *t) {
+    if (!t) {
+        MTX_LOG_ERROR("Null task in wait");
+        return 1;
+    }
+
+    pthread_mutex_lock(&mtx_pool.lock);
+    while (!t->done) {
+        pthread_cond_wait(&mtx_pool.finished, &mtx_pool.lock);
+    }
+    int status = t->status;
+    pthread_mutex_unlock(&mtx_pool.lock);
+
+    // The body failed on a worker: report it on the waiting thread
+    if (status == MTX_ASYNC_CANCELED) mtx_set_error(__func__, "Task skipped: a dependency failed");
+    else if (status != 0 && t->err.func) mtx_set_error(t->err.func, t->err.msg);
+    return status;
+}
+
+int mtx_task_done(mtx_task *t) {
+    if (!t) return 0;
+
+    pthread_mutex_lock(&mtx_pool.lock);
+    int done = t->done;
+    pthread_mutex_unlock(&mtx_pool.lock);
+    return done;
+}
+
+void mtx_task_release(mtx_task *t) {
+    if (!t) return;
+    mtx_task_unref(t);
+}
+
+/* ================== Asynchronous Operations ================== */
+
+/**
+ * @brief Arguments of the built-in operations, owned by the task
+ */
+typedef struct {
+    matrix *res;
+    matrix **out;
+    double *dout;
+    const matrix *a, *b;
+    double d;
+} mtx_async_args;
+
+static int mtx_async_run_mul2(void *p) {
+    mtx_async_args *a = p;
+    return mtx_mul2(a->res, a->a, a->b);
+}
+
+static int mtx_async_run_add2(void *p) {
+    mtx_async_args *a = p;
+    return mtx_add2(a->res, a->a, a->b);
+}
+
+static int mtx_async_run_sub2(void *p) {
+    mtx_async_args *a = p;
+    return mtx_sub2(a->res, a->a, a->b);
+}
+
+static int mtx_async_run_exp(void *p) {
+    mtx_async_args *a = p;
+    *a->out = mtx_exp(a->a, a->d);
+    return *a->out ? 0 : -1;
+}
+
+static int mtx_async_run_solve(void *p) {
+    mtx_async_args *a = p;
+    *a->out = mtx_solve_gauss(a->a, a->b);
+    return *a->out ? 0 : -1;
+}
+
+static int mtx_async_run_norm(void *p) {
+    mtx_async_args *a = p;
+    *a->dout = mtx_norm(a->a);
+    return *a->dout < 0.0 ? -1 : 0;
+}
+
+static mtx_task *mtx_async_op(mtx_task_fn fn, mtx_async_args args, mtx_task *const *deps, size_t ndeps) {
+    mtx_async_args *a = malloc(sizeof(mtx_async_args));
+    if (!a) {
+        MTX_LOG_ERROR("Failed to allocate task arguments");
+        return NULL;
+    }
+    *a = args;
+    return mtx_async_submit_impl(fn, a, 1, deps, ndeps);
+}
+
+mtx_task *mtx_async_mul2(matrix *res, const matrix *mtx1, const matrix *mtx2,
+                         mtx_task *const *deps, size_t ndeps) {
+    return mtx_async_op(mtx_async_run_mul2, (mtx_async_args){.res = res, .a = mtx1, .b = mtx2}, deps, ndeps);
+}
+
+mtx_task *mtx_async_add2(matrix *res, const matrix *mtx1, const matrix *mtx2,
+                         mtx_task *const *deps, size_t ndeps) {
+    return mtx_async_op(mtx_async_run_add2, (mtx_async_args){.res = res, .a = mtx1, .b = mtx2}, deps, ndeps);
+}
+
+mtx_task *mtx_async_sub2(matrix *res, const matrix *mtx1, const matrix *mtx2,
+                         mtx_task *const *deps, size_t ndeps) {
+    return mtx_async_op(mtx_async_run_sub2, (mtx_async_args){.res = res, .a = mtx1, .b = mtx2}, deps, ndeps);
+}
+
+mtx_task *mtx_async_exp(matrix **res, const matrix *mtx, double eps,
+                        mtx_task *const *deps, size_t ndeps) {
+    if (!res) {
+        MTX_LOG_ERROR("Null result pointer in async exp");
+        return NULL;
+    }
+    *res = NULL;
+    return mtx_async_op(mtx_async_run_exp, (mtx_async_args){.out = res, .a = mtx, .d = eps}, deps, ndeps);
+}
+
+mtx_task *mtx_async_solve_gauss(matrix **res, const matrix *A, const matrix *B,
+                                mtx_task *const *deps, size_t ndeps) {
+    if (!res) {
+        MTX_LOG_ERROR("Null result pointer in async solve");
+        return NULL;
+    }
+    *res = NULL;
+    return mtx_async_op(mtx_async_run_solve, (mtx_async_args){.out = res, .a = A, .b = B}, deps, ndeps);
+}
+
+mtx_task *mtx_async_norm(double *res, const matrix *mtx, mtx_task *const *deps, size_t ndeps) {
+    if (!res) {
+        MTX_LOG_ERROR("Null result pointer in async norm");
+        return NULL;
+    }
+    return mtx_async_op(mtx_async_run_norm, (mtx_async_args){.dout = res, .a = mtx}, deps, ndeps);
+}
@@ -1,17 +1,17 @@
 #include "mtx_repmem.h"
 #include "mtx_arithmetic.h"
 #include "mtx_actions.h"
+#include "mtx_calcs.h"
+#include "mtx_decomp.h"
 #include "mtx_logs.h"
+#include "mtx_metrics.h"
+#include "mtx_internal.h"
 #include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
-struct matrix
-{
-    double *data; // data + w * i + j
-    size_t w, h;    
-};
-
 matrix *mtx_exp(const matrix *mtx, double eps) {
+    MTX_METRIC_BEGIN(EXP);
     if(eps <= MTX_MIN_DIVISOR) {
         MTX_LOG_ERROR("Epsilon cant equal to zero");
         return NULL;
@@ -22,11 +22,18 @@ matrix *mtx_exp(const matrix *mtx, double eps) {
         return NULL;
     }
 
+    if(mtx_is_symmetric(mtx)) {
+        return mtx_fun(mtx, exp);
+    }
+
     matrix *res = mtx_alloc_id(mtx->w, mtx->h);
     if(!res) return NULL;
 
     matrix *term = mtx_copy(mtx);
-    if(!term) {
+    matrix *next = mtx_alloc(mtx->w, mtx->h);
+    if(!term || !next) {
+        if(term) mtx_free(term);
+        if(next) mtx_free(next);
         mtx_free(res);
         return NULL;
     }
@@ -37,123 +44,385 @@ matrix *mtx_exp(const matrix *mtx, double eps) {
         if(mtx_add(res, term) != 0) break;
 
         ++k;
-        if(mtx_mul(term, mtx) != 0) break;
+        // term = term * mtx / k, ping-ponging between two preallocated buffers
+        if(mtx_mul2(next, term, mtx) != 0) break;
+        matrix *swap = term;
+        term = next;
+        next = swap;
     
         if(mtx_sdiv(term, k) != 0) {
             mtx_free(res);
+            res = NULL;
             break;
         }
     }
 
     mtx_free(term);
+    mtx_free(next);
+    if(res) {
+        const size_t n = mtx->w;
+        MTX_METRIC_END(EXP, (k - 1) * MTX_MUL_BYTES(n, n, n), (k - 1) * MTX_MUL_FLOPS(n, n, n));
+    }
     return res;
 }
 
-matrix* mtx_solve_gauss(const matrix* A, const matrix* B){
-    // Check inputs
-    if (!A || !B || !A->data || !B->data) {
-        MTX_LOG_ERROR("Null matrix in solver");
+matrix *mtx_fun(const matrix *mtx, double (*f)(double)) {
+    MTX_METRIC_BEGIN(FUN);
+    if (!mtx || !mtx->data || !f) {
+        MTX_LOG_ERROR("Null pointer in matrix function");
         return NULL;
     }
-    if (A->w != A->h) {
-        MTX_LOG_ERROR("Matrix A must be square");
+    if (!mtx_is_symmetric(mtx)) {
+        MTX_LOG_ERROR("Matrix function requires a symmetric matrix");
         return NULL;
     }
-    if (A->h != B->h) {
-        MTX_LOG_ERROR("Dimension mismatch between A and B");
-        return NULL;
+
+    const size_t n = mtx->w;
+    double *fl = malloc(n * sizeof(double));
+    matrix *V = mtx_alloc(n, n);
+    matrix *res = mtx_alloc(n, n);
+    if (!fl || !V || !res) {
+        MTX_LOG_ERROR("Allocation in matrix function failed");
+        goto fail;
+    }
+
+    if (mtx_eig_sym(mtx, fl, V) != 0) goto fail;
+
+    for (size_t k = 0; k < n; k++) {
+        fl[k] = f(fl[k]);
+        if (!isfinite(fl[k])) {
+            MTX_LOG_ERROR("Function is not defined on the spectrum");
+            goto fail;
+        }
+    }
+
+    // res = V * f(L) * V^T, upper triangle computed and mirrored
+    #pragma omp parallel for schedule(dynamic, 8)
+    for (size_t i = 0; i < n; i++) {
+        const double *vi = V->data + n * i;
+        for (size_t j = i; j < n; j++) {
+            const double *vj = V->data + n * j;
+            double sum = 0.0;
+            for (size_t k = 0; k < n; k++) {
+                sum += vi[k] * fl[k] * vj[k];
+            }
+            res->data[n * i + j] = sum;
+            res->data[n * j + i] = sum;
+        }
+    }
+
+    free(fl);
+    mtx_free(V);
+    MTX_LOG("Matrix function calculated");
+    MTX_METRIC_END(FUN, 2 * n * n * sizeof(double), n * n * n);
+    return res;
+
+fail:
+    free(fl);
+    if (V) mtx_free(V);
+    if (res) mtx_free(res);
+    return NULL;
+}
+
+matrix *mtx_sqrt(const matrix *mtx) {
+    return mtx_fun(mtx, sqrt);
+}
+
+matrix *mtx_log(const matrix *mtx) {
+    return mtx_fun(mtx, log);
+}
+
+/**
+ * @brief Taylor degrees m and theta_m bounds for double precision
+ * (Al-Mohy & Higham, "Computing the action of the matrix exponential", Table 3.1)
+ */
+static const struct {
+    size_t m;
+    double theta;
+} mtx_expm_theta[] = {
+    {5, 2.40e-3}, {6, 9.07e-3}, {7, 2.38e-2}, {8, 5.00e-2}, {9, 8.96e-2},
+    {10, 1.44e-1}, {11, 2.14e-1}, {12, 3.00e-1}, {13, 4.00e-1}, {14, 5.14e-1},
+    {15, 6.41e-1}, {16, 7.81e-1}, {17, 9.31e-1}, {18, 1.09}, {19, 1.26},
+    {20, 1.44}, {21, 1.62}, {22, 1.82}, {23, 2.01}, {24, 2.22},
+    {25, 2.43}, {26, 2.64}, {27, 2.86}, {28, 3.08}, {29, 3.31},
+    {30, 3.54}, {35, 4.70}, {40, 6.00}, {45, 7.20}, {50, 8.50}, {55, 9.90}
+};
+
+/**
+ * @brief dst = c * (A - mu*I) * src for a row-major panel src (n x k)
+ * A * src goes through the tuned product kernels, the shift and scale are one pass.
+ */
+static void mtx_panel_mul(double *dst, const matrix *A, const double *src,
+                          size_t k, double mu, double c) {
+    const size_t n = A->h;
+    const matrix x = {.data = (double *)src, .w = k, .h = n, .map_len = 0};
+    matrix y = {.data = dst, .w = k, .h = n, .map_len = 0};
+
+    mtx_mul_kernel(&y, A, &x);
+    for (size_t p = 0; p < n * k; p++) {
+        dst[p] = c * (dst[p] - mu * src[p]);
+    }
+}
+
+/**
+ * @brief Picks Taylor degree m and scaling s minimizing the number of products m*s
+ */
+static void mtx_expm_params(double norm, size_t *m, size_t *s) {
+    *m = 0;
+    *s = 1;
+    if (norm <= 0.0) return;
+
+    double best = INFINITY;
+    for (size_t i = 0; i < sizeof(mtx_expm_theta) / sizeof(mtx_expm_theta[0]); i++) {
+        double steps = ceil(norm / mtx_expm_theta[i].theta);
+        double cost = steps * (double)mtx_expm_theta[i].m;
+        if (cost < best) {
+            best = cost;
+            *m = mtx_expm_theta[i].m;
+            *s = steps < 1.0 ? 1 : (size_t)steps;
+        }
     }
+}
 
+/**
+ * @brief F := e^(tA) * F, using B and tmp (n x k) as scratch
+ * @return Number of matrix-panel products performed
+ */
+static size_t mtx_expm_apply(const matrix *A, double mu, double norm, double t, double eps,
+                           double *F, double *B, double *tmp, size_t k) {
     const size_t n = A->h;
-    const size_t m = B->w;
+    size_t m, s;
 
-    // Create augmented matrix [A|B]
-    matrix* aug = mtx_alloc(n + m, n);
-    if (!aug) {
-        MTX_LOG_ERROR("Failed to allocate augmented matrix");
-        return NULL;
+    mtx_expm_params(fabs(t) * norm, &m, &s);
+    const double eta = exp(t * mu / (double)s);
+    size_t products = 0;
+
+    memcpy(B, F, n * k * sizeof(double));
+    for (size_t i = 0; i < s; i++) {
+        double c1 = mtx_panel_norm_inf(B, k, n);
+
+        for (size_t j = 1; j <= m; j++) {
+            mtx_panel_mul(tmp, A, B, k, mu, t / (double)(s * j));
+            products++;
+            double *swap = B;
+            B = tmp;
+            tmp = swap;
+
+            double c2 = mtx_panel_norm_inf(B, k, n);
+            for (size_t p = 0; p < n * k; p++) {
+                F[p] += B[p];
+            }
+            if (c1 + c2 <= eps * mtx_panel_norm_inf(F, k, n)) break;
+            c1 = c2;
+        }
+
+        for (size_t p = 0; p < n * k; p++) {
+            F[p] *= eta;
+        }
+        memcpy(B, F, n * k * sizeof(double));
     }
+    return products;
+}
 
+int mtx_exp_mul_seq(matrix **res, const matrix *mtx, const matrix *vec,
+                    const double *t, size_t count, double eps) {
+    MTX_METRIC_BEGIN(EXP_MUL);
+    if (!res || !t || !mtx || !vec || !mtx->data || !vec->data) {
+        MTX_LOG_ERROR("Null pointer in exp_mul calculation");
+        return 1;
+    }
+    if (mtx->w != mtx->h || mtx->w != vec->h) {
+        MTX_LOG_ERROR("Matrix size mismatch in exp_mul calculation");
+        return -1;
+    }
+    if (eps <= MTX_MIN_DIVISOR) {
+        MTX_LOG_ERROR("Epsilon cant equal to zero");
+        return -1;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        res[i] = NULL;
+    }
+
+    const size_t n = mtx->h;
+    const size_t k = vec->w;
+
+    double trace = 0.0;
     for (size_t i = 0; i < n; i++) {
-        memcpy(aug->data + (n+m)*i, A->data + n*i, sizeof(double)*n);
-        memcpy(aug->data + (n+m)*i + n, B->data + m*i, sizeof(double)*m);
+        trace += mtx->data[n * i + i];
+    }
+    const double mu = trace / (double)n;
+    const double norm = mtx_panel_norm1(mtx->data, mtx->w, mtx->h, mu);
+
+    matrix *F = mtx_copy(vec);
+    double *B = malloc(n * k * sizeof(double));
+    double *tmp = malloc(n * k * sizeof(double));
+    if (!F || !B || !tmp || norm < 0.0) {
+        MTX_LOG_ERROR("Allocation in exp_mul failed");
+        if (F) mtx_free(F);
+        free(B);
+        free(tmp);
+        return -2;
     }
 
-    // Gaussian elimination with partial pivoting
+    double prev = 0.0;
+    size_t products = 0;
+    for (size_t i = 0; i < count; i++) {
+        products += mtx_expm_apply(mtx, mu, norm, t[i] - prev, eps, F->data, B, tmp, k);
+        prev = t[i];
+
+        res[i] = mtx_copy(F);
+        if (!res[i]) {
+            MTX_LOG_ERROR("Allocation of exp_mul result failed");
+            for (size_t j = 0; j < i; j++) {
+                mtx_free(res[j]);
+                res[j] = NULL;
+            }
+            mtx_free(F);
+            free(B);
+            free(tmp);
+            return -2;
+        }
+    }
+
+    mtx_free(F);
+    free(B);
+    free(tmp);
+    MTX_LOG("Matrix exponential action calculated");
+    MTX_METRIC_END(EXP_MUL, products * MTX_MUL_BYTES(n, n, k), products * MTX_MUL_FLOPS(n, n, k));
+    return 0;
+}
+
+matrix *mtx_exp_mul(const matrix *mtx, const matrix *vec, double t, double eps) {
+    matrix *res = NULL;
+    if (mtx_exp_mul_seq(&res, mtx, vec, &t, 1, eps) != 0) {
+        return NULL;
+    }
+    return res;
+}
+
+int mtx_gauss_elim(matrix *aug, size_t n, mtx_perm *rows) {
+    MTX_METRIC_BEGIN(GAUSS_ELIM);
+    const size_t w = aug->w;
+    size_t *r = rows->p;
     for (size_t k = 0; k < n; ++k) {
         // Partial pivoting: find row with maximum element in current column
         size_t max_row = k;
-        double max_val = fabs(*mtx_cptr(aug, k, k));
+        double max_val = fabs(*mtx_cat(aug, r[k], k));
         for (size_t i = k + 1; i < n; i++) {
-            double val = fabs(*mtx_cptr(aug, i, k));
+            double val = fabs(*mtx_cat(aug, r[i], k));
             if (val > max_val) {
                 max_val = val;
                 max_row = i;
             }
         }
 
-        // Swap rows if necessary
+        // Swap row indices instead of row data
         if (max_row != k) {
-            if (mtx_swap_rows(aug, k, max_row) != 0) {
-                mtx_free(aug);
-                MTX_LOG_ERROR("Row swap failed");
-                return NULL;
-            }
+            size_t tmp = r[k];
+            r[k] = r[max_row];
+            r[max_row] = tmp;
         }
 
         // Check for zero pivot (matrix is singular)
-        if (fabs(*mtx_cptr(aug, k, k)) < MTX_MIN_DIVISOR) {
-            mtx_free(aug);
+        double *pivot_row = mtx_row(aug, r[k]);
+        const double pivot = pivot_row[k];
+        if (fabs(pivot) < MTX_MIN_DIVISOR) {
             MTX_LOG_ERROR("Matrix is singular (zero pivot)");
-            return NULL;
+            return -3;
         }
 
         // Eliminate below and above the current row
         for (size_t j = 0; j < n; j++) {
             if (j != k) {
-                double factor = *mtx_cptr(aug, j, k) / *mtx_cptr(aug, k, k);
-                if (mtx_row_add(aug, j, k, -factor) != 0) {
-                    mtx_free(aug);
-                    MTX_LOG_ERROR("Eliminating rows operation failed");
-                    return NULL;
+                double *row = mtx_row(aug, r[j]);
+                double factor = row[k] / pivot;
+                if (factor != 0.0) {
+                    mtx_row_axpy(row + k, pivot_row + k, -factor, w - k);
                 }
             }
         }
 
         // Normalize the current row
-        double pivot = *mtx_cptr(aug, k, k);
-        if (mtx_row_div(aug, k, pivot) != 0) {
-            mtx_free(aug);
-            MTX_LOG_ERROR("Row normalization failed");
-            return NULL;
+        for (size_t j = k; j < w; j++) {
+            pivot_row[j] /= pivot;
         }
-        
+    }
+    MTX_METRIC_END(GAUSS_ELIM, 3 * n * n * w * sizeof(double), 2 * n * n * w);
+    return 0;
+}
+
+matrix* mtx_solve_gauss(const matrix* A, const matrix* B){
+    MTX_METRIC_BEGIN(SOLVE_GAUSS);
+    // Check inputs
+    if (!A || !B || !A->data || !B->data) {
+        MTX_LOG_ERROR("Null matrix in solver");
+        return NULL;
+    }
+    if (A->w != A->h) {
+        MTX_LOG_ERROR("Matrix A must be square");
+        return NULL;
+    }
+    if (A->h != B->h) {
+        MTX_LOG_ERROR("Dimension mismatch between A and B");
+        return NULL;
+    }
+
+    const size_t n = A->h;
+    const size_t m = B->w;
+
+    // Create augmented matrix [A|B]
+    matrix* aug = mtx_alloc(n + m, n);
+    if (!aug) {
+        MTX_LOG_ERROR("Failed to allocate augmented matrix");
+        return NULL;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        memcpy(aug->data + (n+m)*i, A->data + n*i, sizeof(double)*n);
+        memcpy(aug->data + (n+m)*i + n, B->data + m*i, sizeof(double)*m);
+    }
+
+    mtx_perm *rows = mtx_perm_alloc(n);
+    if (!rows) {
+        mtx_free(aug);
+        MTX_LOG_ERROR("Failed to allocate pivot order");
+        return NULL;
+    }
+
+    if (mtx_gauss_elim(aug, n, rows) != 0) {
+        mtx_perm_free(rows);
+        mtx_free(aug);
+        return NULL;
     }
 
     matrix* X = mtx_alloc(m, n);
     if (!X) {
+        mtx_perm_free(rows);
         mtx_free(aug);
         MTX_LOG_ERROR("Failed to allocate solution matrix");
         return NULL;
     }
 
+    // Pivot order is applied once, while copying X out
     for (size_t i = 0; i < n; i++) {
-        for (size_t j = 0; j < B->w; j++) {
-            *mtx_ptr(X, i, j) = *mtx_cptr(aug, i, n + j);
-        }
+        memcpy(mtx_row(X, i), mtx_crow(aug, rows->p[i]) + n, m * sizeof(double));
     }
 
+    mtx_perm_free(rows);
     mtx_free(aug);
+    MTX_METRIC_END(SOLVE_GAUSS, (n * n + 2 * n * m) * sizeof(double), 2 * n * n * (n + m));
     return X;
 }
 
 double mtx_verify_solution(const matrix* A, const matrix* X, const matrix* B) {
+    MTX_METRIC_BEGIN(VERIFY);
     if (!A || !X || !B || A->w != X->h || X->w != B->w || A->h != B->h) {
         MTX_LOG_ERROR("Invalid dimensions in solution verification");
         return -1.0;
     }
 
-    matrix* AX = mtx_alloc(A->h, X->w);
+    matrix* AX = mtx_alloc(X->w, A->h);
     if (!AX) {
         MTX_LOG_ERROR("Failed to allocate temp matrix");
         return -1.0;
@@ -173,5 +442,6 @@ double mtx_verify_solution(const matrix* A, const matrix* X, const matrix* B) {
 
     double residual = mtx_norm(AX);
     mtx_free(AX);
+    MTX_METRIC_END(VERIFY, MTX_MUL_BYTES(A->h, A->w, X->w), MTX_MUL_FLOPS(A->h, A->w, X->w));
     return residual;
 }
\ No newline at end of file
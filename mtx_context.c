@@ -0,0 +1,104 @@
+#include <stdlib.h>
+#include "mtx_context.h"
+#include "mtx_logs.h"
+#include "mtx_internal.h"
+
+/**
+ * @brief Process default context; its kernel parameters are loaded by mtx_tune_get
+ */
+static mtx_context mtx_ctx_default = {
+    .policy = {MTX_MEM_DEFAULT, MTX_PAGES_DEFAULT, 0, MTX_MEM_THRESHOLD},
+    .reproducible = 0,
+    .logging = 1
+};
+
+/**
+ * @brief Context bound on this thread, NULL for the default one
+ */
+static _Thread_local mtx_context *mtx_ctx_bound = NULL;
+
+/* ================== Contexts ================== */
+
+mtx_context *mtx_context_create(void) {
+    // Makes sure the parameters being copied have been loaded
+    mtx_tune_get();
+
+    mtx_context *ctx = malloc(sizeof(mtx_context));
+    if (!ctx) {
+        MTX_LOG_ERROR("Failed to allocate context");
+        return NULL;
+    }
+    *ctx = *mtx_context_current();
+    return ctx;
+}
+
+void mtx_context_free(mtx_context *ctx) {
+    if (!ctx || ctx == &mtx_ctx_default) return;
+    if (mtx_ctx_bound == ctx) mtx_ctx_bound = NULL;
+    free(ctx);
+}
+
+mtx_context *mtx_context_default(void) {
+    return &mtx_ctx_default;
+}
+
+mtx_context *mtx_context_current(void) {
+    return mtx_ctx_bound ? mtx_ctx_bound : &mtx_ctx_default;
+}
+
+mtx_context *mtx_context_bind(mtx_context *ctx) {
+    mtx_context *prev = mtx_context_current();
+    mtx_ctx_bound = ctx == &mtx_ctx_default ? NULL : ctx;
+    return prev;
+}
+
+/* ================== Settings ================== */
+
+int mtx_context_set_policy(mtx_context *ctx, const mtx_mem_policy *policy) {
+    if (!ctx) {
+        MTX_LOG_ERROR("Null context in set_policy");
+        return 1;
+    }
+    if (!policy) {
+        ctx->policy = (mtx_mem_policy){MTX_MEM_DEFAULT, MTX_PAGES_DEFAULT, 0, MTX_MEM_THRESHOLD};
+    } else {
+        ctx->policy = *policy;
+    }
+    MTX_LOG("Allocation policy changed");
+    return 0;
+}
+
+int mtx_context_get_policy(const mtx_context *ctx, mtx_mem_policy *policy) {
+    if (!ctx || !policy) {
+        MTX_LOG_ERROR("Null pointer in get_policy");
+        return 1;
+    }
+    *policy = ctx->policy;
+    return 0;
+}
+
+int mtx_context_set_reproducible(mtx_context *ctx, int on) {
+    if (!ctx) {
+        MTX_LOG_ERROR("Null context in set_reproducible");
+        return 1;
+    }
+    ctx->reproducible = on != 0;
+    return 0;
+}
+
+int mtx_context_get_reproducible(const mtx_context *ctx) {
+    return ctx ? ctx->reproducible : 0;
+}
+
+int mtx_context_set_logging(mtx_context *ctx, int on) {
+    if (!ctx) {
+        MTX_LOG_ERROR("Null context in set_logging");
+        return 1;
+    }
+    ctx->logging = on != 0;
+    return 0;
+}
+
+int mtx_context_get_logging(const mtx_context *ctx) {
+    return ctx ? ctx->logging : 0;
+}
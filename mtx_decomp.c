@@ -0,0 +1,852 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include "mtx_decomp.h"
+#include "mtx_logs.h"
+#include "mtx_metrics.h"
+#include "mtx_internal.h"
+
+int mtx_is_symmetric(const matrix *mtx) {
+    if (!mtx || !mtx->data || mtx->w != mtx->h) {
+        return 0;
+    }
+
+    const size_t n = mtx->w;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < i; j++) {
+            double a = mtx->data[n * i + j];
+            double b = mtx->data[n * j + i];
+            if (fabs(a - b) > MTX_SYM_TOL * (fabs(a) + fabs(b))) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Sorts eigenvalues ascending, permuting the columns of z (n x n, leading dimension ldz)
+ */
+static void mtx_eig_sort(double *d, size_t n, double *z, size_t ldz) {
+    for (size_t i = 0; i + 1 < n; i++) {
+        size_t min = i;
+        for (size_t j = i + 1; j < n; j++) {
+            if (d[j] < d[min]) min = j;
+        }
+        if (min == i) continue;
+
+        double tmp = d[i];
+        d[i] = d[min];
+        d[min] = tmp;
+        if (z) {
+            for (size_t r = 0; r < n; r++) {
+                tmp = z[ldz * r + i];
+                z[ldz * r + i] = z[ldz * r + min];
+                z[ldz * r + min] = tmp;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Implicit QL iteration for a symmetric tridiagonal matrix
+ * @param d Diagonal (n), overwritten by eigenvalues
+ * @param e Subdiagonal, e[i] couples rows i and i + 1; length n, destroyed
+ * @param z Rotations are accumulated into its columns (n x n, leading dimension ldz), may be NULL
+ * @return 0 on success, -3 if an eigenvalue needs more than 60 iterations
+ */
+static int mtx_tql(double *d, double *e, size_t n, double *z, size_t ldz) {
+    if (n == 0) return 0;
+    e[n - 1] = 0.0;
+
+    // Off-diagonals are negligible relative to the norm seen so far (as in EISPACK tql2),
+    // so clusters of tiny eigenvalues still split
+    double tst = 0.0;
+    for (size_t l = 0; l < n; l++) {
+        int iter = 0;
+        size_t m;
+        tst = fmax(tst, fabs(d[l]) + fabs(e[l]));
+        do {
+            for (m = l; m + 1 < n; m++) {
+                if (fabs(e[m]) <= DBL_EPSILON * tst) break;
+            }
+            if (m == l) break;
+            if (iter++ == 60) return -3;
+
+            double g = (d[l + 1] - d[l]) / (2.0 * e[l]);
+            double r = hypot(g, 1.0);
+            g = d[m] - d[l] + e[l] / (g + copysign(r, g));
+
+            double s = 1.0, c = 1.0, p = 0.0;
+            int underflow = 0;
+            for (size_t i = m; i-- > l;) {
+                double f = s * e[i];
+                double b = c * e[i];
+                r = hypot(f, g);
+                e[i + 1] = r;
+                if (r == 0.0) {
+                    d[i + 1] -= p;
+                    e[m] = 0.0;
+                    underflow = 1;
+                    break;
+                }
+                s = f / r;
+                c = g / r;
+                g = d[i + 1] - p;
+                r = (d[i] - g) * s + 2.0 * c * b;
+                p = s * r;
+                d[i + 1] = g + p;
+                g = c * r - b;
+
+                if (z) {
+                    for (size_t k = 0; k < n; k++) {
+                        f = z[ldz * k + i + 1];
+                        z[ldz * k + i + 1] = s * z[ldz * k + i] + c * f;
+                        z[ldz * k + i] = c * z[ldz * k + i] - s * f;
+                    }
+                }
+            }
+            if (underflow) continue;
+
+            d[l] -= p;
+            e[l] = g;
+            e[m] = 0.0;
+        } while (1);
+    }
+
+    mtx_eig_sort(d, n, z, ldz);
+    return 0;
+}
+
+/**
+ * @brief Eigenvalue with the index of its source column during a merge
+ */
+typedef struct {
+    double val;
+    size_t src;
+} mtx_eig_pair;
+
+static int mtx_eig_pair_cmp(const void *a, const void *b) {
+    double x = ((const mtx_eig_pair*)a)->val;
+    double y = ((const mtx_eig_pair*)b)->val;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Finds the root of the secular equation 1 + rho * sum(z_j^2 / (delta_j - t)) = 0
+ * on the bracket (lo, hi) by Newton steps safeguarded with bisection
+ */
+static double mtx_secular_root(const double *delta, const double *z, size_t k,
+                               double rho, double lo, double hi) {
+    double t = 0.5 * (lo + hi);
+
+    for (int it = 0; it < 200; it++) {
+        double f = 1.0, df = 0.0;
+        for (size_t j = 0; j < k; j++) {
+            double q = z[j] / (delta[j] - t);
+            f += rho * z[j] * q;
+            df += rho * q * q;
+        }
+
+        if (f > 0.0) hi = t;
+        else lo = t;
+
+        double next = df > 0.0 ? t - f / df : 0.5 * (lo + hi);
+        if (!(next > lo && next < hi)) next = 0.5 * (lo + hi);
+
+        if (fabs(next - t) <= 2.0 * DBL_EPSILON * fabs(next) || next == lo || next == hi) {
+            return next;
+        }
+        t = next;
+    }
+    return t;
+}
+
+/**
+ * @brief Merges two solved halves of a tridiagonal problem (Cuppen's method)
+ * @param d Eigenvalues of both halves (n), overwritten by the merged eigenvalues
+ * @param m Size of the upper half
+ * @param beta Coupling element removed from the tridiagonal matrix
+ * @param z Eigenvectors of the halves in its diagonal blocks (leading dimension ldz)
+ */
+static int mtx_dc_merge(double *d, size_t n, size_t m, double beta, double *z, size_t ldz) {
+    double rho = fabs(beta);
+    const double sgn = beta < 0.0 ? -1.0 : 1.0;
+
+    size_t *idx = malloc(n * sizeof(size_t));
+    size_t *nd = malloc(n * sizeof(size_t));
+    char *defl = calloc(n, 1);
+    double *dd = malloc(n * sizeof(double));
+    double *zz = malloc(n * sizeof(double));
+    double *lam = malloc(n * sizeof(double));
+    double *W = calloc(n * n, sizeof(double));
+    double *V = malloc(n * n * sizeof(double));
+    mtx_eig_pair *pairs = malloc(n * sizeof(mtx_eig_pair));
+    double *delta = NULL, *U = NULL;
+
+    int rc = -2;
+    if (!idx || !nd || !defl || !dd || !zz || !lam || !W || !V || !pairs) goto cleanup;
+
+    // Rank-one vector: last row of Q1 and first row of Q2 (lam is free until the roots are found)
+    double *zv = lam;
+    for (size_t j = 0; j < m; j++) zv[j] = z[ldz * (m - 1) + j];
+    for (size_t j = m; j < n; j++) zv[j] = sgn * z[ldz * m + j];
+
+    // Merge the two sorted halves
+    for (size_t c = 0, i = 0, j = m; c < n; c++) {
+        if (j >= n || (i < m && d[i] <= d[j])) idx[c] = i++;
+        else idx[c] = j++;
+    }
+
+    double nz = 0.0, dmax = 0.0;
+    for (size_t c = 0; c < n; c++) {
+        dd[c] = d[idx[c]];
+        zz[c] = zv[idx[c]];
+        nz += zz[c] * zz[c];
+        if (fabs(dd[c]) > dmax) dmax = fabs(dd[c]);
+        W[n * idx[c] + c] = 1.0;
+    }
+    nz = sqrt(nz);
+    rho *= nz * nz;
+    for (size_t c = 0; c < n; c++) zz[c] /= nz;
+
+    // Deflation: negligible z components and (nearly) equal poles
+    const double tol = 8.0 * DBL_EPSILON * fmax(dmax, rho);
+    size_t prev = n;
+    for (size_t c = 0; c < n; c++) {
+        if (rho * fabs(zz[c]) <= tol) {
+            defl[c] = 1;
+            continue;
+        }
+        if (prev < n && fabs(dd[c] - dd[prev]) <= tol) {
+            double r = hypot(zz[prev], zz[c]);
+            double cs = zz[c] / r, sn = zz[prev] / r;
+            double dp = dd[prev], dc = dd[c];
+
+            dd[prev] = cs * cs * dp + sn * sn * dc;
+            dd[c] = sn * sn * dp + cs * cs * dc;
+            zz[prev] = 0.0;
+            zz[c] = r;
+            for (size_t row = 0; row < n; row++) {
+                double wp = W[n * row + prev], wc = W[n * row + c];
+                W[n * row + prev] = cs * wp - sn * wc;
+                W[n * row + c] = sn * wp + cs * wc;
+            }
+            defl[prev] = 1;
+        }
+        prev = c;
+    }
+
+    size_t k = 0;
+    for (size_t c = 0; c < n; c++) {
+        if (!defl[c]) nd[k++] = c;
+    }
+
+    if (k > 0) {
+        delta = malloc(k * k * sizeof(double));
+        U = malloc(k * k * sizeof(double));
+        if (!delta || !U) goto cleanup;
+
+        double *Dk = V, *Zk = V + k;
+        for (size_t j = 0; j < k; j++) {
+            Dk[j] = dd[nd[j]];
+            Zk[j] = zz[nd[j]];
+        }
+
+        // Roots lam_i in (D_i, D_i+1), the last one in (D_k-1, D_k-1 + rho)
+        #pragma omp parallel for schedule(dynamic, 16)
+        for (size_t i = 0; i < k; i++) {
+            double *di = delta + k * i;
+            size_t org = i;
+            double lo = 0.0, hi = rho;
+
+            if (i + 1 < k) {
+                double gap = Dk[i + 1] - Dk[i];
+                double f = 1.0;
+                for (size_t j = 0; j < k; j++) {
+                    f += rho * Zk[j] * Zk[j] / ((Dk[j] - Dk[i]) - 0.5 * gap);
+                }
+                if (f >= 0.0) {
+                    hi = 0.5 * gap;
+                } else {
+                    org = i + 1;
+                    lo = -0.5 * gap;
+                    hi = 0.0;
+                }
+            }
+
+            for (size_t j = 0; j < k; j++) di[j] = Dk[j] - Dk[org];
+            double tau = mtx_secular_root(di, Zk, k, rho, lo, hi);
+            for (size_t j = 0; j < k; j++) di[j] -= tau;
+            lam[i] = Dk[org] + tau;
+        }
+
+        // Gu-Eisenstat: recompute z so that the eigenvectors stay orthogonal
+        for (size_t j = 0; j < k; j++) {
+            double p = -delta[k * j + j] / rho;
+            for (size_t i = 0; i < k; i++) {
+                if (i != j) p *= -delta[k * i + j] / (Dk[i] - Dk[j]);
+            }
+            Zk[j] = copysign(sqrt(fabs(p)), Zk[j]);
+        }
+
+        #pragma omp parallel for
+        for (size_t i = 0; i < k; i++) {
+            double norm = 0.0;
+            for (size_t j = 0; j < k; j++) {
+                double u = Zk[j] / delta[k * i + j];
+                U[k * j + i] = u;
+                norm += u * u;
+            }
+            norm = sqrt(norm);
+            for (size_t j = 0; j < k; j++) U[k * j + i] /= norm;
+        }
+    }
+
+    // Collect eigenpairs: deflated ones keep their W column
+    for (size_t c = 0, i = 0; c < n; c++) {
+        if (defl[c]) {
+            pairs[c].val = dd[c];
+            pairs[c].src = c;
+        } else {
+            pairs[c].val = lam[i];
+            pairs[c].src = n + i;
+            i++;
+        }
+    }
+    qsort(pairs, n, sizeof(mtx_eig_pair), mtx_eig_pair_cmp);
+
+    // V = eigenvectors of D + rho*z*z^T in the basis of the halves
+    #pragma omp parallel for
+    for (size_t row = 0; row < n; row++) {
+        const double *w = W + n * row;
+        double *v = V + n * row;
+        for (size_t col = 0; col < n; col++) {
+            size_t src = pairs[col].src;
+            if (src < n) {
+                v[col] = w[src];
+            } else {
+                double s = 0.0;
+                for (size_t j = 0; j < k; j++) s += w[nd[j]] * U[k * j + (src - n)];
+                v[col] = s;
+            }
+        }
+    }
+
+    // Z = diag(Q1, Q2) * V, reusing W as the output buffer
+    #pragma omp parallel for
+    for (size_t row = 0; row < n; row++) {
+        size_t p0 = row < m ? 0 : m;
+        size_t p1 = row < m ? m : n;
+        double *out = W + n * row;
+        memset(out, 0, n * sizeof(double));
+        for (size_t p = p0; p < p1; p++) {
+            double q = z[ldz * row + p];
+            if (q == 0.0) continue;
+            const double *v = V + n * p;
+            for (size_t col = 0; col < n; col++) out[col] += q * v[col];
+        }
+    }
+    for (size_t row = 0; row < n; row++) {
+        memcpy(z + ldz * row, W + n * row, n * sizeof(double));
+    }
+    for (size_t c = 0; c < n; c++) d[c] = pairs[c].val;
+    rc = 0;
+
+cleanup:
+    free(idx);
+    free(nd);
+    free(defl);
+    free(dd);
+    free(zz);
+    free(lam);
+    free(W);
+    free(V);
+    free(pairs);
+    free(delta);
+    free(U);
+    return rc;
+}
+
+/**
+ * @brief Divide-and-conquer eigensolver for a symmetric tridiagonal matrix
+ * @param d Diagonal (n), overwritten by ascending eigenvalues
+ * @param e Subdiagonal (n - 1 entries plus one scratch slot), destroyed
+ * @param z Output eigenvectors (n x n, leading dimension ldz)
+ */
+static int mtx_dc(double *d, double *e, size_t n, double *z, size_t ldz) {
+    if (n <= MTX_DC_MIN_SIZE) {
+        for (size_t i = 0; i < n; i++) {
+            memset(z + ldz * i, 0, n * sizeof(double));
+            z[ldz * i + i] = 1.0;
+        }
+        return mtx_tql(d, e, n, z, ldz);
+    }
+
+    const size_t m = n / 2;
+    const double beta = e[m - 1];
+    d[m - 1] -= fabs(beta);
+    d[m] -= fabs(beta);
+
+    int rc = mtx_dc(d, e, m, z, ldz);
+    if (rc != 0) return rc;
+    rc = mtx_dc(d + m, e + m, n - m, z + ldz * m + m, ldz);
+    if (rc != 0) return rc;
+
+    return mtx_dc_merge(d, n, m, beta, z, ldz);
+}
+
+/**
+ * @brief Householder reduction of a full symmetric matrix a (n x n) to tridiagonal form
+ * Reflector vectors are left below the subdiagonal of a, scalar factors in tau.
+ */
+static void mtx_tridiag(double *a, size_t n, double *d, double *e, double *tau, double *work) {
+    double *v = work, *p = work + n;
+
+    for (size_t k = 0; k + 2 < n; k++) {
+        const size_t len = n - k - 1;
+        const size_t off = k + 1;
+        double alpha = a[n * off + k];
+        double xnorm = 0.0;
+        for (size_t i = 1; i < len; i++) {
+            double x = a[n * (off + i) + k];
+            xnorm += x * x;
+        }
+
+        d[k] = a[n * k + k];
+        if (xnorm == 0.0) {
+            tau[k] = 0.0;
+            e[k] = alpha;
+            continue;
+        }
+
+        double beta = -copysign(hypot(alpha, sqrt(xnorm)), alpha);
+        double tk = (beta - alpha) / beta;
+        double scale = 1.0 / (alpha - beta);
+        v[0] = 1.0;
+        for (size_t i = 1; i < len; i++) {
+            a[n * (off + i) + k] *= scale;
+            v[i] = a[n * (off + i) + k];
+        }
+        a[n * off + k] = beta;
+        e[k] = beta;
+        tau[k] = tk;
+
+        // p = tau * A22 * v, w = p - (tau / 2)(p^T v) v
+        double pv = 0.0;
+        #pragma omp parallel for reduction(+:pv)
+        for (size_t i = 0; i < len; i++) {
+            const double *row = a + n * (off + i) + off;
+            double s = 0.0;
+            for (size_t j = 0; j < len; j++) s += row[j] * v[j];
+            p[i] = tk * s;
+            pv += p[i] * v[i];
+        }
+        const double K = 0.5 * tk * pv;
+        for (size_t i = 0; i < len; i++) p[i] -= K * v[i];
+
+        // A22 -= v w^T + w v^T
+        #pragma omp parallel for
+        for (size_t i = 0; i < len; i++) {
+            double *row = a + n * (off + i) + off;
+            const double vi = v[i], wi = p[i];
+            for (size_t j = 0; j < len; j++) row[j] -= vi * p[j] + wi * v[j];
+        }
+    }
+
+    if (n >= 2) {
+        d[n - 2] = a[n * (n - 2) + n - 2];
+        e[n - 2] = a[n * (n - 1) + n - 2];
+    }
+    d[n - 1] = a[n * (n - 1) + n - 1];
+}
+
+/**
+ * @brief Accumulates the reflectors left by mtx_tridiag into q (n x n)
+ */
+static void mtx_tridiag_q(const double *a, const double *tau, size_t n, double *q, double *work) {
+    for (size_t i = 0; i < n; i++) {
+        memset(q + n * i, 0, n * sizeof(double));
+        q[n * i + i] = 1.0;
+    }
+
+    for (size_t k = n >= 3 ? n - 2 : 0; k-- > 0;) {
+        if (tau[k] == 0.0) continue;
+        const size_t off = k + 1;
+        const size_t len = n - off;
+
+        // s^T = v^T Q22, then Q22 -= tau v s^T
+        double *s = work;
+        memset(s, 0, len * sizeof(double));
+        for (size_t i = 0; i < len; i++) {
+            const double vi = i == 0 ? 1.0 : a[n * (off + i) + k];
+            const double *row = q + n * (off + i) + off;
+            for (size_t j = 0; j < len; j++) s[j] += vi * row[j];
+        }
+
+        #pragma omp parallel for
+        for (size_t i = 0; i < len; i++) {
+            const double vi = (i == 0 ? 1.0 : a[n * (off + i) + k]) * tau[k];
+            double *row = q + n * (off + i) + off;
+            for (size_t j = 0; j < len; j++) row[j] -= vi * s[j];
+        }
+    }
+}
+
+int mtx_eig_sym(const matrix *mtx, double *eval, matrix *evec) {
+    MTX_METRIC_BEGIN(EIG_SYM);
+    if (!mtx || !mtx->data || !eval || (evec && !evec->data)) {
+        MTX_LOG_ERROR("Null pointer in symmetric eigensolver");
+        return 1;
+    }
+    if (mtx->w != mtx->h) {
+        MTX_LOG_ERROR("Matrix must be square in symmetric eigensolver");
+        return -1;
+    }
+    if (evec && (evec->w != mtx->w || evec->h != mtx->h)) {
+        MTX_LOG_ERROR("Eigenvector matrix size mismatch");
+        return -1;
+    }
+    if (evec && mtx_unshare(evec, 1) != 0) return -2;
+
+    const size_t n = mtx->w;
+    double *a = malloc(n * n * sizeof(double));
+    double *e = malloc(n * sizeof(double));
+    double *tau = malloc(n * sizeof(double));
+    double *work = malloc(2 * n * sizeof(double));
+    double *q = NULL, *z = NULL;
+    int rc = -2;
+
+    if (!a || !e || !tau || !work) {
+        MTX_LOG_ERROR("Allocation in symmetric eigensolver failed");
+        goto cleanup;
+    }
+
+    // Symmetric copy built from the lower triangle
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j <= i; j++) {
+            a[n * i + j] = a[n * j + i] = mtx->data[n * i + j];
+        }
+    }
+
+    mtx_tridiag(a, n, eval, e, tau, work);
+
+    if (!evec) {
+        rc = mtx_tql(eval, e, n, NULL, 0);
+    } else {
+        q = malloc(n * n * sizeof(double));
+        z = malloc(n * n * sizeof(double));
+        if (!q || !z) {
+            MTX_LOG_ERROR("Allocation in symmetric eigensolver failed");
+            goto cleanup;
+        }
+
+        rc = mtx_dc(eval, e, n, z, n);
+
+        if (rc == 0) {
+            mtx_tridiag_q(a, tau, n, q, work);
+
+            // evec = Q * Z
+            #pragma omp parallel for
+            for (size_t i = 0; i < n; i++) {
+                double *out = evec->data + n * i;
+                memset(out, 0, n * sizeof(double));
+                for (size_t p = 0; p < n; p++) {
+                    const double qip = q[n * i + p];
+                    if (qip == 0.0) continue;
+                    const double *zr = z + n * p;
+                    for (size_t j = 0; j < n; j++) out[j] += qip * zr[j];
+                }
+            }
+        }
+    }
+
+    if (rc == -3) MTX_LOG_ERROR("Symmetric eigensolver did not converge");
+    else if (rc == -2) MTX_LOG_ERROR("Allocation in symmetric eigensolver failed");
+    else {
+        MTX_LOG("Symmetric eigendecomposition completed");
+        MTX_METRIC_END(EIG_SYM, (evec ? 4 : 1) * n * n * sizeof(double), (evec ? 9 : 2) * n * n * n);
+    }
+
+cleanup:
+    free(a);
+    free(e);
+    free(tau);
+    free(work);
+    free(q);
+    free(z);
+    return rc;
+}
+
+/**
+ * @brief Thin Householder QR of a row-major tall panel a (m x l), m >= l
+ * @param q Output orthonormal factor (m x l)
+ * @param r Output upper triangular factor (l x l), may be NULL
+ * @param work Scratch of 2 * l doubles
+ * a is overwritten by the reflectors.
+ */
+static void mtx_qr_raw(double *a, size_t m, size_t l, double *q, double *r, double *work) {
+    double *tau = work, *w = work + l;
+
+    for (size_t k = 0; k < l; k++) {
+        double alpha = a[l * k + k];
+        double xnorm = 0.0;
+        for (size_t i = k + 1; i < m; i++) xnorm += a[l * i + k] * a[l * i + k];
+
+        if (xnorm == 0.0) {
+            tau[k] = 0.0;
+            continue;
+        }
+
+        double beta = -copysign(hypot(alpha, sqrt(xnorm)), alpha);
+        double scale = 1.0 / (alpha - beta);
+        tau[k] = (beta - alpha) / beta;
+        for (size_t i = k + 1; i < m; i++) a[l * i + k] *= scale;
+        a[l * k + k] = beta;
+
+        // Columns k+1..l-1: w = v^T A, A -= tau v w^T (rows streamed)
+        for (size_t j = k + 1; j < l; j++) w[j] = a[l * k + j];
+        for (size_t i = k + 1; i < m; i++) {
+            const double vi = a[l * i + k];
+            for (size_t j = k + 1; j < l; j++) w[j] += vi * a[l * i + j];
+        }
+        for (size_t j = k + 1; j < l; j++) a[l * k + j] -= tau[k] * w[j];
+        for (size_t i = k + 1; i < m; i++) {
+            const double vi = tau[k] * a[l * i + k];
+            for (size_t j = k + 1; j < l; j++) a[l * i + j] -= vi * w[j];
+        }
+    }
+
+    if (r) {
+        for (size_t i = 0; i < l; i++) {
+            for (size_t j = 0; j < l; j++) r[l * i + j] = j >= i ? a[l * i + j] : 0.0;
+        }
+    }
+
+    memset(q, 0, m * l * sizeof(double));
+    for (size_t i = 0; i < l; i++) q[l * i + i] = 1.0;
+
+    for (size_t k = l; k-- > 0;) {
+        if (tau[k] == 0.0) continue;
+        for (size_t j = k; j < l; j++) w[j] = q[l * k + j];
+        for (size_t i = k + 1; i < m; i++) {
+            const double vi = a[l * i + k];
+            for (size_t j = k; j < l; j++) w[j] += vi * q[l * i + j];
+        }
+        for (size_t j = k; j < l; j++) q[l * k + j] -= tau[k] * w[j];
+        for (size_t i = k + 1; i < m; i++) {
+            const double vi = tau[k] * a[l * i + k];
+            for (size_t j = k; j < l; j++) q[l * i + j] -= vi * w[j];
+        }
+    }
+}
+
+int mtx_qr(const matrix *mtx, matrix *Q, matrix *R) {
+    MTX_METRIC_BEGIN(QR);
+    if (!mtx || !mtx->data || !Q || !Q->data || (R && !R->data)) {
+        MTX_LOG_ERROR("Null pointer in QR factorization");
+        return 1;
+    }
+    if (mtx->h < mtx->w || Q->w != mtx->w || Q->h != mtx->h ||
+        (R && (R->w != mtx->w || R->h != mtx->w))) {
+        MTX_LOG_ERROR("Matrix size mismatch in QR factorization");
+        return -1;
+    }
+    if (mtx_unshare(Q, 1) != 0 || (R && mtx_unshare(R, 1) != 0)) return -2;
+
+    double *a = malloc(mtx->w * mtx->h * sizeof(double));
+    double *work = malloc(2 * mtx->w * sizeof(double));
+    if (!a || !work) {
+        MTX_LOG_ERROR("Allocation in QR factorization failed");
+        free(a);
+        free(work);
+        return -2;
+    }
+
+    memcpy(a, mtx->data, mtx->w * mtx->h * sizeof(double));
+    mtx_qr_raw(a, mtx->h, mtx->w, Q->data, R ? R->data : NULL, work);
+
+    free(a);
+    free(work);
+    MTX_LOG("QR factorization completed");
+    MTX_METRIC_END(QR, 2 * mtx->w * mtx->h * sizeof(double), 4 * mtx->h * mtx->w * mtx->w);
+    return 0;
+}
+
+/**
+ * @brief Y = A * X for a row-major panel X (w x l), one pass over the rows of A
+ * @note The library's product kernel picks the gemv, skinny or blocked form by l
+ */
+static void mtx_pass_mul(double *Y, const matrix *A, const double *X, size_t l) {
+    const matrix x = {.data = (double *)X, .w = l, .h = A->w, .map_len = 0};
+    matrix y = {.data = Y, .w = l, .h = A->h, .map_len = 0};
+    mtx_mul_kernel(&y, A, &x);
+}
+
+/**
+ * @brief Z = A^T * X for a row-major panel X (h x l), one pass over the rows of A
+ * Each thread owns a slice of columns of A, so rows are still read contiguously.
+ */
+static void mtx_pass_mul_t(double *Z, const matrix *A, const double *X, size_t l) {
+    const size_t slice = 64;
+    memset(Z, 0, A->w * l * sizeof(double));
+
+    #pragma omp parallel for schedule(static)
+    for (size_t p0 = 0; p0 < A->w; p0 += slice) {
+        const size_t p1 = p0 + slice > A->w ? A->w : p0 + slice;
+        for (size_t i = 0; i < A->h; i++) {
+            const double *a = A->data + A->w * i;
+            const double *x = X + l * i;
+            for (size_t p = p0; p < p1; p++) {
+                const double aip = a[p];
+                double *z = Z + l * p;
+                for (size_t j = 0; j < l; j++) z[j] += aip * x[j];
+            }
+        }
+    }
+}
+
+/**
+ * @brief One-sided Jacobi SVD of a row-major panel b (n x l): b = U * diag(sigma) * v^T
+ * On return the columns of b hold U * diag(sigma) and v (l x l) the right vectors.
+ */
+static int mtx_jacobi_svd(double *b, size_t n, size_t l, double *v) {
+    memset(v, 0, l * l * sizeof(double));
+    for (size_t i = 0; i < l; i++) v[l * i + i] = 1.0;
+
+    for (int sweep = 0; sweep < 60; sweep++) {
+        int rotated = 0;
+        for (size_t p = 0; p + 1 < l; p++) {
+            for (size_t q = p + 1; q < l; q++) {
+                double alpha = 0.0, beta = 0.0, gamma = 0.0;
+                for (size_t i = 0; i < n; i++) {
+                    const double bp = b[l * i + p], bq = b[l * i + q];
+                    alpha += bp * bp;
+                    beta += bq * bq;
+                    gamma += bp * bq;
+                }
+                if (fabs(gamma) <= DBL_EPSILON * sqrt(alpha * beta)) continue;
+                rotated = 1;
+
+                double zeta = (beta - alpha) / (2.0 * gamma);
+                double t = copysign(1.0, zeta) / (fabs(zeta) + sqrt(1.0 + zeta * zeta));
+                double c = 1.0 / sqrt(1.0 + t * t);
+                double sn = c * t;
+                for (size_t i = 0; i < n; i++) {
+                    const double bp = b[l * i + p], bq = b[l * i + q];
+                    b[l * i + p] = c * bp - sn * bq;
+                    b[l * i + q] = sn * bp + c * bq;
+                }
+                for (size_t i = 0; i < l; i++) {
+                    const double vp = v[l * i + p], vq = v[l * i + q];
+                    v[l * i + p] = c * vp - sn * vq;
+                    v[l * i + q] = sn * vp + c * vq;
+                }
+            }
+        }
+        if (!rotated) return 0;
+    }
+    return -3;
+}
+
+int mtx_svd_rand(const matrix *mtx, size_t k, size_t oversample, size_t power_iters,
+                 unsigned long seed, matrix *U, double *s, matrix *Vt) {
+    MTX_METRIC_BEGIN(SVD_RAND);
+    if (!mtx || !mtx->data || !s || (U && !U->data) || (Vt && !Vt->data)) {
+        MTX_LOG_ERROR("Null pointer in randomized SVD");
+        return 1;
+    }
+
+    const size_t m = mtx->h, n = mtx->w;
+    const size_t mn = m < n ? m : n;
+    if (k == 0 || k > mn || (U && (U->h != m || U->w != k)) || (Vt && (Vt->h != k || Vt->w != n))) {
+        MTX_LOG_ERROR("Matrix size mismatch in randomized SVD");
+        return -1;
+    }
+    if ((U && mtx_unshare(U, 1) != 0) || (Vt && mtx_unshare(Vt, 1) != 0)) return -2;
+
+    const size_t l = k + oversample < mn ? k + oversample : mn;
+    double *Y = malloc(m * l * sizeof(double));
+    double *Q = malloc(m * l * sizeof(double));
+    double *Z = malloc(n * l * sizeof(double));
+    double *Zq = malloc(n * l * sizeof(double));
+    double *Vb = malloc(l * l * sizeof(double));
+    double *sig = malloc(l * sizeof(double));
+    size_t *order = malloc(l * sizeof(size_t));
+    double *work = malloc(2 * l * sizeof(double));
+    int rc = -2;
+
+    if (!Y || !Q || !Z || !Zq || !Vb || !sig || !order || !work) {
+        MTX_LOG_ERROR("Allocation in randomized SVD failed");
+        goto cleanup;
+    }
+
+    // Range finder: Q = orth((A A^T)^q A Omega), re-orthonormalized after every pass
+    mtx_rand_fill(Z, n * l, 1, 0.0, 1.0, seed, 0);
+    mtx_pass_mul(Y, mtx, Z, l);
+    mtx_qr_raw(Y, m, l, Q, NULL, work);
+
+    for (size_t it = 0; it < power_iters; it++) {
+        mtx_pass_mul_t(Z, mtx, Q, l);
+        mtx_qr_raw(Z, n, l, Zq, NULL, work);
+        mtx_pass_mul(Y, mtx, Zq, l);
+        mtx_qr_raw(Y, m, l, Q, NULL, work);
+    }
+
+    // B^T = A^T Q (n x l), then B^T = Ub * diag(sig) * Vb^T
+    mtx_pass_mul_t(Z, mtx, Q, l);
+    rc = mtx_jacobi_svd(Z, n, l, Vb);
+    if (rc != 0) {
+        MTX_LOG_ERROR("Randomized SVD did not converge");
+        goto cleanup;
+    }
+
+    for (size_t j = 0; j < l; j++) {
+        double norm = 0.0;
+        for (size_t i = 0; i < n; i++) norm += Z[l * i + j] * Z[l * i + j];
+        sig[j] = sqrt(norm);
+        order[j] = j;
+    }
+    for (size_t i = 0; i < k; i++) {
+        size_t best = i;
+        for (size_t j = i + 1; j < l; j++) {
+            if (sig[order[j]] > sig[order[best]]) best = j;
+        }
+        size_t tmp = order[i];
+        order[i] = order[best];
+        order[best] = tmp;
+    }
+
+    // A ~ (Q Vb) diag(sig) Ub^T
+    for (size_t c = 0; c < k; c++) {
+        const size_t j = order[c];
+        s[c] = sig[j];
+
+        if (U) {
+            for (size_t i = 0; i < m; i++) {
+                double sum = 0.0;
+                for (size_t p = 0; p < l; p++) sum += Q[l * i + p] * Vb[l * p + j];
+                U->data[k * i + c] = sum;
+            }
+        }
+        if (Vt) {
+            const double inv = sig[j] > 0.0 ? 1.0 / sig[j] : 0.0;
+            for (size_t i = 0; i < n; i++) Vt->data[n * c + i] = Z[l * i + j] * inv;
+        }
+    }
+    MTX_LOG("Randomized SVD completed");
+    MTX_METRIC_END(SVD_RAND, (2 * power_iters + 2) * m * n * sizeof(double),
+                   (2 * power_iters + 2) * MTX_MUL_FLOPS(m, n, l));
+
+cleanup:
+    free(Y);
+    free(Q);
+    free(Z);
+    free(Zq);
+    free(Vb);
+    free(sig);
+    free(order);
+    free(work);
+    return rc;
+}
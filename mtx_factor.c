@@ -0,0 +1,712 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "mtx_factor.h"
+#include "mtx_tune.h"
+#include "mtx_logs.h"
+#include "mtx_metrics.h"
+#include "mtx_internal.h"
+
+/**
+ * @brief Right-hand-side columns per thread in the triangular solves
+ */
+#define MTX_SOLVE_COLS 64
+
+/**
+ * @brief Solves U * Y = Y for columns [c0, c0 + len) of y (row stride m), U upper triangular
+ * @note A single right-hand side runs as dot products along the rows of U
+ */
+static void mtx_upper_subst(const matrix *U, double *y, size_t m, size_t c0, size_t len) {
+    const size_t n = U->h;
+    if (m == 1) {
+        for (size_t i = n; i-- > 0;) {
+            const double *u = mtx_crow(U, i);
+            double s = y[i];
+            for (size_t j = i + 1; j < n; j++) s -= u[j] * y[j];
+            y[i] = s / u[i];
+        }
+        return;
+    }
+    for (size_t i = n; i-- > 0;) {
+        const double *u = mtx_crow(U, i);
+        double *yi = y + m * i + c0;
+        for (size_t j = i + 1; j < n; j++) {
+            if (u[j] != 0.0) mtx_row_axpy(yi, y + m * j + c0, -u[j], len);
+        }
+        for (size_t c = 0; c < len; c++) yi[c] /= u[i];
+    }
+}
+
+/* ================== LU Factorization ================== */
+
+struct mtx_lu
+{
+    size_t n;
+    matrix *LU;         // unit L below the diagonal, U on and above it
+    size_t *perm;       // row i of L*U is row perm[i] of A
+    matrix *A;          // current matrix, refactored when an update loses accuracy
+    size_t refactors;
+};
+
+void mtx_lu_free(mtx_lu *lu) {
+    if (!lu) return;
+    mtx_free(lu->LU);
+    mtx_free(lu->A);
+    free(lu->perm);
+    free(lu);
+}
+
+/**
+ * @brief Factors f->A into f->LU and f->perm with partial pivoting
+ * @return 0 on success, -3 if singular
+ * @note Whole rows are swapped, so multipliers move with their rows and
+ * L*U = P*A holds without a pivot history
+ */
+static int mtx_lu_decompose(mtx_lu *f) {
+    const size_t n = f->n;
+    matrix *LU = f->LU;
+    memcpy(LU->data, f->A->data, n * n * sizeof(double));
+    for (size_t i = 0; i < n; i++) f->perm[i] = i;
+
+    for (size_t k = 0; k < n; k++) {
+        size_t p = k;
+        for (size_t i = k + 1; i < n; i++) {
+            if (fabs(*mtx_cat(LU, i, k)) > fabs(*mtx_cat(LU, p, k))) p = i;
+        }
+        if (fabs(*mtx_cat(LU, p, k)) < MTX_MIN_DIVISOR) {
+            MTX_LOG_ERROR("Matrix is singular (zero pivot)");
+            return -3;
+        }
+        if (p != k) {
+            mtx_row_swap(mtx_row(LU, k), mtx_row(LU, p), n);
+            const size_t t = f->perm[k];
+            f->perm[k] = f->perm[p];
+            f->perm[p] = t;
+        }
+
+        const double *pivot_row = mtx_crow(LU, k);
+        const double pivot = pivot_row[k];
+        const size_t rest = n - k - 1;
+        #pragma omp parallel for schedule(static) if(rest * rest > mtx_tune_get()->par_min)
+        for (size_t i = k + 1; i < n; i++) {
+            double *row = mtx_row(LU, i);
+            const double l = row[k] / pivot;
+            row[k] = l;
+            if (l != 0.0) mtx_row_axpy(row + k + 1, pivot_row + k + 1, -l, rest);
+        }
+    }
+    return 0;
+}
+
+mtx_lu *mtx_lu_factor(const matrix *A) {
+    MTX_METRIC_BEGIN(LU_FACTOR);
+    if (!A || !A->data || A->w != A->h) {
+        MTX_LOG_ERROR("LU factorization requires a square matrix");
+        return NULL;
+    }
+
+    const size_t n = A->h;
+    mtx_lu *f = calloc(1, sizeof(mtx_lu));
+    if (!f) {
+        MTX_LOG_ERROR("Allocation in LU factorization failed");
+        return NULL;
+    }
+    f->n = n;
+    f->LU = mtx_alloc(n, n);
+    f->A = mtx_copy(A);
+    f->perm = malloc(n * sizeof(size_t));
+    if (!f->LU || !f->A || !f->perm) {
+        MTX_LOG_ERROR("Allocation in LU factorization failed");
+        mtx_lu_free(f);
+        return NULL;
+    }
+
+    if (mtx_lu_decompose(f) != 0) {
+        mtx_lu_free(f);
+        return NULL;
+    }
+
+    MTX_LOG("LU factorization completed");
+    MTX_METRIC_END(LU_FACTOR, 2 * n * n * sizeof(double), 2 * n * n * n / 3);
+    return f;
+}
+
+/**
+ * @brief Solves L*U * Y = Y in place for m interleaved right-hand sides (row stride m)
+ * @note Columns are independent, so threads take separate column ranges
+ */
+static void mtx_lu_subst(const matrix *LU, double *y, size_t m) {
+    const size_t n = LU->h;
+    if (m == 1) {
+        for (size_t i = 1; i < n; i++) {
+            const double *l = mtx_crow(LU, i);
+            double s = y[i];
+            for (size_t j = 0; j < i; j++) s -= l[j] * y[j];
+            y[i] = s;
+        }
+        mtx_upper_subst(LU, y, 1, 0, 1);
+        return;
+    }
+
+    const size_t chunks = (m + MTX_SOLVE_COLS - 1) / MTX_SOLVE_COLS;
+    #pragma omp parallel for schedule(static) if(n * n * m > mtx_tune_get()->par_min)
+    for (size_t ch = 0; ch < chunks; ch++) {
+        const size_t c0 = ch * MTX_SOLVE_COLS;
+        const size_t len = m - c0 < MTX_SOLVE_COLS ? m - c0 : MTX_SOLVE_COLS;
+        for (size_t i = 1; i < n; i++) {
+            const double *l = mtx_crow(LU, i);
+            double *yi = y + m * i + c0;
+            for (size_t j = 0; j < i; j++) {
+                if (l[j] != 0.0) mtx_row_axpy(yi, y + m * j + c0, -l[j], len);
+            }
+        }
+        mtx_upper_subst(LU, y, m, c0, len);
+    }
+}
+
+int mtx_lu_solve(const mtx_lu *f, matrix *B) {
+    MTX_METRIC_BEGIN(LU_SOLVE);
+    if (!f || !B || !B->data) {
+        MTX_LOG_ERROR("Null pointer in LU solve");
+        return 1;
+    }
+    if (B->h != f->n) {
+        MTX_LOG_ERROR("Dimension mismatch between LU and B");
+        return -1;
+    }
+    if (mtx_unshare(B, 1) != 0) return -2;
+
+    const size_t n = f->n, m = B->w;
+    double *y = mtx_scratch(n * m);
+    if (!y) {
+        MTX_LOG_ERROR("Allocation in LU solve failed");
+        return -2;
+    }
+
+    for (size_t i = 0; i < n; i++) memcpy(y + m * i, mtx_crow(B, f->perm[i]), m * sizeof(double));
+    mtx_lu_subst(f->LU, y, m);
+    memcpy(B->data, y, n * m * sizeof(double));
+
+    MTX_LOG("LU solve completed");
+    MTX_METRIC_END(LU_SOLVE, (n * n + 2 * n * m) * sizeof(double), 2 * n * n * m);
+    return 0;
+}
+
+/**
+ * @brief Bennett's update L*U := L*U + x*y^T, consuming x and y
+ * @return 0 on success, 1 if a pivot cancelled or a multiplier grew past
+ * MTX_LU_MAX_GROWTH (the factors are then partly updated)
+ * @note Step k fixes row k of U and column k of L, then leaves the rank-1
+ * term x2*y2^T for the trailing factors, with x2 = x2 - x_k * l_k and
+ * y2 = y2 - (y_k / u_kk) * u_k.
+ */
+static int mtx_lu_bennett(matrix *LU, double *x, double *y) {
+    const size_t n = LU->h;
+    for (size_t k = 0; k < n; k++) {
+        double *uk = mtx_row(LU, k);
+        const double d = uk[k], xk = x[k], yk = y[k];
+        const double dn = d + xk * yk;
+        if (fabs(dn) < MTX_MIN_DIVISOR || fabs(dn) < MTX_UPDATE_PIVOT_TOL * (fabs(d) + fabs(xk * yk))) return 1;
+
+        const size_t rest = n - k - 1;
+        uk[k] = dn;
+        if (xk != 0.0) mtx_row_axpy(uk + k + 1, y + k + 1, xk, rest);
+        if (yk != 0.0) mtx_row_axpy(y + k + 1, uk + k + 1, -yk / dn, rest);
+
+        for (size_t j = k + 1; j < n; j++) {
+            double *ljk = mtx_at(LU, j, k);
+            const double l = *ljk;
+            const double ln = (l * d + x[j] * yk) / dn;
+            if (fabs(ln) > MTX_LU_MAX_GROWTH) return 1;
+            *ljk = ln;
+            x[j] -= xk * l;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Updates the factors by x*y^T (x already in pivot order), refactoring f->A on instability
+ * @return 0 on success, -3 if the refactored matrix is singular
+ */
+static int mtx_lu_rank1(mtx_lu *f, double *x, double *y) {
+    if (mtx_lu_bennett(f->LU, x, y) == 0) return 0;
+
+    MTX_LOG("LU update lost accuracy, refactoring");
+    f->refactors++;
+    return mtx_lu_decompose(f);
+}
+
+int mtx_lu_update(mtx_lu *f, const double *u, const double *v) {
+    MTX_METRIC_BEGIN(LU_UPDATE);
+    if (!f || !u || !v) {
+        MTX_LOG_ERROR("Null pointer in LU update");
+        return 1;
+    }
+
+    const size_t n = f->n;
+    double *x = mtx_scratch(2 * n);
+    if (!x) {
+        MTX_LOG_ERROR("Allocation in LU update failed");
+        return -2;
+    }
+    double *y = x + n;
+
+    for (size_t i = 0; i < n; i++) {
+        x[i] = u[f->perm[i]];
+        if (u[i] != 0.0) mtx_row_axpy(mtx_row(f->A, i), v, u[i], n);
+    }
+    memcpy(y, v, n * sizeof(double));
+
+    const int rc = mtx_lu_rank1(f, x, y);
+    if (rc != 0) return rc;
+
+    MTX_LOG("LU factors updated");
+    MTX_METRIC_END(LU_UPDATE, 2 * n * n * sizeof(double), 5 * n * n);
+    return 0;
+}
+
+int mtx_lu_set_row(mtx_lu *f, size_t r, const double *row) {
+    MTX_METRIC_BEGIN(LU_UPDATE);
+    if (!f || !row) {
+        MTX_LOG_ERROR("Null pointer in LU row update");
+        return 1;
+    }
+    if (r >= f->n) {
+        MTX_LOG_ERROR("Invalid row index in LU row update");
+        return -1;
+    }
+
+    const size_t n = f->n;
+    double *x = mtx_scratch(2 * n);
+    if (!x) {
+        MTX_LOG_ERROR("Allocation in LU row update failed");
+        return -2;
+    }
+    double *y = x + n;
+
+    // A + e_r * (row - a_r)^T; P * e_r is the unit vector at the pivot position of r
+    double *a = mtx_row(f->A, r);
+    for (size_t j = 0; j < n; j++) y[j] = row[j] - a[j];
+    memcpy(a, row, n * sizeof(double));
+    for (size_t i = 0; i < n; i++) x[i] = f->perm[i] == r ? 1.0 : 0.0;
+
+    const int rc = mtx_lu_rank1(f, x, y);
+    if (rc != 0) return rc;
+
+    MTX_LOG("LU factors updated");
+    MTX_METRIC_END(LU_UPDATE, n * n * sizeof(double), 3 * n * n);
+    return 0;
+}
+
+size_t mtx_lu_refactors(const mtx_lu *f) {
+    if (!f) {
+        MTX_LOG_ERROR("Null pointer in LU refactor count");
+        return 0;
+    }
+    return f->refactors;
+}
+
+/* ================== Cholesky Factorization ================== */
+
+struct mtx_chol
+{
+    size_t n;
+    matrix *R;          // upper triangular, zero below the diagonal
+    matrix *A;          // current matrix, refactored when a downdate loses accuracy
+    size_t refactors;
+};
+
+void mtx_chol_free(mtx_chol *ch) {
+    if (!ch) return;
+    mtx_free(ch->R);
+    mtx_free(ch->A);
+    free(ch);
+}
+
+/**
+ * @brief Factors the upper triangle of A into R
+ * @return 0 on success, -3 if not positive definite
+ */
+static int mtx_chol_decompose(matrix *R, const matrix *A) {
+    const size_t n = A->h;
+    for (size_t i = 0; i < n; i++) {
+        double *ri = mtx_row(R, i);
+        memset(ri, 0, i * sizeof(double));
+        memcpy(ri + i, mtx_cat(A, i, i), (n - i) * sizeof(double));
+    }
+
+    for (size_t k = 0; k < n; k++) {
+        double *rk = mtx_row(R, k);
+        if (!(rk[k] > MTX_MIN_DIVISOR)) {
+            MTX_LOG_ERROR("Matrix is not positive definite");
+            return -3;
+        }
+        const double d = sqrt(rk[k]);
+        rk[k] = d;
+        for (size_t j = k + 1; j < n; j++) rk[j] /= d;
+
+        #pragma omp parallel for schedule(dynamic, 16) if((n - k - 1) * (n - k - 1) > mtx_tune_get()->par_min)
+        for (size_t i = k + 1; i < n; i++) {
+            if (rk[i] != 0.0) mtx_row_axpy(mtx_row(R, i) + i, rk + i, -rk[i], n - i);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Refactors ch->A into a new R, keeping the old one on failure
+ * @return 0 on success, -2 if allocation failed, -3 if not positive definite
+ */
+static int mtx_chol_refactor(mtx_chol *ch) {
+    matrix *R = mtx_alloc(ch->n, ch->n);
+    if (!R) {
+        MTX_LOG_ERROR("Allocation in Cholesky refactorization failed");
+        return -2;
+    }
+    if (mtx_chol_decompose(R, ch->A) != 0) {
+        mtx_free(R);
+        return -3;
+    }
+    mtx_free(ch->R);
+    ch->R = R;
+    return 0;
+}
+
+mtx_chol *mtx_chol_factor(const matrix *A) {
+    MTX_METRIC_BEGIN(CHOL_FACTOR);
+    if (!A || !A->data || A->w != A->h) {
+        MTX_LOG_ERROR("Cholesky factorization requires a square matrix");
+        return NULL;
+    }
+
+    const size_t n = A->h;
+    mtx_chol *ch = calloc(1, sizeof(mtx_chol));
+    if (!ch) {
+        MTX_LOG_ERROR("Allocation in Cholesky factorization failed");
+        return NULL;
+    }
+    ch->n = n;
+    ch->R = mtx_alloc(n, n);
+    ch->A = mtx_copy(A);
+    if (!ch->R || !ch->A) {
+        MTX_LOG_ERROR("Allocation in Cholesky factorization failed");
+        mtx_chol_free(ch);
+        return NULL;
+    }
+
+    if (mtx_chol_decompose(ch->R, ch->A) != 0) {
+        mtx_chol_free(ch);
+        return NULL;
+    }
+
+    MTX_LOG("Cholesky factorization completed");
+    MTX_METRIC_END(CHOL_FACTOR, 2 * n * n * sizeof(double), n * n * n / 3);
+    return ch;
+}
+
+int mtx_chol_solve(const mtx_chol *ch, matrix *B) {
+    if (!ch || !B || !B->data) {
+        MTX_LOG_ERROR("Null pointer in Cholesky solve");
+        return 1;
+    }
+    if (B->h != ch->n) {
+        MTX_LOG_ERROR("Dimension mismatch between Cholesky factor and B");
+        return -1;
+    }
+    if (mtx_unshare(B, 1) != 0) return -2;
+
+    const size_t n = ch->n, m = B->w;
+    const matrix *R = ch->R;
+    double *y = B->data;
+    const size_t chunks = (m + MTX_SOLVE_COLS - 1) / MTX_SOLVE_COLS;
+
+    // R^T * Z = B column by column of R^T, i.e. along the rows of R
+    #pragma omp parallel for schedule(static) if(n * n * m > mtx_tune_get()->par_min)
+    for (size_t ch_i = 0; ch_i < chunks; ch_i++) {
+        const size_t c0 = ch_i * MTX_SOLVE_COLS;
+        const size_t len = m - c0 < MTX_SOLVE_COLS ? m - c0 : MTX_SOLVE_COLS;
+        for (size_t i = 0; i < n; i++) {
+            const double *r = mtx_crow(R, i);
+            double *yi = y + m * i + c0;
+            for (size_t c = 0; c < len; c++) yi[c] /= r[i];
+            for (size_t j = i + 1; j < n; j++) {
+                if (r[j] != 0.0) mtx_row_axpy(y + m * j + c0, yi, -r[j], len);
+            }
+        }
+        mtx_upper_subst(R, y, m, c0, len);
+    }
+
+    MTX_LOG("Cholesky solve completed");
+    return 0;
+}
+
+int mtx_chol_update(mtx_chol *ch, const double *x) {
+    MTX_METRIC_BEGIN(CHOL_UPDATE);
+    if (!ch || !x) {
+        MTX_LOG_ERROR("Null pointer in Cholesky update");
+        return 1;
+    }
+
+    const size_t n = ch->n;
+    double *w = mtx_scratch(n);
+    if (!w) {
+        MTX_LOG_ERROR("Allocation in Cholesky update failed");
+        return -2;
+    }
+    memcpy(w, x, n * sizeof(double));
+    for (size_t i = 0; i < n; i++) {
+        if (x[i] != 0.0) mtx_row_axpy(mtx_row(ch->A, i), x, x[i], n);
+    }
+
+    // Rotation k zeroes w_k against r_kk and carries the rest of w down
+    for (size_t k = 0; k < n; k++) {
+        double *rk = mtx_row(ch->R, k);
+        if (w[k] == 0.0) continue;
+        const double r = hypot(rk[k], w[k]);
+        const double c = r / rk[k], s = w[k] / rk[k];
+        rk[k] = r;
+        for (size_t j = k + 1; j < n; j++) {
+            rk[j] = (rk[j] + s * w[j]) / c;
+            w[j] = c * w[j] - s * rk[j];
+        }
+    }
+
+    MTX_LOG("Cholesky factor updated");
+    MTX_METRIC_END(CHOL_UPDATE, 2 * n * n * sizeof(double), 6 * n * n);
+    return 0;
+}
+
+/**
+ * @brief Hyperbolic sweep R^T * R := R^T * R - w*w^T, consuming w
+ * @return 0 on success, 1 if a diagonal entry vanished (R is then partly updated)
+ */
+static int mtx_chol_sweep_down(matrix *R, double *w) {
+    const size_t n = R->h;
+    for (size_t k = 0; k < n; k++) {
+        double *rk = mtx_row(R, k);
+        if (w[k] == 0.0) continue;
+        const double r2 = (rk[k] - w[k]) * (rk[k] + w[k]);
+        if (!(r2 > MTX_MIN_DIVISOR)) return 1;
+        const double r = sqrt(r2);
+        const double c = r / rk[k], s = w[k] / rk[k];
+        rk[k] = r;
+        for (size_t j = k + 1; j < n; j++) {
+            rk[j] = (rk[j] - s * w[j]) / c;
+            w[j] = c * w[j] - s * rk[j];
+        }
+    }
+    return 0;
+}
+
+int mtx_chol_downdate(mtx_chol *ch, const double *x) {
+    MTX_METRIC_BEGIN(CHOL_UPDATE);
+    if (!ch || !x) {
+        MTX_LOG_ERROR("Null pointer in Cholesky downdate");
+        return 1;
+    }
+
+    const size_t n = ch->n;
+    double *w = mtx_scratch(n);
+    if (!w) {
+        MTX_LOG_ERROR("Allocation in Cholesky downdate failed");
+        return -2;
+    }
+
+    // A - x*x^T = R^T (I - p*p^T) R with R^T p = x: positive definite iff ||p|| < 1
+    memcpy(w, x, n * sizeof(double));
+    double pp = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const double *r = mtx_crow(ch->R, i);
+        w[i] /= r[i];
+        pp += w[i] * w[i];
+        if (w[i] != 0.0) mtx_row_axpy(w + i + 1, r + i + 1, -w[i], n - i - 1);
+    }
+    if (!(pp < 1.0)) {
+        MTX_LOG_ERROR("Downdate would leave the matrix indefinite");
+        return -3;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (x[i] != 0.0) mtx_row_axpy(mtx_row(ch->A, i), x, -x[i], n);
+    }
+
+    int swept = 0;
+    if (1.0 - pp >= MTX_UPDATE_PIVOT_TOL) {
+        memcpy(w, x, n * sizeof(double));
+        swept = 1;
+        if (mtx_chol_sweep_down(ch->R, w) == 0) {
+            MTX_LOG("Cholesky factor downdated");
+            MTX_METRIC_END(CHOL_UPDATE, 2 * n * n * sizeof(double), 8 * n * n);
+            return 0;
+        }
+    }
+
+    MTX_LOG("Cholesky downdate lost accuracy, refactoring");
+    const int rc = mtx_chol_refactor(ch);
+    if (rc != 0) {
+        // Put A back, and R too if the sweep got partway
+        for (size_t i = 0; i < n; i++) {
+            if (x[i] != 0.0) mtx_row_axpy(mtx_row(ch->A, i), x, x[i], n);
+        }
+        if (swept) mtx_chol_refactor(ch);
+        return rc;
+    }
+    ch->refactors++;
+    return 0;
+}
+
+size_t mtx_chol_refactors(const mtx_chol *ch) {
+    if (!ch) {
+        MTX_LOG_ERROR("Null pointer in Cholesky refactor count");
+        return 0;
+    }
+    return ch->refactors;
+}
+
+/* ================== Woodbury Identity ================== */
+
+/**
+ * @brief Gives V^T as a new (k x n) matrix
+ */
+static matrix *mtx_factor_transpose(const matrix *V) {
+    matrix *Vt = mtx_alloc(V->h, V->w);
+    if (!Vt) return NULL;
+    for (size_t i = 0; i < V->h; i++) {
+        const double *v = mtx_crow(V, i);
+        for (size_t l = 0; l < V->w; l++) *mtx_at(Vt, l, i) = v[l];
+    }
+    return Vt;
+}
+
+int mtx_lu_solve_woodbury(const mtx_lu *f, const matrix *U, const matrix *V, matrix *B) {
+    MTX_METRIC_BEGIN(WOODBURY);
+    if (!f || !U || !U->data || !V || !V->data || !B || !B->data) {
+        MTX_LOG_ERROR("Null pointer in Woodbury solve");
+        return 1;
+    }
+
+    const size_t n = f->n, k = U->w, m = B->w;
+    if (U->h != n || V->h != n || V->w != k || B->h != n) {
+        MTX_LOG_ERROR("Dimension mismatch in Woodbury solve");
+        return -1;
+    }
+    if (mtx_unshare(B, 1) != 0) return -2;
+
+    matrix *ZY = mtx_alloc(k + m, n);
+    matrix *Vt = mtx_factor_transpose(V);
+    matrix *C = mtx_alloc(k + m, k);
+    mtx_perm *rows = mtx_perm_alloc(k);
+    int rc = 0;
+    if (!ZY || !Vt || !C || !rows) {
+        MTX_LOG_ERROR("Allocation in Woodbury solve failed");
+        rc = -2;
+        goto cleanup;
+    }
+
+    // [Z | Y] = A^-1 [U | B] in one pass over the factors
+    for (size_t i = 0; i < n; i++) {
+        double *zy = mtx_row(ZY, i);
+        memcpy(zy, mtx_crow(U, f->perm[i]), k * sizeof(double));
+        memcpy(zy + k, mtx_crow(B, f->perm[i]), m * sizeof(double));
+    }
+    mtx_lu_subst(f->LU, ZY->data, k + m);
+
+    // [I + V^T Z | V^T Y], reduced to [I | W] with W = (I + V^T Z)^-1 V^T Y
+    mtx_mul_kernel(C, Vt, ZY);
+    for (size_t l = 0; l < k; l++) *mtx_at(C, l, l) += 1.0;
+    if (mtx_gauss_elim(C, k, rows) != 0) {
+        rc = -3;
+        goto cleanup;
+    }
+
+    // X = Y - Z W
+    #pragma omp parallel for schedule(static) if(n * k * m > mtx_tune_get()->par_min)
+    for (size_t i = 0; i < n; i++) {
+        double *b = mtx_row(B, i);
+        const double *zy = mtx_crow(ZY, i);
+        memcpy(b, zy + k, m * sizeof(double));
+        for (size_t l = 0; l < k; l++) {
+            if (zy[l] != 0.0) mtx_row_axpy(b, mtx_crow(C, rows->p[l]) + k, -zy[l], m);
+        }
+    }
+
+    MTX_LOG("Woodbury solve completed");
+    MTX_METRIC_END(WOODBURY, (n * n + 2 * n * (k + m)) * sizeof(double),
+                   2 * n * (k + m) * (n + 2 * k) + 2 * k * k * (k + m));
+
+cleanup:
+    mtx_free(ZY);
+    mtx_free(Vt);
+    mtx_free(C);
+    mtx_perm_free(rows);
+    return rc;
+}
+
+int mtx_inverse_update(matrix *Ainv, const matrix *U, const matrix *V) {
+    MTX_METRIC_BEGIN(INV_UPDATE);
+    if (!Ainv || !Ainv->data || !U || !U->data || !V || !V->data) {
+        MTX_LOG_ERROR("Null pointer in inverse update");
+        return 1;
+    }
+
+    const size_t n = Ainv->h, k = U->w;
+    if (Ainv->w != n || U->h != n || V->h != n || V->w != k) {
+        MTX_LOG_ERROR("Dimension mismatch in inverse update");
+        return -1;
+    }
+    if (mtx_unshare(Ainv, 1) != 0) return -2;
+
+    matrix *Z = mtx_alloc(k, n);
+    matrix *Vt = mtx_factor_transpose(V);
+    matrix *S = mtx_alloc(k, k);
+    matrix *G = mtx_alloc(n, k);
+    matrix *C = mtx_alloc(k + n, k);
+    mtx_perm *rows = mtx_perm_alloc(k);
+    int rc = 0;
+    if (!Z || !Vt || !S || !G || !C || !rows) {
+        MTX_LOG_ERROR("Allocation in inverse update failed");
+        rc = -2;
+        goto cleanup;
+    }
+
+    // Z = Ainv U, G = V^T Ainv, then [I + V^T Z | G] reduced to [I | (I + V^T Z)^-1 G]
+    mtx_mul_kernel(Z, Ainv, U);
+    mtx_mul_kernel(G, Vt, Ainv);
+    mtx_mul_kernel(S, Vt, Z);
+    for (size_t l = 0; l < k; l++) {
+        double *c = mtx_row(C, l);
+        memcpy(c, mtx_crow(S, l), k * sizeof(double));
+        c[l] += 1.0;
+        memcpy(c + k, mtx_crow(G, l), n * sizeof(double));
+    }
+    if (mtx_gauss_elim(C, k, rows) != 0) {
+        rc = -3;
+        goto cleanup;
+    }
+
+    // Ainv -= Z W
+    #pragma omp parallel for schedule(static) if(n * n * k > mtx_tune_get()->par_min)
+    for (size_t i = 0; i < n; i++) {
+        double *a = mtx_row(Ainv, i);
+        const double *z = mtx_crow(Z, i);
+        for (size_t l = 0; l < k; l++) {
+            if (z[l] != 0.0) mtx_row_axpy(a, mtx_crow(C, rows->p[l]) + k, -z[l], n);
+        }
+    }
+
+    MTX_LOG("Inverse updated");
+    MTX_METRIC_END(INV_UPDATE, (2 * n * n + 2 * n * k) * sizeof(double), 6 * n * n * k + 2 * n * k * k);
+
+cleanup:
+    mtx_free(Z);
+    mtx_free(Vt);
+    mtx_free(S);
+    mtx_free(G);
+    mtx_free(C);
+    mtx_perm_free(rows);
+    return rc;
+}
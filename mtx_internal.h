@@ -0,0 +1,320 @@
+#pragma once
+
+#include <stddef.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include "mtx_repmem.h"
+#include "mtx_perm.h"
+#include "mtx_tune.h"
+#include "mtx_context.h"
+
+/**
+ * @file mtx_internal.h
+ * @brief Private matrix layout and unchecked accessors for library kernels
+ * @note Not part of the public interface. Public functions validate their
+ * arguments once at entry; kernels called after that use the helpers below,
+ * which inline to plain pointer arithmetic.
+ */
+
+/**
+ * @brief Matrix structure (row-major storage)
+ */
+struct matrix
+{
+    double *data; // data + w * i + j
+    size_t w, h;
+    size_t map_len; // length of the mmap backing data, 0 if data comes from malloc, MTX_DATA_BORROWED for mtx_wrap
+    _Atomic(atomic_size_t *) refs; // handles sharing data (see mtx_clone), NULL while never shared
+};
+
+/**
+ * @brief map_len of data owned by the caller (mtx_wrap): never freed or resized in place
+ */
+#define MTX_DATA_BORROWED ((size_t)-1)
+
+/**
+ * @brief Library configuration (see mtx_context.h)
+ */
+struct mtx_context
+{
+    mtx_mem_policy policy;  // used by mtx_alloc and everything built on it
+    mtx_tune_params tune;   // filled from the profile on first use (see mtx_tune_get)
+    int reproducible;       // fixed-order reductions
+    int logging;            // MTX_LOG output for calls on this context
+};
+
+/**
+ * @brief Unchecked mutable pointer to element (i, j)
+ */
+static inline double *mtx_at(matrix *mtx, size_t i, size_t j) {
+    return mtx->data + mtx->w * i + j;
+}
+
+/**
+ * @brief Unchecked const pointer to element (i, j)
+ */
+static inline const double *mtx_cat(const matrix *mtx, size_t i, size_t j) {
+    return mtx->data + mtx->w * i + j;
+}
+
+/**
+ * @brief Unchecked mutable pointer to the start of row i
+ */
+static inline double *mtx_row(matrix *mtx, size_t i) {
+    return mtx->data + mtx->w * i;
+}
+
+/**
+ * @brief Unchecked const pointer to the start of row i
+ */
+static inline const double *mtx_crow(const matrix *mtx, size_t i) {
+    return mtx->data + mtx->w * i;
+}
+
+/**
+ * @brief dst[j] += f * src[j] for j < len; dst and src must not overlap
+ */
+static inline void mtx_row_axpy(double *restrict dst, const double *restrict src, double f, size_t len) {
+    for (size_t j = 0; j < len; j++) {
+        dst[j] += f * src[j];
+    }
+}
+
+/**
+ * @brief Exchanges len elements of two distinct rows
+ */
+static inline void mtx_row_swap(double *restrict r1, double *restrict r2, size_t len) {
+    for (size_t j = 0; j < len; j++) {
+        double tmp = r1[j];
+        r1[j] = r2[j];
+        r2[j] = tmp;
+    }
+}
+
+/**
+ * @brief Gives mtx data of its own before it is written
+ * @param keep Nonzero to copy the shared contents, 0 if the caller overwrites everything
+ * @return 0 on success, -2 if allocation failed (logged, mtx unchanged)
+ * @note Every public function that writes through a matrix argument calls
+ * this first; kernels behind that point write data directly. One atomic
+ * load when the matrix was never cloned.
+ */
+int mtx_unshare(matrix *mtx, int keep);
+
+/**
+ * @brief Makes the data of mtx hold at least count elements, keeping its contents
+ * @note Dimensions are left to the caller. Shared data is unshared first.
+ * Mapped data grows with mremap; shrinking never moves data.
+ * @return 0 on success, -2 if allocation failed (data unchanged)
+ */
+int mtx_reserve_data(matrix *mtx, size_t count);
+
+/**
+ * @brief Scratch buffer of at least count doubles owned by the calling thread
+ * @note Grows on demand and is reused by later calls on the same thread, so
+ * steady-state callers allocate nothing; the previous contents are not kept
+ * when it grows. Released at thread exit.
+ * @return Buffer, NULL if allocation failed
+ */
+double *mtx_scratch(size_t count);
+
+/**
+ * @brief Blocked product dest = mtx1 * mtx2 without argument checks
+ * @note dest must be (mtx1->h x mtx2->w) and must not alias either operand
+ */
+void mtx_block_mul(matrix *dest, const matrix *mtx1, const matrix *mtx2);
+
+/**
+ * @brief Blocked product dest = (P * mtx1) * mtx2, row i of P * mtx1 being row rows[i] of mtx1
+ * @note rows may be NULL for the identity; same requirements as mtx_block_mul
+ */
+void mtx_block_mul_rows(matrix *dest, const matrix *mtx1, const size_t *rows, const matrix *mtx2);
+
+/**
+ * @brief y = P * mtx * x without argument checks; rows may be NULL for the identity
+ */
+void mtx_gemv_rows(double *restrict y, const matrix *mtx, const size_t *rows, const double *restrict x);
+
+/**
+ * @brief dest = (P * mtx1) * mtx2 for 2 <= mtx2->w <= MTX_SKINNY_WIDTH, without argument checks
+ */
+void mtx_skinny_mul_rows(matrix *dest, const matrix *mtx1, const size_t *rows, const matrix *mtx2);
+
+/**
+ * @brief dest = (P * mtx1) * mtx2 by the kernel suited to the width of mtx2
+ * @note Same requirements as mtx_block_mul_rows
+ */
+void mtx_mul_kernel_rows(matrix *dest, const matrix *mtx1, const size_t *rows, const matrix *mtx2);
+
+/**
+ * @brief dest = mtx1 * mtx2 by the kernel suited to the width of mtx2
+ */
+void mtx_mul_kernel(matrix *dest, const matrix *mtx1, const matrix *mtx2);
+
+/**
+ * @brief Infinity norm of a row-major panel (h x w), rows summed pairwise
+ */
+double mtx_panel_norm_inf(const double *p, size_t w, size_t h);
+
+/**
+ * @brief 1-norm of P - mu*I for a row-major panel P (h x w), compensated column sums
+ * @return Norm, -1.0 if allocation failed
+ */
+double mtx_panel_norm1(const double *p, size_t w, size_t h, double mu);
+
+/*
+ * Tile kernels, shared by mtx_tiled (MTX_TILE tiles in memory) and mtx_ooc (tiles of any
+ * edge ts read from a file). A tile is ts x ts doubles, row-major, padded with
+ * zeros past the matrix edge. Row arguments are local to the tile.
+ */
+
+/**
+ * @brief c += sign * a * b for the first rows rows of tiles c and a; padding is zero so edges need no care
+ * @note Four rows of c at a time share each row of b loaded from cache
+ */
+static inline void mtx_tile_gemm(double *restrict c, const double *restrict a, const double *restrict b,
+                                 size_t rows, size_t ts, double sign) {
+    const size_t body = rows - rows % 4;
+    for (size_t i = 0; i < body; i += 4) {
+        double *restrict c0 = c + ts * i;
+        double *restrict c1 = c0 + ts;
+        double *restrict c2 = c1 + ts;
+        double *restrict c3 = c2 + ts;
+        const double *a0 = a + ts * i;
+        for (size_t k = 0; k < ts; k++) {
+            const double x0 = sign * a0[k];
+            const double x1 = sign * a0[ts + k];
+            const double x2 = sign * a0[2 * ts + k];
+            const double x3 = sign * a0[3 * ts + k];
+            const double *bk = b + ts * k;
+            for (size_t j = 0; j < ts; j++) {
+                c0[j] += x0 * bk[j];
+                c1[j] += x1 * bk[j];
+                c2[j] += x2 * bk[j];
+                c3[j] += x3 * bk[j];
+            }
+        }
+    }
+    for (size_t i = body; i < rows; i++) {
+        for (size_t k = 0; k < ts; k++) {
+            const double x = sign * a[ts * i + k];
+            if (x != 0.0) mtx_row_axpy(c + ts * i, b + ts * k, x, ts);
+        }
+    }
+}
+
+/**
+ * @brief u := L^-1 * u on the first k rows, L the unit lower triangle of tile l
+ */
+static inline void mtx_tile_trsm(const double *restrict l, double *restrict u, size_t k, size_t ts) {
+    for (size_t r = 1; r < k; r++) {
+        for (size_t q = 0; q < r; q++) {
+            const double f = l[ts * r + q];
+            if (f != 0.0) mtx_row_axpy(u + ts * r, u + ts * q, -f, ts);
+        }
+    }
+}
+
+/**
+ * @brief Largest |t(r, lc)| for r0 <= r < r1: updates *best and sets *p to base + r if larger
+ */
+static inline void mtx_tile_pivot(const double *t, size_t ts, size_t lc, size_t r0, size_t r1,
+                                  size_t base, double *best, size_t *p) {
+    for (size_t r = r0; r < r1; r++) {
+        const double v = fabs(t[ts * r + lc]);
+        if (v > *best) {
+            *best = v;
+            *p = base + r;
+        }
+    }
+}
+
+/**
+ * @brief LU step on rows r0 <= r < r1 of a panel tile: multiplier in column lc, rank-1 update right of it
+ * @param prow Pivot row, must not be one of the updated rows
+ */
+static inline void mtx_tile_eliminate(double *restrict t, const double *restrict prow, size_t ts, size_t lc,
+                                      size_t r0, size_t r1) {
+    const double pivot = prow[lc];
+    for (size_t r = r0; r < r1; r++) {
+        double *row = t + ts * r;
+        row[lc] /= pivot;
+        if (row[lc] != 0.0 && lc + 1 < ts) {
+            mtx_row_axpy(row + lc + 1, prow + lc + 1, -row[lc], ts - lc - 1);
+        }
+    }
+}
+
+/**
+ * @brief B(r0 + r) -= sum t(r, q) * B(q0 + q) over r < rows, q < cols (off-diagonal tile)
+ */
+static inline void mtx_tile_subst(const double *t, size_t ts, matrix *B, size_t r0, size_t rows,
+                                  size_t q0, size_t cols) {
+    const size_t m = B->w;
+    for (size_t r = 0; r < rows; r++) {
+        const double *tr = t + ts * r;
+        double *br = mtx_row(B, r0 + r);
+        for (size_t q = 0; q < cols; q++) {
+            if (tr[q] != 0.0) mtx_row_axpy(br, mtx_crow(B, q0 + q), -tr[q], m);
+        }
+    }
+}
+
+/**
+ * @brief Forward substitution on rows r0 ... r0 + rows - 1 of B with the unit lower triangle of a diagonal tile
+ */
+static inline void mtx_tile_lower_subst(const double *t, size_t ts, matrix *B, size_t r0, size_t rows) {
+    const size_t m = B->w;
+    for (size_t r = 1; r < rows; r++) {
+        const double *tr = t + ts * r;
+        double *br = mtx_row(B, r0 + r);
+        for (size_t q = 0; q < r; q++) {
+            if (tr[q] != 0.0) mtx_row_axpy(br, mtx_crow(B, r0 + q), -tr[q], m);
+        }
+    }
+}
+
+/**
+ * @brief Back substitution on rows r0 ... r0 + rows - 1 of B with the upper triangle of a diagonal tile
+ */
+static inline void mtx_tile_upper_subst(const double *t, size_t ts, matrix *B, size_t r0, size_t rows) {
+    const size_t m = B->w;
+    for (size_t r = rows; r-- > 0;) {
+        const double *tr = t + ts * r;
+        double *br = mtx_row(B, r0 + r);
+        for (size_t q = r + 1; q < rows; q++) {
+            if (tr[q] != 0.0) mtx_row_axpy(br, mtx_crow(B, r0 + q), -tr[q], m);
+        }
+        for (size_t j = 0; j < m; j++) br[j] /= tr[r];
+    }
+}
+
+/**
+ * @brief Permutation structure (index vector)
+ */
+struct mtx_perm
+{
+    size_t *p;
+    size_t n;
+};
+
+/**
+ * @brief In-place Gauss-Jordan elimination with partial pivoting on [A|B]
+ * @param aug Augmented matrix (n x (n + m))
+ * @param n Order of A
+ * @param rows Identity permutation of size n on entry; pivoting swaps its
+ * entries instead of aug rows, so on success row rows->p[i] of aug holds
+ * row i of X in its right block
+ * @return 0 on success, -3 if A is singular
+ */
+int mtx_gauss_elim(matrix *aug, size_t n, mtx_perm *rows);
+
+/**
+ * @brief Fills p (len) with a + b * x for Philox samples x, uniform in [0, 1) or standard normal
+ * @param normal Nonzero for normal samples
+ * @param stream Counter high word; distinct streams under one seed are independent
+ * @note Element k depends only on (seed, stream, k), so the fill runs in
+ * parallel and gives the same data whatever the thread count
+ */
+void mtx_rand_fill(double *p, size_t len, int normal, double a, double b, uint64_t seed, uint64_t stream);
@@ -0,0 +1,51 @@
+#include <stdio.h>
+#include <pthread.h>
+#include "mtx_logs.h"
+#include "mtx_internal.h"
+
+static _Thread_local mtx_error mtx_err;
+
+static FILE *mtx_log_file = NULL;
+static pthread_once_t mtx_log_once = PTHREAD_ONCE_INIT;
+
+/* ================== Error State ================== */
+
+const mtx_error *mtx_last_error(void) {
+    return &mtx_err;
+}
+
+void mtx_clear_error(void) {
+    mtx_err.func = NULL;
+    mtx_err.msg[0] = '\0';
+}
+
+void mtx_set_error(const char *func, const char *msg) {
+    mtx_err.func = func;
+    snprintf(mtx_err.msg, sizeof(mtx_err.msg), "%s", msg);
+}
+
+/* ================== Log Output ================== */
+
+/**
+ * @brief Opens the log file once per process; stdio then locks the stream per
+ * line, so concurrent lines are written whole
+ */
+static void mtx_log_open(void) {
+    mtx_log_file = fopen(MTX_LOG_FILE, "a");
+}
+
+void mtx_log_write(int error, const char *func, const char *msg) {
+    if (error) mtx_set_error(func, msg);
+    if (!mtx_context_current()->logging) return;
+
+    pthread_once(&mtx_log_once, mtx_log_open);
+    if (error) {
+        if (mtx_log_file) {
+            fprintf(mtx_log_file, "[MTX_ERROR] %s: %s\n", func, msg);
+            fflush(mtx_log_file);
+        }
+        fprintf(stderr, "[MTX_ERROR] %s: %s\n", func, msg);
+    } else if (mtx_log_file) {
+        fprintf(mtx_log_file, "[MTX] %s\n", msg);
+    }
+}
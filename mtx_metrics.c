@@ -0,0 +1,223 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "mtx_metrics.h"
+#include "mtx_logs.h"
+
+/**
+ * @brief Counters owned by one thread
+ * Written only by the owner with relaxed load + store, read by samplers with relaxed loads.
+ */
+typedef struct mtx_metrics_block {
+    _Atomic uint64_t v[MTX_OP_COUNT][4 + MTX_METRICS_BUCKETS];
+    atomic_int in_use;
+    struct mtx_metrics_block *next;
+} mtx_metrics_block;
+
+enum { MTX_STAT_CALLS, MTX_STAT_BYTES, MTX_STAT_FLOPS, MTX_STAT_NS, MTX_STAT_HIST };
+
+static const char *mtx_metrics_names[MTX_OP_COUNT] = {
+#define MTX_METRIC_NAME(id, name) name,
+    MTX_METRIC_OPS(MTX_METRIC_NAME)
+#undef MTX_METRIC_NAME
+};
+
+static pthread_mutex_t mtx_metrics_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t mtx_metrics_once = PTHREAD_ONCE_INIT;
+static pthread_key_t mtx_metrics_key;
+static mtx_metrics_block *mtx_metrics_blocks = NULL;
+static mtx_metrics mtx_metrics_base;
+static _Thread_local mtx_metrics_block *mtx_metrics_tls = NULL;
+
+/**
+ * @brief Thread exit: the block keeps its counts and is handed to the next new thread
+ */
+static void mtx_metrics_release(void *block) {
+    atomic_store_explicit(&((mtx_metrics_block*)block)->in_use, 0, memory_order_release);
+}
+
+static void mtx_metrics_init(void) {
+    pthread_key_create(&mtx_metrics_key, mtx_metrics_release);
+}
+
+static mtx_metrics_block *mtx_metrics_acquire(void) {
+    pthread_once(&mtx_metrics_once, mtx_metrics_init);
+    pthread_mutex_lock(&mtx_metrics_lock);
+
+    mtx_metrics_block *b = mtx_metrics_blocks;
+    while (b && atomic_load_explicit(&b->in_use, memory_order_acquire)) {
+        b = b->next;
+    }
+    if (!b) {
+        b = calloc(1, sizeof(mtx_metrics_block));
+        if (b) {
+            b->next = mtx_metrics_blocks;
+            mtx_metrics_blocks = b;
+        }
+    }
+    if (b) {
+        atomic_store_explicit(&b->in_use, 1, memory_order_relaxed);
+        pthread_setspecific(mtx_metrics_key, b);
+    }
+
+    pthread_mutex_unlock(&mtx_metrics_lock);
+    return b;
+}
+
+uint64_t mtx_metrics_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static inline void mtx_metrics_bump(_Atomic uint64_t *c, uint64_t d) {
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + d, memory_order_relaxed);
+}
+
+void mtx_metrics_record(mtx_op op, uint64_t t0, uint64_t bytes, uint64_t flops) {
+    if ((unsigned)op >= MTX_OP_COUNT) return;
+
+    mtx_metrics_block *b = mtx_metrics_tls;
+    if (!b) {
+        b = mtx_metrics_tls = mtx_metrics_acquire();
+        if (!b) return;
+    }
+
+    const uint64_t ns = mtx_metrics_now() - t0;
+    unsigned bucket = 0;
+    for (uint64_t x = ns; x > 1 && bucket + 1 < MTX_METRICS_BUCKETS; x >>= 1) {
+        bucket++;
+    }
+
+    _Atomic uint64_t *v = b->v[op];
+    mtx_metrics_bump(v + MTX_STAT_CALLS, 1);
+    mtx_metrics_bump(v + MTX_STAT_BYTES, bytes);
+    mtx_metrics_bump(v + MTX_STAT_FLOPS, flops);
+    mtx_metrics_bump(v + MTX_STAT_NS, ns);
+    mtx_metrics_bump(v + MTX_STAT_HIST + bucket, 1);
+}
+
+const char *mtx_metrics_op_name(mtx_op op) {
+    if ((unsigned)op >= MTX_OP_COUNT) return "unknown";
+    return mtx_metrics_names[op];
+}
+
+/**
+ * @brief Sums raw counters of all threads; caller holds mtx_metrics_lock
+ */
+static void mtx_metrics_sum(mtx_metrics *out) {
+    memset(out, 0, sizeof(*out));
+    for (mtx_metrics_block *b = mtx_metrics_blocks; b; b = b->next) {
+        for (int op = 0; op < MTX_OP_COUNT; op++) {
+            mtx_op_stats *s = &out->op[op];
+            const _Atomic uint64_t *v = b->v[op];
+            s->calls += atomic_load_explicit(v + MTX_STAT_CALLS, memory_order_relaxed);
+            s->bytes += atomic_load_explicit(v + MTX_STAT_BYTES, memory_order_relaxed);
+            s->flops += atomic_load_explicit(v + MTX_STAT_FLOPS, memory_order_relaxed);
+            s->ns_total += atomic_load_explicit(v + MTX_STAT_NS, memory_order_relaxed);
+            for (int k = 0; k < MTX_METRICS_BUCKETS; k++) {
+                s->hist[k] += atomic_load_explicit(v + MTX_STAT_HIST + k, memory_order_relaxed);
+            }
+        }
+    }
+}
+
+int mtx_metrics_get(mtx_metrics *out) {
+    if (!out) {
+        MTX_LOG_ERROR("Null pointer in metrics snapshot");
+        return 1;
+    }
+
+    pthread_mutex_lock(&mtx_metrics_lock);
+    mtx_metrics_sum(out);
+    for (int op = 0; op < MTX_OP_COUNT; op++) {
+        mtx_op_stats *s = &out->op[op];
+        const mtx_op_stats *base = &mtx_metrics_base.op[op];
+        s->calls -= base->calls;
+        s->bytes -= base->bytes;
+        s->flops -= base->flops;
+        s->ns_total -= base->ns_total;
+        for (int k = 0; k < MTX_METRICS_BUCKETS; k++) {
+            s->hist[k] -= base->hist[k];
+        }
+    }
+    pthread_mutex_unlock(&mtx_metrics_lock);
+    return 0;
+}
+
+void mtx_metrics_reset(void) {
+    // Counters are never cleared under their owners; the current totals become the baseline
+    pthread_mutex_lock(&mtx_metrics_lock);
+    mtx_metrics_sum(&mtx_metrics_base);
+    pthread_mutex_unlock(&mtx_metrics_lock);
+}
+
+int mtx_metrics_export_json(FILE *f, const mtx_metrics *m) {
+    if (!f || !m) {
+        MTX_LOG_ERROR("Null pointer in metrics JSON export");
+        return 1;
+    }
+
+    fprintf(f, "{\"ops\":[");
+    for (int op = 0; op < MTX_OP_COUNT; op++) {
+        const mtx_op_stats *s = &m->op[op];
+        fprintf(f, "%s{\"name\":\"%s\",\"calls\":%llu,\"bytes\":%llu,\"flops\":%llu,"
+                   "\"seconds_total\":%.9f,\"histogram_ns\":[",
+                op ? "," : "", mtx_metrics_names[op],
+                (unsigned long long)s->calls, (unsigned long long)s->bytes,
+                (unsigned long long)s->flops, (double)s->ns_total * 1e-9);
+        for (int k = 0; k < MTX_METRICS_BUCKETS; k++) {
+            fprintf(f, "%s%llu", k ? "," : "", (unsigned long long)s->hist[k]);
+        }
+        fprintf(f, "]}");
+    }
+    fprintf(f, "]}\n");
+
+    return ferror(f) ? -1 : 0;
+}
+
+int mtx_metrics_export_prometheus(FILE *f, const mtx_metrics *m) {
+    if (!f || !m) {
+        MTX_LOG_ERROR("Null pointer in metrics Prometheus export");
+        return 1;
+    }
+
+    static const struct {
+        const char *name, *help;
+        size_t offset;
+    } counters[] = {
+        {"mtx_calls_total", "Completed calls", offsetof(mtx_op_stats, calls)},
+        {"mtx_bytes_total", "Bytes read and written", offsetof(mtx_op_stats, bytes)},
+        {"mtx_flops_total", "Floating point operations", offsetof(mtx_op_stats, flops)},
+    };
+
+    for (size_t c = 0; c < sizeof(counters) / sizeof(counters[0]); c++) {
+        fprintf(f, "# HELP %s %s\n# TYPE %s counter\n", counters[c].name, counters[c].help, counters[c].name);
+        for (int op = 0; op < MTX_OP_COUNT; op++) {
+            const uint64_t *v = (const uint64_t*)((const char*)&m->op[op] + counters[c].offset);
+            fprintf(f, "%s{op=\"%s\"} %llu\n", counters[c].name, mtx_metrics_names[op], (unsigned long long)*v);
+        }
+    }
+
+    fprintf(f, "# HELP mtx_latency_seconds Call latency\n# TYPE mtx_latency_seconds histogram\n");
+    for (int op = 0; op < MTX_OP_COUNT; op++) {
+        const mtx_op_stats *s = &m->op[op];
+        uint64_t cumulative = 0;
+        for (int k = 0; k + 1 < MTX_METRICS_BUCKETS; k++) {
+            cumulative += s->hist[k];
+            fprintf(f, "mtx_latency_seconds_bucket{op=\"%s\",le=\"%.9g\"} %llu\n",
+                    mtx_metrics_names[op], (double)(2ull << k) * 1e-9, (unsigned long long)cumulative);
+        }
+        fprintf(f, "mtx_latency_seconds_bucket{op=\"%s\",le=\"+Inf\"} %llu\n",
+                mtx_metrics_names[op], (unsigned long long)s->calls);
+        fprintf(f, "mtx_latency_seconds_sum{op=\"%s\"} %.9f\n", mtx_metrics_names[op], (double)s->ns_total * 1e-9);
+        fprintf(f, "mtx_latency_seconds_count{op=\"%s\"} %llu\n", mtx_metrics_names[op], (unsigned long long)s->calls);
+    }
+
+    return ferror(f) ? -1 : 0;
+}
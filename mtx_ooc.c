@@ -0,0 +1,659 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include "mtx_ooc.h"
+#include "mtx_logs.h"
+#include "mtx_metrics.h"
+#include "mtx_internal.h"
+
+static const char mtx_ooc_magic[8] = {'M', 'T', 'X', 'T', 'I', 'L', 'E', '1'};
+
+/**
+ * @brief Cached tile
+ */
+typedef struct {
+    double *data;
+    size_t index;               // ti * ntw + tj
+    int used, dirty, pins;
+    unsigned long long stamp;   // last use, for LRU eviction
+} mtx_ooc_slot;
+
+struct mtx_ooc
+{
+    int fd;
+    size_t w, h, tile;
+    size_t nth, ntw;            // tile rows and columns
+    size_t nslots;
+    mtx_ooc_slot *slots;
+    long *where;                // tile index -> slot, -1 if not cached
+    unsigned long long clock;
+};
+
+/**
+ * @brief Tile access modes
+ */
+enum { MTX_OOC_READ, MTX_OOC_RW, MTX_OOC_OVERWRITE };
+
+static size_t mtx_ooc_tile_bytes(const mtx_ooc *m) {
+    return m->tile * m->tile * sizeof(double);
+}
+
+static off_t mtx_ooc_offset(const mtx_ooc *m, size_t index) {
+    return (off_t)MTX_OOC_HEADER + (off_t)index * (off_t)mtx_ooc_tile_bytes(m);
+}
+
+static int mtx_ooc_pread(int fd, void *buf, size_t len, off_t off) {
+    char *p = buf;
+    while (len > 0) {
+        ssize_t r = pread(fd, p, len, off);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return -1;
+        p += r;
+        len -= (size_t)r;
+        off += r;
+    }
+    return 0;
+}
+
+static int mtx_ooc_pwrite(int fd, const void *buf, size_t len, off_t off) {
+    const char *p = buf;
+    while (len > 0) {
+        ssize_t r = pwrite(fd, p, len, off);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return -1;
+        p += r;
+        len -= (size_t)r;
+        off += r;
+    }
+    return 0;
+}
+
+static int mtx_ooc_writeback(mtx_ooc *m, mtx_ooc_slot *s) {
+    if (!s->used || !s->dirty) return 0;
+    if (mtx_ooc_pwrite(m->fd, s->data, mtx_ooc_tile_bytes(m), mtx_ooc_offset(m, s->index)) != 0) {
+        MTX_LOG_ERROR("Tile write failed");
+        return -1;
+    }
+    s->dirty = 0;
+    return 0;
+}
+
+/**
+ * @brief Returns a pinned pointer to tile (ti, tj), loading it if needed
+ * @return Tile data, NULL on I/O error or if every slot is pinned
+ */
+static double *mtx_ooc_get(mtx_ooc *m, size_t ti, size_t tj, int mode) {
+    const size_t index = m->ntw * ti + tj;
+    mtx_ooc_slot *s;
+
+    if (m->where[index] >= 0) {
+        s = &m->slots[m->where[index]];
+    } else {
+        // Least recently used unpinned slot
+        s = NULL;
+        for (size_t i = 0; i < m->nslots; i++) {
+            mtx_ooc_slot *c = &m->slots[i];
+            if (c->pins) continue;
+            if (!c->used) {
+                s = c;
+                break;
+            }
+            if (!s || c->stamp < s->stamp) s = c;
+        }
+        if (!s) {
+            MTX_LOG_ERROR("Tile cache exhausted: all tiles pinned");
+            return NULL;
+        }
+
+        if (s->used) {
+            if (mtx_ooc_writeback(m, s) != 0) return NULL;
+            m->where[s->index] = -1;
+            s->used = 0;
+        }
+        if (!s->data) {
+            s->data = malloc(mtx_ooc_tile_bytes(m));
+            if (!s->data) {
+                MTX_LOG_ERROR("Tile allocation failed");
+                return NULL;
+            }
+        }
+
+        if (mode == MTX_OOC_OVERWRITE) {
+            memset(s->data, 0, mtx_ooc_tile_bytes(m));
+        } else if (mtx_ooc_pread(m->fd, s->data, mtx_ooc_tile_bytes(m), mtx_ooc_offset(m, index)) != 0) {
+            MTX_LOG_ERROR("Tile read failed");
+            return NULL;
+        }
+
+        s->index = index;
+        s->used = 1;
+        s->dirty = 0;
+        m->where[index] = s - m->slots;
+    }
+
+    s->pins++;
+    s->stamp = ++m->clock;
+    if (mode != MTX_OOC_READ) s->dirty = 1;
+    return s->data;
+}
+
+/**
+ * @brief Unpins tile (ti, tj)
+ */
+static void mtx_ooc_put(mtx_ooc *m, size_t ti, size_t tj) {
+    long slot = m->where[m->ntw * ti + tj];
+    if (slot >= 0 && m->slots[slot].pins > 0) m->slots[slot].pins--;
+}
+
+/**
+ * @brief Starts asynchronous readahead of tile (ti, tj) if it is not cached
+ */
+static void mtx_ooc_prefetch(mtx_ooc *m, size_t ti, size_t tj) {
+    if (ti >= m->nth || tj >= m->ntw) return;
+    const size_t index = m->ntw * ti + tj;
+    if (m->where[index] >= 0) return;
+    posix_fadvise(m->fd, mtx_ooc_offset(m, index), (off_t)mtx_ooc_tile_bytes(m), POSIX_FADV_WILLNEED);
+}
+
+static mtx_ooc *mtx_ooc_new(int fd, size_t w, size_t h, size_t tile, size_t cache_bytes) {
+    mtx_ooc *m = calloc(1, sizeof(mtx_ooc));
+    if (!m) return NULL;
+
+    m->fd = fd;
+    m->w = w;
+    m->h = h;
+    m->tile = tile;
+    m->nth = (h + tile - 1) / tile;
+    m->ntw = (w + tile - 1) / tile;
+    m->nslots = cache_bytes / mtx_ooc_tile_bytes(m);
+    if (m->nslots < MTX_OOC_MIN_TILES) m->nslots = MTX_OOC_MIN_TILES;
+    if (m->nslots > m->nth * m->ntw) m->nslots = m->nth * m->ntw;
+
+    m->slots = calloc(m->nslots, sizeof(mtx_ooc_slot));
+    m->where = malloc(m->nth * m->ntw * sizeof(long));
+    if (!m->slots || !m->where) {
+        free(m->slots);
+        free(m->where);
+        free(m);
+        return NULL;
+    }
+    for (size_t i = 0; i < m->nth * m->ntw; i++) m->where[i] = -1;
+    return m;
+}
+
+mtx_ooc *mtx_ooc_create(const char *path, size_t w, size_t h, size_t tile, size_t cache_bytes) {
+    if (!path || w == 0 || h == 0 || tile == 0) {
+        MTX_LOG_ERROR("Invalid arguments for tile file creation");
+        return NULL;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        MTX_LOG_ERROR("Failed to create tile file");
+        return NULL;
+    }
+
+    unsigned char header[MTX_OOC_HEADER] = {0};
+    uint64_t dims[3] = {h, w, tile};
+    memcpy(header, mtx_ooc_magic, sizeof(mtx_ooc_magic));
+    memcpy(header + sizeof(mtx_ooc_magic), dims, sizeof(dims));
+
+    mtx_ooc *m = mtx_ooc_new(fd, w, h, tile, cache_bytes);
+    if (!m || mtx_ooc_pwrite(fd, header, sizeof(header), 0) != 0 ||
+        ftruncate(fd, mtx_ooc_offset(m, m->nth * m->ntw)) != 0) {
+        MTX_LOG_ERROR("Failed to initialize tile file");
+        if (m) {
+            free(m->slots);
+            free(m->where);
+            free(m);
+        }
+        close(fd);
+        return NULL;
+    }
+
+    MTX_LOG("Tile file created");
+    return m;
+}
+
+mtx_ooc *mtx_ooc_open(const char *path, size_t cache_bytes) {
+    if (!path) {
+        MTX_LOG_ERROR("Null path in tile file open");
+        return NULL;
+    }
+
+    int fd = open(path, O_RDWR);
+    if (fd < 0) {
+        MTX_LOG_ERROR("Failed to open tile file");
+        return NULL;
+    }
+
+    unsigned char header[sizeof(mtx_ooc_magic) + 3 * sizeof(uint64_t)];
+    uint64_t dims[3];
+    if (mtx_ooc_pread(fd, header, sizeof(header), 0) != 0 ||
+        memcmp(header, mtx_ooc_magic, sizeof(mtx_ooc_magic)) != 0) {
+        MTX_LOG_ERROR("Not a tile file");
+        close(fd);
+        return NULL;
+    }
+    memcpy(dims, header + sizeof(mtx_ooc_magic), sizeof(dims));
+    if (dims[0] == 0 || dims[1] == 0 || dims[2] == 0) {
+        MTX_LOG_ERROR("Corrupted tile file header");
+        close(fd);
+        return NULL;
+    }
+
+    mtx_ooc *m = mtx_ooc_new(fd, dims[1], dims[0], dims[2], cache_bytes);
+    if (!m) {
+        MTX_LOG_ERROR("Failed to allocate tile cache");
+        close(fd);
+        return NULL;
+    }
+
+    MTX_LOG("Tile file opened");
+    return m;
+}
+
+int mtx_ooc_flush(mtx_ooc *m) {
+    if (!m) {
+        MTX_LOG_ERROR("Null tile file in flush");
+        return 1;
+    }
+
+    int rc = 0;
+    for (size_t i = 0; i < m->nslots; i++) {
+        if (mtx_ooc_writeback(m, &m->slots[i]) != 0) rc = -1;
+    }
+    return rc;
+}
+
+int mtx_ooc_close(mtx_ooc *m) {
+    if (!m) return 0;
+
+    int rc = mtx_ooc_flush(m);
+    for (size_t i = 0; i < m->nslots; i++) free(m->slots[i].data);
+    free(m->slots);
+    free(m->where);
+    if (close(m->fd) != 0) rc = -1;
+    free(m);
+
+    MTX_LOG("Tile file closed");
+    return rc;
+}
+
+size_t mtx_ooc_get_width(const mtx_ooc *m) {
+    if (!m) {
+        MTX_LOG_ERROR("Tile file is Null. Width cannot be gotten");
+        return 0;
+    }
+    return m->w;
+}
+
+size_t mtx_ooc_get_height(const mtx_ooc *m) {
+    if (!m) {
+        MTX_LOG_ERROR("Tile file is Null. Height cannot be gotten");
+        return 0;
+    }
+    return m->h;
+}
+
+size_t mtx_ooc_get_tile(const mtx_ooc *m) {
+    if (!m) {
+        MTX_LOG_ERROR("Tile file is Null. Tile size cannot be gotten");
+        return 0;
+    }
+    return m->tile;
+}
+
+int mtx_ooc_read_tile(mtx_ooc *m, size_t ti, size_t tj, double *buf) {
+    if (!m || !buf) {
+        MTX_LOG_ERROR("Null pointer in tile read");
+        return 1;
+    }
+    if (ti >= m->nth || tj >= m->ntw) {
+        MTX_LOG_ERROR("Invalid tile index in read");
+        return -1;
+    }
+
+    double *t = mtx_ooc_get(m, ti, tj, MTX_OOC_READ);
+    if (!t) return -2;
+    memcpy(buf, t, mtx_ooc_tile_bytes(m));
+    mtx_ooc_put(m, ti, tj);
+    return 0;
+}
+
+int mtx_ooc_write_tile(mtx_ooc *m, size_t ti, size_t tj, const double *buf) {
+    if (!m || !buf) {
+        MTX_LOG_ERROR("Null pointer in tile write");
+        return 1;
+    }
+    if (ti >= m->nth || tj >= m->ntw) {
+        MTX_LOG_ERROR("Invalid tile index in write");
+        return -1;
+    }
+
+    double *t = mtx_ooc_get(m, ti, tj, MTX_OOC_OVERWRITE);
+    if (!t) return -2;
+    memcpy(t, buf, mtx_ooc_tile_bytes(m));
+    mtx_ooc_put(m, ti, tj);
+    return 0;
+}
+
+int mtx_ooc_from_matrix(mtx_ooc *dst, const matrix *src) {
+    if (!dst || !src || !src->data) {
+        MTX_LOG_ERROR("Null pointer in tile file load");
+        return 1;
+    }
+    if (dst->w != src->w || dst->h != src->h) {
+        MTX_LOG_ERROR("Matrix size mismatch in tile file load");
+        return -1;
+    }
+
+    const size_t ts = dst->tile;
+    for (size_t ti = 0; ti < dst->nth; ti++) {
+        for (size_t tj = 0; tj < dst->ntw; tj++) {
+            double *t = mtx_ooc_get(dst, ti, tj, MTX_OOC_OVERWRITE);
+            if (!t) return -2;
+
+            const size_t rows = src->h - ti * ts < ts ? src->h - ti * ts : ts;
+            const size_t cols = src->w - tj * ts < ts ? src->w - tj * ts : ts;
+            for (size_t r = 0; r < rows; r++) {
+                memcpy(t + ts * r, mtx_cat(src, ti * ts + r, tj * ts), cols * sizeof(double));
+            }
+            mtx_ooc_put(dst, ti, tj);
+        }
+    }
+
+    MTX_LOG("Matrix stored to tile file");
+    return 0;
+}
+
+int mtx_ooc_to_matrix(matrix *dst, mtx_ooc *src) {
+    if (!dst || !dst->data || !src) {
+        MTX_LOG_ERROR("Null pointer in tile file store");
+        return 1;
+    }
+    if (dst->w != src->w || dst->h != src->h) {
+        MTX_LOG_ERROR("Matrix size mismatch in tile file store");
+        return -1;
+    }
+    if (mtx_unshare(dst, 1) != 0) return -2;
+
+    const size_t ts = src->tile;
+    for (size_t ti = 0; ti < src->nth; ti++) {
+        for (size_t tj = 0; tj < src->ntw; tj++) {
+            mtx_ooc_prefetch(src, ti, tj + 1);
+            const double *t = mtx_ooc_get(src, ti, tj, MTX_OOC_READ);
+            if (!t) return -2;
+
+            const size_t rows = dst->h - ti * ts < ts ? dst->h - ti * ts : ts;
+            const size_t cols = dst->w - tj * ts < ts ? dst->w - tj * ts : ts;
+            for (size_t r = 0; r < rows; r++) {
+                memcpy(mtx_at(dst, ti * ts + r, tj * ts), t + ts * r, cols * sizeof(double));
+            }
+            mtx_ooc_put(src, ti, tj);
+        }
+    }
+
+    MTX_LOG("Tile file loaded to matrix");
+    return 0;
+}
+
+/**
+ * @brief c += sign * a * b for full tiles (ts x ts), four-row groups spread over the threads
+ */
+static void mtx_ooc_gemm(double *restrict c, const double *restrict a, const double *restrict b,
+                         size_t ts, double sign) {
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < ts; i += 4) {
+        mtx_tile_gemm(c + ts * i, a + ts * i, b, ts - i < 4 ? ts - i : 4, ts, sign);
+    }
+}
+
+int mtx_ooc_mul(mtx_ooc *C, mtx_ooc *A, mtx_ooc *B) {
+    MTX_METRIC_BEGIN(OOC_MUL);
+    if (!C || !A || !B) {
+        MTX_LOG_ERROR("Null tile file in multiplication");
+        return 1;
+    }
+    if (C == A || C == B) {
+        MTX_LOG_ERROR("Output tile file aliases an operand");
+        return -1;
+    }
+    if (A->w != B->h || C->h != A->h || C->w != B->w ||
+        A->tile != B->tile || A->tile != C->tile) {
+        MTX_LOG_ERROR("Tile file size mismatch in multiplication");
+        return -1;
+    }
+
+    const size_t ts = A->tile;
+    for (size_t ti = 0; ti < C->nth; ti++) {
+        for (size_t tj = 0; tj < C->ntw; tj++) {
+            double *c = mtx_ooc_get(C, ti, tj, MTX_OOC_OVERWRITE);
+            if (!c) return -2;
+
+            for (size_t tk = 0; tk < A->ntw; tk++) {
+                // Next step's operands stream in while this product runs
+                if (tk + 1 < A->ntw) {
+                    mtx_ooc_prefetch(A, ti, tk + 1);
+                    mtx_ooc_prefetch(B, tk + 1, tj);
+                } else {
+                    mtx_ooc_prefetch(A, tj + 1 < C->ntw ? ti : ti + 1, 0);
+                    mtx_ooc_prefetch(B, 0, tj + 1 < C->ntw ? tj + 1 : 0);
+                }
+
+                const double *a = mtx_ooc_get(A, ti, tk, MTX_OOC_READ);
+                const double *b = a ? mtx_ooc_get(B, tk, tj, MTX_OOC_READ) : NULL;
+                if (!a || !b) {
+                    if (a) mtx_ooc_put(A, ti, tk);
+                    mtx_ooc_put(C, ti, tj);
+                    return -2;
+                }
+                mtx_ooc_gemm(c, a, b, ts, 1.0);
+                mtx_ooc_put(A, ti, tk);
+                mtx_ooc_put(B, tk, tj);
+            }
+            mtx_ooc_put(C, ti, tj);
+        }
+    }
+
+    MTX_METRIC_END(OOC_MUL, MTX_MUL_BYTES(C->h, A->w, C->w), MTX_MUL_FLOPS(C->h, A->w, C->w));
+    MTX_LOG("Tiled multiplication completed");
+    return 0;
+}
+
+/**
+ * @brief Swaps global rows r1 and r2 inside tile column tj
+ */
+static int mtx_ooc_swap_rows(mtx_ooc *m, size_t tj, size_t r1, size_t r2) {
+    const size_t ts = m->tile;
+    double *t1 = mtx_ooc_get(m, r1 / ts, tj, MTX_OOC_RW);
+    if (!t1) return -2;
+    double *t2 = mtx_ooc_get(m, r2 / ts, tj, MTX_OOC_RW);
+    if (!t2) {
+        mtx_ooc_put(m, r1 / ts, tj);
+        return -2;
+    }
+
+    mtx_row_swap(t1 + ts * (r1 % ts), t2 + ts * (r2 % ts), ts);
+    mtx_ooc_put(m, r1 / ts, tj);
+    mtx_ooc_put(m, r2 / ts, tj);
+    return 0;
+}
+
+/**
+ * @brief Factors tile column K in place (unblocked LU with partial pivoting on the panel)
+ */
+static int mtx_ooc_panel(mtx_ooc *A, size_t K, size_t *piv, double *prow) {
+    const size_t ts = A->tile, n = A->h;
+    const size_t c0 = K * ts;
+    const size_t c1 = c0 + ts < n ? c0 + ts : n;
+
+    for (size_t c = c0; c < c1; c++) {
+        const size_t lc = c - c0;
+
+        // Pivot search down column c
+        size_t p = c;
+        double best = -1.0;
+        for (size_t I = c / ts; I < A->nth; I++) {
+            const double *t = mtx_ooc_get(A, I, K, MTX_OOC_READ);
+            if (!t) return -2;
+            const size_t b0 = I * ts;
+            mtx_tile_pivot(t, ts, lc, (b0 > c ? b0 : c) - b0, n - b0 < ts ? n - b0 : ts, b0, &best, &p);
+            mtx_ooc_put(A, I, K);
+        }
+
+        piv[c] = p;
+        if (p != c && mtx_ooc_swap_rows(A, K, c, p) != 0) return -2;
+        if (best < MTX_MIN_DIVISOR) {
+            MTX_LOG_ERROR("Matrix is singular (zero pivot)");
+            return -3;
+        }
+
+        const double *tc = mtx_ooc_get(A, c / ts, K, MTX_OOC_READ);
+        if (!tc) return -2;
+        memcpy(prow, tc + ts * (c % ts), ts * sizeof(double));
+        mtx_ooc_put(A, c / ts, K);
+
+        // Multipliers and rank-1 update of the rest of the panel
+        for (size_t I = c / ts; I < A->nth; I++) {
+            double *t = mtx_ooc_get(A, I, K, MTX_OOC_RW);
+            if (!t) return -2;
+            const size_t b0 = I * ts;
+            mtx_tile_eliminate(t, prow, ts, lc, (b0 > c + 1 ? b0 : c + 1) - b0, n - b0 < ts ? n - b0 : ts);
+            mtx_ooc_put(A, I, K);
+        }
+    }
+    return 0;
+}
+
+int mtx_ooc_lu(mtx_ooc *A, size_t *piv) {
+    MTX_METRIC_BEGIN(OOC_LU);
+    if (!A || !piv) {
+        MTX_LOG_ERROR("Null pointer in tiled LU");
+        return 1;
+    }
+    if (A->w != A->h) {
+        MTX_LOG_ERROR("Tiled LU requires a square matrix");
+        return -1;
+    }
+
+    const size_t ts = A->tile, n = A->h, nt = A->nth;
+    double *prow = malloc(ts * sizeof(double));
+    if (!prow) {
+        MTX_LOG_ERROR("Allocation in tiled LU failed");
+        return -2;
+    }
+
+    int rc = 0;
+    for (size_t K = 0; K < nt && rc == 0; K++) {
+        const size_t c0 = K * ts;
+        const size_t c1 = c0 + ts < n ? c0 + ts : n;
+
+        rc = mtx_ooc_panel(A, K, piv, prow);
+        if (rc != 0) break;
+
+        // Apply this panel's interchanges to every other tile column
+        for (size_t J = 0; J < nt && rc == 0; J++) {
+            if (J == K) continue;
+            for (size_t c = c0; c < c1 && rc == 0; c++) {
+                if (piv[c] != c) rc = mtx_ooc_swap_rows(A, J, c, piv[c]);
+            }
+        }
+        if (rc != 0) break;
+
+        const double *lkk = mtx_ooc_get(A, K, K, MTX_OOC_READ);
+        if (!lkk) {
+            rc = -2;
+            break;
+        }
+
+        for (size_t J = K + 1; J < nt && rc == 0; J++) {
+            // U(K, J) = L(K, K)^-1 * A(K, J)
+            double *u = mtx_ooc_get(A, K, J, MTX_OOC_RW);
+            if (!u) {
+                rc = -2;
+                break;
+            }
+            mtx_tile_trsm(lkk, u, c1 - c0, ts);
+            mtx_ooc_put(A, K, J);
+
+            // A(I, J) -= L(I, K) * U(K, J)
+            for (size_t I = K + 1; I < nt; I++) {
+                mtx_ooc_prefetch(A, I + 1 < nt ? I + 1 : K + 1, I + 1 < nt ? J : J + 1);
+
+                const double *l = mtx_ooc_get(A, I, K, MTX_OOC_READ);
+                const double *uk = l ? mtx_ooc_get(A, K, J, MTX_OOC_READ) : NULL;
+                double *a = uk ? mtx_ooc_get(A, I, J, MTX_OOC_RW) : NULL;
+                if (!a) {
+                    if (uk) mtx_ooc_put(A, K, J);
+                    if (l) mtx_ooc_put(A, I, K);
+                    rc = -2;
+                    break;
+                }
+                mtx_ooc_gemm(a, l, uk, ts, -1.0);
+                mtx_ooc_put(A, I, J);
+                mtx_ooc_put(A, K, J);
+                mtx_ooc_put(A, I, K);
+            }
+        }
+        mtx_ooc_put(A, K, K);
+    }
+
+    free(prow);
+    if (rc == 0) {
+        MTX_METRIC_END(OOC_LU, 2 * n * n * sizeof(double), 2 * n * n * n / 3);
+        MTX_LOG("Tiled LU factorization completed");
+    } else if (rc == -2) MTX_LOG_ERROR("Tiled LU failed on tile I/O");
+    return rc;
+}
+
+int mtx_ooc_lu_solve(mtx_ooc *LU, const size_t *piv, matrix *B) {
+    if (!LU || !piv || !B || !B->data) {
+        MTX_LOG_ERROR("Null pointer in tiled LU solve");
+        return 1;
+    }
+    if (LU->w != LU->h || LU->h != B->h) {
+        MTX_LOG_ERROR("Size mismatch in tiled LU solve");
+        return -1;
+    }
+    if (mtx_unshare(B, 1) != 0) return -2;
+
+    const size_t ts = LU->tile, n = LU->h, nt = LU->nth, m = B->w;
+
+    for (size_t c = 0; c < n; c++) {
+        if (piv[c] != c) mtx_row_swap(mtx_row(B, c), mtx_row(B, piv[c]), m);
+    }
+
+    // Forward substitution with unit lower L
+    for (size_t I = 0; I < nt; I++) {
+        const size_t r0 = I * ts, rows = n - r0 < ts ? n - r0 : ts;
+        for (size_t J = 0; J <= I; J++) {
+            mtx_ooc_prefetch(LU, J < I ? I : I + 1, J < I ? J + 1 : 0);
+            const double *t = mtx_ooc_get(LU, I, J, MTX_OOC_READ);
+            if (!t) return -2;
+            if (J < I) mtx_tile_subst(t, ts, B, r0, rows, J * ts, ts);
+            else mtx_tile_lower_subst(t, ts, B, r0, rows);
+            mtx_ooc_put(LU, I, J);
+        }
+    }
+
+    // Backward substitution with U
+    for (size_t I = nt; I-- > 0;) {
+        const size_t r0 = I * ts, rows = n - r0 < ts ? n - r0 : ts;
+        for (size_t J = nt; J-- > I;) {
+            const double *t = mtx_ooc_get(LU, I, J, MTX_OOC_READ);
+            if (!t) return -2;
+            if (J > I) mtx_tile_subst(t, ts, B, r0, rows, J * ts, n - J * ts < ts ? n - J * ts : ts);
+            else mtx_tile_upper_subst(t, ts, B, r0, rows);
+            mtx_ooc_put(LU, I, J);
+        }
+    }
+
+    MTX_LOG("Tiled LU solve completed");
+    return 0;
+}
@@ -0,0 +1,280 @@
+#include <stdlib.h>
+#include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "mtx_perm.h"
+#include "mtx_logs.h"
+#include "mtx_metrics.h"
+#include "mtx_internal.h"
+
+mtx_perm *mtx_perm_alloc(size_t n) {
+    if (n == 0) {
+        MTX_LOG_ERROR("Attempt to allocate empty permutation");
+        return NULL;
+    }
+
+    mtx_perm *p = malloc(sizeof(mtx_perm));
+    if (!p) {
+        MTX_LOG_ERROR("Failed to allocate permutation struct");
+        return NULL;
+    }
+
+    p->p = malloc(n * sizeof(size_t));
+    if (!p->p) {
+        MTX_LOG_ERROR("Failed to allocate permutation data");
+        free(p);
+        return NULL;
+    }
+
+    p->n = n;
+    mtx_perm_set_id(p);
+    return p;
+}
+
+mtx_perm *mtx_perm_copy(const mtx_perm *p) {
+    if (!p) {
+        MTX_LOG_ERROR("Invalid source permutation for copy");
+        return NULL;
+    }
+
+    mtx_perm *c = mtx_perm_alloc(p->n);
+    if (!c) return NULL;
+    memcpy(c->p, p->p, p->n * sizeof(size_t));
+    return c;
+}
+
+void mtx_perm_free(mtx_perm *p) {
+    if (!p) return;
+    free(p->p);
+    free(p);
+}
+
+void mtx_perm_set_id(mtx_perm *p) {
+    if (!p) {
+        MTX_LOG_ERROR("Null permutation in set_id");
+        return;
+    }
+    for (size_t i = 0; i < p->n; i++) p->p[i] = i;
+}
+
+size_t mtx_perm_size(const mtx_perm *p) {
+    if (!p) {
+        MTX_LOG_ERROR("Permutation is Null. Size cannot be gotten");
+        return 0;
+    }
+    return p->n;
+}
+
+size_t mtx_perm_get(const mtx_perm *p, size_t i) {
+    if (!p || i >= p->n) {
+        MTX_LOG_ERROR("Invalid permutation access attempt");
+        return i;
+    }
+    return p->p[i];
+}
+
+int mtx_perm_swap(mtx_perm *p, size_t i, size_t j) {
+    if (!p) {
+        MTX_LOG_ERROR("Null permutation in swap");
+        return 1;
+    }
+    if (i >= p->n || j >= p->n) {
+        MTX_LOG_ERROR("Invalid indices in permutation swap");
+        return -1;
+    }
+
+    size_t tmp = p->p[i];
+    p->p[i] = p->p[j];
+    p->p[j] = tmp;
+    return 0;
+}
+
+int mtx_perm_compose(mtx_perm *res, const mtx_perm *a, const mtx_perm *b) {
+    if (!res || !a || !b) {
+        MTX_LOG_ERROR("Null permutation in compose");
+        return 1;
+    }
+    if (a->n != b->n || res->n != a->n) {
+        MTX_LOG_ERROR("Permutation size mismatch in compose");
+        return -1;
+    }
+
+    size_t *out = malloc(a->n * sizeof(size_t));
+    if (!out) {
+        MTX_LOG_ERROR("Allocation in permutation compose failed");
+        return -2;
+    }
+
+    // Row i of A*(B*M) is row a[i] of B*M, which is row b[a[i]] of M
+    for (size_t i = 0; i < a->n; i++) out[i] = b->p[a->p[i]];
+    memcpy(res->p, out, a->n * sizeof(size_t));
+    free(out);
+    return 0;
+}
+
+int mtx_perm_inverse(mtx_perm *res, const mtx_perm *p) {
+    if (!res || !p) {
+        MTX_LOG_ERROR("Null permutation in inverse");
+        return 1;
+    }
+    if (res->n != p->n) {
+        MTX_LOG_ERROR("Permutation size mismatch in inverse");
+        return -1;
+    }
+
+    size_t *out = malloc(p->n * sizeof(size_t));
+    if (!out) {
+        MTX_LOG_ERROR("Allocation in permutation inverse failed");
+        return -2;
+    }
+
+    for (size_t i = 0; i < p->n; i++) out[p->p[i]] = i;
+    memcpy(res->p, out, p->n * sizeof(size_t));
+    free(out);
+    return 0;
+}
+
+int mtx_perm_rows(matrix *dst, const mtx_perm *p, const matrix *src) {
+    if (!dst || !dst->data || !p || !src || !src->data) {
+        MTX_LOG_ERROR("Null pointer in row permutation");
+        return 1;
+    }
+    if (p->n != src->h || dst->w != src->w || dst->h != src->h || dst == src) {
+        MTX_LOG_ERROR("Size mismatch in row permutation");
+        return -1;
+    }
+    if (mtx_unshare(dst, 1) != 0) return -2;
+
+    const size_t w = src->w;
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < src->h; i++) {
+        memcpy(mtx_row(dst, i), mtx_crow(src, p->p[i]), w * sizeof(double));
+    }
+
+    MTX_LOG("Rows were permuted");
+    return 0;
+}
+
+int mtx_perm_cols(matrix *dst, const mtx_perm *p, const matrix *src) {
+    if (!dst || !dst->data || !p || !src || !src->data) {
+        MTX_LOG_ERROR("Null pointer in column permutation");
+        return 1;
+    }
+    if (p->n != src->w || dst->w != src->w || dst->h != src->h || dst == src) {
+        MTX_LOG_ERROR("Size mismatch in column permutation");
+        return -1;
+    }
+    if (mtx_unshare(dst, 1) != 0) return -2;
+
+    const size_t w = src->w;
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < src->h; i++) {
+        double *restrict d = mtx_row(dst, i);
+        const double *restrict s = mtx_crow(src, i);
+        for (size_t j = 0; j < w; j++) d[j] = s[p->p[j]];
+    }
+
+    MTX_LOG("Columns were permuted");
+    return 0;
+}
+
+int mtx_perm_rows_inplace(matrix *mtx, const mtx_perm *p) {
+    if (!mtx || !mtx->data || !p) {
+        MTX_LOG_ERROR("Null pointer in row permutation");
+        return 1;
+    }
+    if (p->n != mtx->h) {
+        MTX_LOG_ERROR("Size mismatch in row permutation");
+        return -1;
+    }
+    if (mtx_unshare(mtx, 1) != 0) return -2;
+
+    const size_t n = mtx->h, w = mtx->w;
+    unsigned char *done = calloc(n, 1);
+    double *tmp = malloc(w * sizeof(double));
+    if (!done || !tmp) {
+        free(done);
+        free(tmp);
+        MTX_LOG_ERROR("Allocation in row permutation failed");
+        return -2;
+    }
+
+    // Each cycle i <- p[i] <- p[p[i]] ... moves every row once
+    for (size_t i = 0; i < n; i++) {
+        if (done[i] || p->p[i] == i) continue;
+        memcpy(tmp, mtx_crow(mtx, i), w * sizeof(double));
+        size_t k = i;
+        while (p->p[k] != i) {
+            memcpy(mtx_row(mtx, k), mtx_crow(mtx, p->p[k]), w * sizeof(double));
+            done[k] = 1;
+            k = p->p[k];
+        }
+        memcpy(mtx_row(mtx, k), tmp, w * sizeof(double));
+        done[k] = 1;
+    }
+
+    free(done);
+    free(tmp);
+    MTX_LOG("Rows were permuted");
+    return 0;
+}
+
+int mtx_perm_cols_inplace(matrix *mtx, const mtx_perm *p) {
+    if (!mtx || !mtx->data || !p) {
+        MTX_LOG_ERROR("Null pointer in column permutation");
+        return 1;
+    }
+    if (p->n != mtx->w) {
+        MTX_LOG_ERROR("Size mismatch in column permutation");
+        return -1;
+    }
+    if (mtx_unshare(mtx, 1) != 0) return -2;
+
+    const size_t w = mtx->w;
+#ifdef _OPENMP
+    const size_t nthreads = (size_t)omp_get_max_threads();
+#else
+    const size_t nthreads = 1;
+#endif
+    double *buf = malloc(nthreads * w * sizeof(double));
+    if (!buf) {
+        MTX_LOG_ERROR("Allocation in column permutation failed");
+        return -2;
+    }
+
+    #pragma omp parallel num_threads(nthreads)
+    {
+#ifdef _OPENMP
+        double *tmp = buf + w * (size_t)omp_get_thread_num();
+#else
+        double *tmp = buf;
+#endif
+        #pragma omp for schedule(static)
+        for (size_t i = 0; i < mtx->h; i++) {
+            double *row = mtx_row(mtx, i);
+            for (size_t j = 0; j < w; j++) tmp[j] = row[p->p[j]];
+            memcpy(row, tmp, w * sizeof(double));
+        }
+    }
+
+    free(buf);
+    MTX_LOG("Columns were permuted");
+    return 0;
+}
+
+int mtx_perm_mul(matrix *res, const mtx_perm *p, const matrix *A, const matrix *B) {
+    if (!res || !res->data || !p || !A || !A->data || !B || !B->data) {
+        MTX_LOG_ERROR("Null pointer in permuted multiplication");
+        return 1;
+    }
+    if (p->n != A->h || A->w != B->h || res->h != A->h || res->w != B->w || res == A || res == B) {
+        MTX_LOG_ERROR("Incompatible matrix sizes for permuted multiplication");
+        return -1;
+    }
+    if (mtx_unshare(res, 1) != 0) return -2;
+
+    mtx_mul_kernel_rows(res, A, p->p, B);
+    MTX_LOG("Permuted multiplication completed");
+    return 0;
+}
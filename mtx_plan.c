@@ -0,0 +1,389 @@
+#include <stdlib.h>
+#include <string.h>
+#include "mtx_plan.h"
+#include "mtx_tune.h"
+#include "mtx_logs.h"
+#include "mtx_metrics.h"
+#include "mtx_internal.h"
+
+/**
+ * @brief Recorded operation kinds
+ */
+typedef enum {
+    MTX_PLAN_MUL,
+    MTX_PLAN_ADD,
+    MTX_PLAN_SUB,
+    MTX_PLAN_COPY,
+    MTX_PLAN_NORM,
+    MTX_PLAN_SOLVE
+} mtx_plan_kind;
+
+typedef void (*mtx_plan_mul_fn)(matrix *dest, const matrix *mtx1, const matrix *mtx2);
+
+typedef struct {
+    mtx_plan_kind kind;
+    int dst, a, b;
+    double *out;            // MTX_PLAN_NORM result
+    mtx_plan_mul_fn mul;    // MTX_PLAN_MUL kernel, chosen at compile time
+    matrix *ws;             // MTX_PLAN_SOLVE augmented workspace
+    mtx_perm *rows;         // MTX_PLAN_SOLVE pivot order
+} mtx_plan_op;
+
+typedef struct {
+    size_t w, h;
+    matrix *own;            // plan-owned storage, allocated at compile time
+    matrix *ext;            // bound caller storage, takes precedence
+} mtx_plan_slot;
+
+struct mtx_plan
+{
+    mtx_plan_slot *slots;
+    size_t nslots, slot_cap;
+    mtx_plan_op *ops;
+    size_t nops, op_cap;
+    int compiled;
+};
+
+mtx_plan *mtx_plan_create(void) {
+    mtx_plan *plan = calloc(1, sizeof(mtx_plan));
+    if (!plan) {
+        MTX_LOG_ERROR("Failed to allocate plan");
+        return NULL;
+    }
+    MTX_LOG("Plan created");
+    return plan;
+}
+
+void mtx_plan_free(mtx_plan *plan) {
+    if (!plan) return;
+
+    for (size_t i = 0; i < plan->nslots; i++) {
+        if (plan->slots[i].own) mtx_free(plan->slots[i].own);
+    }
+    for (size_t i = 0; i < plan->nops; i++) {
+        if (plan->ops[i].ws) mtx_free(plan->ops[i].ws);
+        if (plan->ops[i].rows) mtx_perm_free(plan->ops[i].rows);
+    }
+    free(plan->slots);
+    free(plan->ops);
+    free(plan);
+    MTX_LOG("Plan freed");
+}
+
+int mtx_plan_matrix(mtx_plan *plan, size_t w, size_t h) {
+    if (!plan || w == 0 || h == 0 || plan->compiled) {
+        MTX_LOG_ERROR("Invalid slot declaration");
+        return -1;
+    }
+
+    if (plan->nslots == plan->slot_cap) {
+        size_t cap = plan->slot_cap ? 2 * plan->slot_cap : 8;
+        mtx_plan_slot *s = realloc(plan->slots, cap * sizeof(mtx_plan_slot));
+        if (!s) {
+            MTX_LOG_ERROR("Failed to grow plan slots");
+            return -2;
+        }
+        plan->slots = s;
+        plan->slot_cap = cap;
+    }
+
+    plan->slots[plan->nslots] = (mtx_plan_slot){w, h, NULL, NULL};
+    return (int)plan->nslots++;
+}
+
+static int mtx_plan_valid(const mtx_plan *plan, int slot) {
+    return slot >= 0 && (size_t)slot < plan->nslots;
+}
+
+static int mtx_plan_push(mtx_plan *plan, mtx_plan_op op) {
+    if (plan->nops == plan->op_cap) {
+        size_t cap = plan->op_cap ? 2 * plan->op_cap : 8;
+        mtx_plan_op *o = realloc(plan->ops, cap * sizeof(mtx_plan_op));
+        if (!o) {
+            MTX_LOG_ERROR("Failed to grow plan operations");
+            return -2;
+        }
+        plan->ops = o;
+        plan->op_cap = cap;
+    }
+
+    plan->ops[plan->nops++] = op;
+    return 0;
+}
+
+/**
+ * @brief Common checks of the recording functions
+ * @return 0 if the slots are valid and the plan is still recording
+ */
+static int mtx_plan_check(const mtx_plan *plan, int dst, int a, int b) {
+    if (plan->compiled) {
+        MTX_LOG_ERROR("Cannot record into a compiled plan");
+        return -1;
+    }
+    if (!mtx_plan_valid(plan, dst) || !mtx_plan_valid(plan, a) || !mtx_plan_valid(plan, b)) {
+        MTX_LOG_ERROR("Invalid slot in plan operation");
+        return -1;
+    }
+    return 0;
+}
+
+int mtx_plan_mul(mtx_plan *plan, int dst, int a, int b) {
+    if (!plan) {
+        MTX_LOG_ERROR("Null plan in mul");
+        return 1;
+    }
+    if (mtx_plan_check(plan, dst, a, b) != 0) return -1;
+
+    const mtx_plan_slot *sd = &plan->slots[dst], *sa = &plan->slots[a], *sb = &plan->slots[b];
+    if (sa->w != sb->h || sd->h != sa->h || sd->w != sb->w) {
+        MTX_LOG_ERROR("Matrix size mismatch in plan mul");
+        return -1;
+    }
+    if (dst == a || dst == b) {
+        MTX_LOG_ERROR("Plan mul output aliases an operand");
+        return -1;
+    }
+
+    return mtx_plan_push(plan, (mtx_plan_op){.kind = MTX_PLAN_MUL, .dst = dst, .a = a, .b = b});
+}
+
+static int mtx_plan_elementwise(mtx_plan *plan, mtx_plan_kind kind, int dst, int a, int b) {
+    if (!plan) {
+        MTX_LOG_ERROR("Null plan in element-wise operation");
+        return 1;
+    }
+    if (mtx_plan_check(plan, dst, a, b) != 0) return -1;
+
+    const mtx_plan_slot *sd = &plan->slots[dst], *sa = &plan->slots[a], *sb = &plan->slots[b];
+    if (sa->w != sb->w || sa->h != sb->h || sd->w != sa->w || sd->h != sa->h) {
+        MTX_LOG_ERROR("Matrix size mismatch in plan element-wise operation");
+        return -1;
+    }
+
+    return mtx_plan_push(plan, (mtx_plan_op){.kind = kind, .dst = dst, .a = a, .b = b});
+}
+
+int mtx_plan_add(mtx_plan *plan, int dst, int a, int b) {
+    return mtx_plan_elementwise(plan, MTX_PLAN_ADD, dst, a, b);
+}
+
+int mtx_plan_sub(mtx_plan *plan, int dst, int a, int b) {
+    return mtx_plan_elementwise(plan, MTX_PLAN_SUB, dst, a, b);
+}
+
+int mtx_plan_copy(mtx_plan *plan, int dst, int src) {
+    return mtx_plan_elementwise(plan, MTX_PLAN_COPY, dst, src, src);
+}
+
+int mtx_plan_norm(mtx_plan *plan, int a, double *out) {
+    if (!plan || !out) {
+        MTX_LOG_ERROR("Null pointer in plan norm");
+        return 1;
+    }
+    if (mtx_plan_check(plan, a, a, a) != 0) return -1;
+
+    return mtx_plan_push(plan, (mtx_plan_op){.kind = MTX_PLAN_NORM, .dst = a, .a = a, .b = a, .out = out});
+}
+
+int mtx_plan_solve(mtx_plan *plan, int X, int A, int B) {
+    if (!plan) {
+        MTX_LOG_ERROR("Null plan in solve");
+        return 1;
+    }
+    if (mtx_plan_check(plan, X, A, B) != 0) return -1;
+
+    const mtx_plan_slot *sx = &plan->slots[X], *sa = &plan->slots[A], *sb = &plan->slots[B];
+    if (sa->w != sa->h || sb->h != sa->h || sx->w != sb->w || sx->h != sb->h) {
+        MTX_LOG_ERROR("Matrix size mismatch in plan solve");
+        return -1;
+    }
+
+    return mtx_plan_push(plan, (mtx_plan_op){.kind = MTX_PLAN_SOLVE, .dst = X, .a = A, .b = B});
+}
+
+/**
+ * @brief Unblocked i-k-j product for operands that fit in one block
+ */
+static void mtx_plan_mul_small(matrix *dest, const matrix *mtx1, const matrix *mtx2) {
+    const size_t h = mtx1->h, n = mtx1->w, w = mtx2->w;
+
+    for (size_t i = 0; i < h; i++) {
+        double *restrict d = mtx_row(dest, i);
+        const double *a = mtx_crow(mtx1, i);
+        memset(d, 0, w * sizeof(double));
+        for (size_t k = 0; k < n; k++) {
+            mtx_row_axpy(d, mtx_crow(mtx2, k), a[k], w);
+        }
+    }
+}
+
+int mtx_plan_compile(mtx_plan *plan) {
+    if (!plan) {
+        MTX_LOG_ERROR("Null plan in compile");
+        return 1;
+    }
+    if (plan->compiled) {
+        MTX_LOG_ERROR("Plan is already compiled");
+        return -1;
+    }
+
+    const mtx_tune_params *tp = mtx_tune_get();
+
+    for (size_t i = 0; i < plan->nslots; i++) {
+        mtx_plan_slot *s = &plan->slots[i];
+        if (s->ext) continue;
+        s->own = mtx_alloc_zero(s->w, s->h);
+        if (!s->own) goto fail;
+    }
+
+    for (size_t i = 0; i < plan->nops; i++) {
+        mtx_plan_op *op = &plan->ops[i];
+        const mtx_plan_slot *sa = &plan->slots[op->a], *sb = &plan->slots[op->b];
+
+        if (op->kind == MTX_PLAN_MUL) {
+            if (sb->w <= tp->skinny_width) {
+                op->mul = mtx_mul_kernel;
+            } else if (sa->h <= tp->block_i && sa->w <= tp->block_k && sb->w <= tp->block_j) {
+                op->mul = mtx_plan_mul_small;
+            } else {
+                op->mul = mtx_block_mul;
+            }
+        } else if (op->kind == MTX_PLAN_SOLVE) {
+            op->ws = mtx_alloc(sa->w + sb->w, sa->h);
+            op->rows = mtx_perm_alloc(sa->h);
+            if (!op->ws || !op->rows) goto fail;
+        }
+    }
+
+    plan->compiled = 1;
+    MTX_LOG("Plan compiled");
+    return 0;
+
+fail:
+    MTX_LOG_ERROR("Allocation in plan compile failed");
+    for (size_t i = 0; i < plan->nslots; i++) {
+        if (plan->slots[i].own) mtx_free(plan->slots[i].own);
+        plan->slots[i].own = NULL;
+    }
+    for (size_t i = 0; i < plan->nops; i++) {
+        if (plan->ops[i].ws) mtx_free(plan->ops[i].ws);
+        if (plan->ops[i].rows) mtx_perm_free(plan->ops[i].rows);
+        plan->ops[i].ws = NULL;
+        plan->ops[i].rows = NULL;
+    }
+    return -2;
+}
+
+int mtx_plan_bind(mtx_plan *plan, int slot, matrix *mtx) {
+    if (!plan) {
+        MTX_LOG_ERROR("Null plan in bind");
+        return 1;
+    }
+    if (!mtx_plan_valid(plan, slot)) {
+        MTX_LOG_ERROR("Invalid slot in plan bind");
+        return -1;
+    }
+
+    mtx_plan_slot *s = &plan->slots[slot];
+    if (mtx && (!mtx->data || mtx->w != s->w || mtx->h != s->h)) {
+        MTX_LOG_ERROR("Matrix size mismatch in plan bind");
+        return -1;
+    }
+    if (!mtx && plan->compiled && !s->own) {
+        // Slot was bound at compile time; it needs storage of its own now
+        s->own = mtx_alloc_zero(s->w, s->h);
+        if (!s->own) {
+            MTX_LOG_ERROR("Allocation in plan bind failed");
+            return -2;
+        }
+    }
+
+    s->ext = mtx;
+    return 0;
+}
+
+matrix *mtx_plan_get(mtx_plan *plan, int slot) {
+    if (!plan || !mtx_plan_valid(plan, slot)) {
+        MTX_LOG_ERROR("Invalid slot in plan get");
+        return NULL;
+    }
+    return plan->slots[slot].ext ? plan->slots[slot].ext : plan->slots[slot].own;
+}
+
+static inline matrix *mtx_plan_at(mtx_plan *plan, int slot) {
+    return plan->slots[slot].ext ? plan->slots[slot].ext : plan->slots[slot].own;
+}
+
+int mtx_plan_execute(mtx_plan *plan) {
+    MTX_METRIC_BEGIN(PLAN_EXEC);
+    if (!plan) {
+        MTX_LOG_ERROR("Null plan in execute");
+        return 1;
+    }
+    if (!plan->compiled) {
+        MTX_LOG_ERROR("Plan is not compiled");
+        return -1;
+    }
+
+    for (size_t i = 0; i < plan->nops; i++) {
+        const mtx_plan_op *op = &plan->ops[i];
+        matrix *d = mtx_plan_at(plan, op->dst);
+        const matrix *a = mtx_plan_at(plan, op->a);
+        const matrix *b = mtx_plan_at(plan, op->b);
+        const size_t len = a->w * a->h;
+
+        // Any slot may have been cloned since the last run, through mtx_plan_get or
+        // before it was bound; one atomic load when it was not
+        if (op->kind != MTX_PLAN_NORM && mtx_unshare(d, 1) != 0) return -2;
+
+        switch (op->kind) {
+        case MTX_PLAN_MUL: {
+            // Recording keeps the slots apart, but one matrix (or buffer) may be bound to both
+            const int sa = a->data == d->data, sb = b->data == d->data;
+            if (!sa && !sb) {
+                op->mul(d, a, b);
+                break;
+            }
+            const size_t la = sa ? len : 0, lb = sb ? b->w * b->h : 0;
+            double *copy = mtx_scratch(la > lb ? la : lb);
+            if (!copy) {
+                MTX_LOG_ERROR("Allocation in plan execute failed");
+                return -2;
+            }
+            memcpy(copy, d->data, (la > lb ? la : lb) * sizeof(double));
+            const matrix snap_a = {.data = copy, .w = a->w, .h = a->h, .map_len = 0};
+            const matrix snap_b = {.data = copy, .w = b->w, .h = b->h, .map_len = 0};
+            op->mul(d, sa ? &snap_a : a, sb ? &snap_b : b);
+            break;
+        }
+        case MTX_PLAN_ADD:
+            for (size_t j = 0; j < len; j++) d->data[j] = a->data[j] + b->data[j];
+            break;
+        case MTX_PLAN_SUB:
+            for (size_t j = 0; j < len; j++) d->data[j] = a->data[j] - b->data[j];
+            break;
+        case MTX_PLAN_COPY:
+            if (d != a) memcpy(d->data, a->data, len * sizeof(double));
+            break;
+        case MTX_PLAN_NORM:
+            *op->out = mtx_panel_norm_inf(a->data, a->w, a->h);
+            break;
+        case MTX_PLAN_SOLVE: {
+            const size_t n = a->h, m = b->w;
+            for (size_t r = 0; r < n; r++) {
+                memcpy(mtx_row(op->ws, r), mtx_crow(a, r), n * sizeof(double));
+                memcpy(mtx_row(op->ws, r) + n, mtx_crow(b, r), m * sizeof(double));
+            }
+            mtx_perm_set_id(op->rows);
+            if (mtx_gauss_elim(op->ws, n, op->rows) != 0) return -3;
+            for (size_t r = 0; r < n; r++) {
+                memcpy(mtx_row(d, r), mtx_crow(op->ws, op->rows->p[r]) + n, m * sizeof(double));
+            }
+            break;
+        }
+        }
+    }
+
+    MTX_METRIC_END(PLAN_EXEC, 0, 0);
+    return 0;
+}
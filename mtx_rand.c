@@ -0,0 +1,268 @@
+#include <stdlib.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "mtx_rand.h"
+#include "mtx_decomp.h"
+#include "mtx_logs.h"
+#include "mtx_metrics.h"
+#include "mtx_internal.h"
+
+/**
+ * @brief Philox4x32 multipliers and Weyl key increments (Salmon et al., SC'11)
+ */
+#define MTX_PHILOX_M0 0xD2511F53u
+#define MTX_PHILOX_M1 0xCD9E8D57u
+#define MTX_PHILOX_W0 0x9E3779B9u
+#define MTX_PHILOX_W1 0xBB67AE85u
+#define MTX_PHILOX_ROUNDS 10
+
+/**
+ * @brief Philox blocks generated together; the rounds vectorize across them
+ */
+#define MTX_RAND_LANES 8
+
+/**
+ * @brief Streams of the structured constructors, apart from the plain fills (stream 0)
+ */
+#define MTX_RAND_STREAM_U 1
+#define MTX_RAND_STREAM_V 2
+
+/* ================== Generator ================== */
+
+/**
+ * @brief Philox4x32-10 on MTX_RAND_LANES counters at once (x0..x3 hold the words of each lane)
+ */
+static void mtx_philox(uint32_t *restrict x0, uint32_t *restrict x1, uint32_t *restrict x2,
+                       uint32_t *restrict x3, uint32_t k0, uint32_t k1) {
+    for (int r = 0; r < MTX_PHILOX_ROUNDS; r++) {
+        #pragma omp simd
+        for (int l = 0; l < MTX_RAND_LANES; l++) {
+            const uint64_t p0 = (uint64_t)MTX_PHILOX_M0 * x0[l];
+            const uint64_t p1 = (uint64_t)MTX_PHILOX_M1 * x2[l];
+            const uint32_t y0 = (uint32_t)(p1 >> 32) ^ x1[l] ^ k0;
+            const uint32_t y2 = (uint32_t)(p0 >> 32) ^ x3[l] ^ k1;
+            x1[l] = (uint32_t)p1;
+            x3[l] = (uint32_t)p0;
+            x0[l] = y0;
+            x2[l] = y2;
+        }
+        k0 += MTX_PHILOX_W0;
+        k1 += MTX_PHILOX_W1;
+    }
+}
+
+/**
+ * @brief Uniform double in [0, 1) from 53 of the 64 bits of (hi, lo)
+ */
+static inline double mtx_rand_u53(uint32_t hi, uint32_t lo) {
+    return ((hi >> 5) * 67108864.0 + (lo >> 6)) * 0x1.0p-53;
+}
+
+void mtx_rand_fill(double *p, size_t len, int normal, double a, double b, uint64_t seed, uint64_t stream) {
+    const size_t per = 2 * MTX_RAND_LANES;
+    const size_t groups = (len + per - 1) / per;
+    const uint32_t k0 = (uint32_t)seed, k1 = (uint32_t)(seed >> 32);
+
+    #pragma omp parallel for schedule(static) if(len > mtx_tune_get()->par_min)
+    for (size_t g = 0; g < groups; g++) {
+        uint32_t x0[MTX_RAND_LANES], x1[MTX_RAND_LANES], x2[MTX_RAND_LANES], x3[MTX_RAND_LANES];
+        double u[2 * MTX_RAND_LANES];
+
+        for (int l = 0; l < MTX_RAND_LANES; l++) {
+            const uint64_t blk = (uint64_t)g * MTX_RAND_LANES + l;
+            x0[l] = (uint32_t)blk;
+            x1[l] = (uint32_t)(blk >> 32);
+            x2[l] = (uint32_t)stream;
+            x3[l] = (uint32_t)(stream >> 32);
+        }
+        mtx_philox(x0, x1, x2, x3, k0, k1);
+
+        for (int l = 0; l < MTX_RAND_LANES; l++) {
+            u[2 * l] = mtx_rand_u53(x0[l], x1[l]);
+            u[2 * l + 1] = mtx_rand_u53(x2[l], x3[l]);
+        }
+        if (normal) {
+            // Box-Muller on the pair of each block; 1 - u lies in (0, 1]
+            for (int l = 0; l < MTX_RAND_LANES; l++) {
+                const double rad = sqrt(-2.0 * log(1.0 - u[2 * l]));
+                const double ang = 6.283185307179586 * u[2 * l + 1];
+                u[2 * l] = rad * cos(ang);
+                u[2 * l + 1] = rad * sin(ang);
+            }
+        }
+
+        const size_t base = g * per;
+        const size_t n = len - base < per ? len - base : per;
+        for (size_t i = 0; i < n; i++) p[base + i] = a + b * u[i];
+    }
+}
+
+/* ================== Fills ================== */
+
+int mtx_rand_uniform(matrix *mtx, double lo, double hi, uint64_t seed) {
+    MTX_METRIC_BEGIN(RAND_UNIFORM);
+    if (!mtx || !mtx->data) {
+        MTX_LOG_ERROR("Null matrix in uniform fill");
+        return 1;
+    }
+    if (mtx_unshare(mtx, 0) != 0) return -2;
+
+    mtx_rand_fill(mtx->data, mtx->w * mtx->h, 0, lo, hi - lo, seed, 0);
+    MTX_LOG("Uniform fill completed");
+    MTX_METRIC_END(RAND_UNIFORM, mtx->w * mtx->h * sizeof(double), 2 * mtx->w * mtx->h);
+    return 0;
+}
+
+int mtx_rand_normal(matrix *mtx, double mean, double sd, uint64_t seed) {
+    MTX_METRIC_BEGIN(RAND_NORMAL);
+    if (!mtx || !mtx->data) {
+        MTX_LOG_ERROR("Null matrix in normal fill");
+        return 1;
+    }
+    if (mtx_unshare(mtx, 0) != 0) return -2;
+
+    mtx_rand_fill(mtx->data, mtx->w * mtx->h, 1, mean, sd, seed, 0);
+    MTX_LOG("Normal fill completed");
+    MTX_METRIC_END(RAND_NORMAL, mtx->w * mtx->h * sizeof(double), 2 * mtx->w * mtx->h);
+    return 0;
+}
+
+/* ================== Structured Matrices ================== */
+
+/**
+ * @brief Random h x k matrix with orthonormal columns: Q of a normal matrix, signs fixed by diag(R)
+ * @return Matrix, NULL if QR or allocation failed
+ */
+static matrix *mtx_rand_orth_cols(size_t h, size_t k, uint64_t seed, uint64_t stream) {
+    matrix *G = mtx_alloc(k, h);
+    matrix *Q = mtx_alloc(k, h);
+    matrix *R = mtx_alloc(k, k);
+    int rc = -2;
+    if (G && Q && R) {
+        mtx_rand_fill(G->data, k * h, 1, 0.0, 1.0, seed, stream);
+        rc = mtx_qr(G, Q, R);
+    }
+    if (rc != 0) {
+        if (G) mtx_free(G);
+        if (Q) mtx_free(Q);
+        if (R) mtx_free(R);
+        return NULL;
+    }
+
+    // Without the sign fix the distribution depends on the QR convention
+    for (size_t i = 0; i < h; i++) {
+        double *q = mtx_row(Q, i);
+        for (size_t j = 0; j < k; j++) {
+            if (*mtx_cat(R, j, j) < 0.0) q[j] = -q[j];
+        }
+    }
+    mtx_free(G);
+    mtx_free(R);
+    return Q;
+}
+
+/**
+ * @brief Singular values 1 ... 1 / cond, geometrically spaced (k)
+ */
+static void mtx_rand_spectrum(double *s, size_t k, double cond) {
+    for (size_t p = 0; p < k; p++) {
+        s[p] = k > 1 ? pow(cond, -(double)p / (double)(k - 1)) : 1.0;
+    }
+}
+
+/**
+ * @brief dest = U * diag(s) * V^T for U (h x k), V (w x k); U is scaled in place
+ * @param sym Nonzero if U == V: only j >= i is computed and mirrored, so dest is exactly symmetric
+ */
+static void mtx_rand_usv(matrix *dest, matrix *U, const double *s, const matrix *V, int sym) {
+    const size_t k = U->w;
+    for (size_t i = 0; i < U->h; i++) {
+        double *u = mtx_row(U, i);
+        for (size_t p = 0; p < k; p++) u[p] *= s[p];
+    }
+
+    #pragma omp parallel for schedule(static) if(dest->w * dest->h * k > mtx_tune_get()->par_min)
+    for (size_t i = 0; i < dest->h; i++) {
+        const double *u = mtx_crow(U, i);
+        for (size_t j = sym ? i : 0; j < dest->w; j++) {
+            const double *v = mtx_crow(V, j);
+            double sum = 0.0;
+            for (size_t p = 0; p < k; p++) sum += u[p] * v[p];
+            *mtx_at(dest, i, j) = sum;
+            if (sym) *mtx_at(dest, j, i) = sum;
+        }
+    }
+}
+
+matrix *mtx_rand_orthogonal(size_t n, uint64_t seed) {
+    if (n == 0) {
+        MTX_LOG_ERROR("Zero size in random orthogonal matrix");
+        return NULL;
+    }
+    matrix *Q = mtx_rand_orth_cols(n, n, seed, MTX_RAND_STREAM_U);
+    if (!Q) {
+        MTX_LOG_ERROR("Random orthogonal matrix failed");
+        return NULL;
+    }
+    MTX_LOG("Random orthogonal matrix created");
+    return Q;
+}
+
+matrix *mtx_rand_spd(size_t n, double cond, uint64_t seed) {
+    if (n == 0 || !(cond >= 1.0)) {
+        MTX_LOG_ERROR("Invalid size or condition number in random SPD matrix");
+        return NULL;
+    }
+
+    matrix *Q = mtx_rand_orth_cols(n, n, seed, MTX_RAND_STREAM_U);
+    matrix *V = mtx_copy(Q);
+    matrix *A = mtx_alloc(n, n);
+    double *l = malloc(n * sizeof(double));
+    if (!Q || !V || !A || !l) {
+        MTX_LOG_ERROR("Allocation in random SPD matrix failed");
+        mtx_free(A);
+        A = NULL;
+        goto cleanup;
+    }
+
+    mtx_rand_spectrum(l, n, cond);
+    mtx_rand_usv(A, Q, l, V, 1);
+    MTX_LOG("Random SPD matrix created");
+
+cleanup:
+    mtx_free(Q);
+    mtx_free(V);
+    free(l);
+    return A;
+}
+
+matrix *mtx_rand_cond(size_t w, size_t h, double cond, uint64_t seed) {
+    if (w == 0 || h == 0 || !(cond >= 1.0)) {
+        MTX_LOG_ERROR("Invalid size or condition number in random matrix");
+        return NULL;
+    }
+
+    const size_t k = w < h ? w : h;
+    matrix *U = mtx_rand_orth_cols(h, k, seed, MTX_RAND_STREAM_U);
+    matrix *V = mtx_rand_orth_cols(w, k, seed, MTX_RAND_STREAM_V);
+    matrix *A = mtx_alloc(w, h);
+    double *s = malloc(k * sizeof(double));
+    if (!U || !V || !A || !s) {
+        MTX_LOG_ERROR("Allocation in random matrix failed");
+        mtx_free(A);
+        A = NULL;
+        goto cleanup;
+    }
+
+    mtx_rand_spectrum(s, k, cond);
+    mtx_rand_usv(A, U, s, V, 0);
+    MTX_LOG("Random matrix with given condition number created");
+
+cleanup:
+    mtx_free(U);
+    mtx_free(V);
+    free(s);
+    return A;
+}
@@ -1,19 +1,191 @@
+#define _GNU_SOURCE
+
 #include "mtx_repmem.h"
 #include "mtx_arithmetic.h"
 #include "mtx_actions.h"
 #include "mtx_logs.h"
+#include "mtx_metrics.h"
+#include "mtx_internal.h"
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define MTX_HUGE_PAGE (2u << 20)
+#define MTX_MAX_NODES 1024
+
+// mbind(2) modes, spelled out to avoid depending on libnuma headers
+#define MTX_MPOL_BIND 2
+#define MTX_MPOL_INTERLEAVE 3
+
+void mtx_mem_set_policy(const mtx_mem_policy *policy) {
+    mtx_context_set_policy(mtx_context_current(), policy);
+}
+
+void mtx_mem_get_policy(mtx_mem_policy *policy) {
+    mtx_context_get_policy(mtx_context_current(), policy);
+}
+
+#ifdef __linux__
+
+/**
+ * @brief Fills mask with the online NUMA nodes ("0-1,3" list in sysfs)
+ * @return Number of online nodes, 0 if unknown
+ */
+static size_t mtx_online_nodes(unsigned long *mask) {
+    const size_t bits = 8 * sizeof(unsigned long);
+    FILE *f = fopen("/sys/devices/system/node/online", "r");
+    if (!f) return 0;
+
+    size_t count = 0;
+    unsigned long lo, hi;
+    int sep;
+    while (fscanf(f, "%lu", &lo) == 1) {
+        hi = lo;
+        sep = fgetc(f);
+        if (sep == '-') {
+            if (fscanf(f, "%lu", &hi) != 1) break;
+            sep = fgetc(f);
+        }
+        for (unsigned long n = lo; n <= hi && n < MTX_MAX_NODES; n++) {
+            mask[n / bits] |= 1ul << (n % bits);
+            count++;
+        }
+        if (sep != ',') break;
+    }
+    fclose(f);
+    return count;
+}
+
+/**
+ * @brief Applies the NUMA placement of a policy to a mapping
+ */
+static void mtx_mem_place(void *addr, size_t len, const mtx_mem_policy *policy) {
+    unsigned long mask[MTX_MAX_NODES / (8 * sizeof(unsigned long))] = {0};
+    int mode;
+
+    if (policy->placement == MTX_MEM_INTERLEAVE) {
+        if (mtx_online_nodes(mask) < 2) return; // nothing to interleave over
+        mode = MTX_MPOL_INTERLEAVE;
+    } else if (policy->placement == MTX_MEM_BIND) {
+        if (policy->node < 0 || policy->node >= MTX_MAX_NODES) {
+            MTX_LOG_ERROR("Invalid NUMA node in allocation policy");
+            return;
+        }
+        mask[policy->node / (8 * sizeof(unsigned long))] |= 1ul << (policy->node % (8 * sizeof(unsigned long)));
+        mode = MTX_MPOL_BIND;
+    } else {
+        return;
+    }
+
+#ifdef SYS_mbind
+    if (syscall(SYS_mbind, addr, len, mode, mask, (unsigned long)MTX_MAX_NODES, 0u) != 0) {
+        MTX_LOG_ERROR("mbind failed, keeping default NUMA placement");
+    }
+#else
+    (void)addr;
+    (void)len;
+    (void)mode;
+    MTX_LOG_ERROR("mbind unavailable, keeping default NUMA placement");
+#endif
+}
+
+/**
+ * @brief Maps anonymous memory for matrix data according to a policy
+ * @param bytes Requested size
+ * @param policy Allocation policy
+ * @param map_len Output mapping length, to be passed to munmap
+ * @return Mapping address, NULL on failure
+ */
+static double *mtx_mem_map(size_t bytes, const mtx_mem_policy *policy, size_t *map_len) {
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    const size_t huge_len = (bytes + MTX_HUGE_PAGE - 1) / MTX_HUGE_PAGE * MTX_HUGE_PAGE;
+    void *addr = MAP_FAILED;
+    size_t len = 0;
+
+#ifdef MAP_HUGETLB
+    if (policy->pages == MTX_PAGES_HUGE) {
+        len = huge_len;
+        addr = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (addr == MAP_FAILED) MTX_LOG_ERROR("No huge pages reserved, using transparent huge pages");
+    }
+#endif
+
+    if (addr == MAP_FAILED && policy->pages != MTX_PAGES_DEFAULT) {
+        // Over-map and trim so the data starts on a huge page boundary
+        const size_t span = huge_len + MTX_HUGE_PAGE;
+        char *raw = mmap(NULL, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) return NULL;
+
+        char *aligned = (char *)(((uintptr_t)raw + MTX_HUGE_PAGE - 1) & ~(uintptr_t)(MTX_HUGE_PAGE - 1));
+        if (aligned > raw) munmap(raw, (size_t)(aligned - raw));
+        if (raw + span > aligned + huge_len) munmap(aligned + huge_len, (size_t)(raw + span - (aligned + huge_len)));
+
+        addr = aligned;
+        len = huge_len;
+#ifdef MADV_HUGEPAGE
+        if (madvise(addr, len, MADV_HUGEPAGE) != 0) MTX_LOG_ERROR("Transparent huge pages unavailable");
+#endif
+    } else if (addr == MAP_FAILED) {
+        len = (bytes + page - 1) / page * page;
+        addr = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED) return NULL;
+    }
+
+    mtx_mem_place(addr, len, policy);
+    *map_len = len;
+    return addr;
+}
 
+#endif
 
-struct matrix
-{
-    double *data; // data + w * i + j
-    size_t w, h;    
-};
+/**
+ * @brief Allocates matrix data, mapped according to the policy when it is large enough
+ * @param map_len Output mapping length, 0 for heap data
+ * @return Data, NULL on failure
+ */
+static double *mtx_data_alloc(size_t bytes, const mtx_mem_policy *policy, size_t *map_len) {
+    double *data = NULL;
+    *map_len = 0;
+#ifdef __linux__
+    if (bytes >= policy->threshold &&
+        (policy->placement != MTX_MEM_DEFAULT || policy->pages != MTX_PAGES_DEFAULT)) {
+        data = mtx_mem_map(bytes, policy, map_len);
+        if (!data) MTX_LOG_ERROR("Failed to map matrix data, falling back to malloc");
+    }
+#endif
+    if (!data) data = malloc(bytes);
+    return data;
+}
 
+/**
+ * @brief Releases data from mtx_data_alloc
+ */
+static void mtx_data_release(double *data, size_t map_len) {
+    if (map_len == MTX_DATA_BORROWED) return;
+#ifdef __linux__
+    if (map_len) {
+        munmap(data, map_len);
+        return;
+    }
+#endif
+    (void)map_len;
+    free(data);
+}
 
 matrix* mtx_alloc(size_t w, size_t h) {
+    return mtx_alloc_policy(w, h, NULL);
+}
+
+matrix *mtx_alloc_policy(size_t w, size_t h, const mtx_mem_policy *policy) {
+    MTX_METRIC_BEGIN(ALLOC);
     if(w == 0 || h == 0) {
         MTX_LOG_ERROR("Attempt to allocate matrix with zero dimensions");
         return NULL;
@@ -25,21 +197,61 @@ matrix* mtx_alloc(size_t w, size_t h) {
         return NULL; 
     }
 
-    mtx->data = (double*)malloc(w * h * sizeof(double));
+    if (!policy) policy = &mtx_context_current()->policy;
+    const size_t bytes = w * h * sizeof(double);
+
+    mtx->data = mtx_data_alloc(bytes, policy, &mtx->map_len);
     if (!mtx->data) {
         MTX_LOG_ERROR("Failed to allocate matrix data");
-        free(mtx); 
-        return NULL; 
+        free(mtx);
+        return NULL;
     }
+    atomic_init(&mtx->refs, NULL);
 
     mtx->w = w;
     mtx->h = h;
+
+    if (policy->placement == MTX_MEM_FIRST_TOUCH && mtx->map_len) {
+        // Same static row split as the parallel kernels, so each row lands on its user's node
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < h; i++) {
+            memset(mtx_row(mtx, i), 0, w * sizeof(double));
+        }
+    }
+
     MTX_LOG("Allocated matrix.");
+    MTX_METRIC_END(ALLOC, bytes, 0);
+
+    return mtx;
+}
+
+matrix *mtx_wrap(double *data, size_t w, size_t h) {
+    if (!data) {
+        MTX_LOG_ERROR("Null data pointer in wrap");
+        return NULL;
+    }
+    if (w == 0 || h == 0) {
+        MTX_LOG_ERROR("Attempt to wrap matrix with zero dimensions");
+        return NULL;
+    }
+
+    matrix *mtx = malloc(sizeof(matrix));
+    if (!mtx) {
+        MTX_LOG_ERROR("Failed to allocate matrix struct");
+        return NULL;
+    }
+    mtx->data = data;
+    mtx->w = w;
+    mtx->h = h;
+    mtx->map_len = MTX_DATA_BORROWED;
+    atomic_init(&mtx->refs, NULL);
 
+    MTX_LOG("Wrapped external buffer");
     return mtx;
 }
 
 int mtx_assign(matrix *mtx1, const matrix *mtx2) {
+    MTX_METRIC_BEGIN(ASSIGN);
     if (!mtx1 || !mtx2 || !mtx1->data || !mtx2->data) {
         MTX_LOG_ERROR("Invalid matrix pointers in assignment");
         return 1;
@@ -49,14 +261,19 @@ int mtx_assign(matrix *mtx1, const matrix *mtx2) {
         MTX_LOG_ERROR("Matrix size mismatch in assignment");
         return -1;
     }
+
+    if (mtx1->data == mtx2->data) return 0; // same struct or clones of one value
+    if (mtx_unshare(mtx1, 0) != 0) return -2;
     
     memcpy(mtx1->data, mtx2->data, mtx1->w * mtx1->h * sizeof(double));
     MTX_LOG("Matrix assignment completed");
+    MTX_METRIC_END(ASSIGN, 2 * mtx1->w * mtx1->h * sizeof(double), 0);
     
     return 0; 
 }
 
 matrix* mtx_copy(const matrix *mtx) {
+    MTX_METRIC_BEGIN(COPY);
     if(!mtx || !mtx->data) {
         MTX_LOG_ERROR("Invalid source matrix for copy");
         return NULL;
@@ -70,26 +287,194 @@ matrix* mtx_copy(const matrix *mtx) {
 
     mtx_assign(new_mtx, mtx);
     MTX_LOG("Matrix copy completed");
+    MTX_METRIC_END(COPY, 2 * mtx->w * mtx->h * sizeof(double), 0);
 
     return new_mtx;
 }
 
+matrix *mtx_clone(const matrix *mtx) {
+    if (!mtx || !mtx->data) {
+        MTX_LOG_ERROR("Invalid source matrix for clone");
+        return NULL;
+    }
+
+    matrix *c = malloc(sizeof(matrix));
+    if (!c) {
+        MTX_LOG_ERROR("Failed to allocate matrix struct");
+        return NULL;
+    }
+
+    // The share count is bookkeeping, not part of the value, so a const source
+    // still gets one attached on its first clone
+    matrix *src = (matrix *)mtx;
+    atomic_size_t *refs = atomic_load(&src->refs);
+    if (!refs) {
+        atomic_size_t *fresh = malloc(sizeof(atomic_size_t));
+        if (!fresh) {
+            MTX_LOG_ERROR("Failed to allocate share count");
+            free(c);
+            return NULL;
+        }
+        atomic_init(fresh, 1);
+        if (atomic_compare_exchange_strong(&src->refs, &refs, fresh)) {
+            refs = fresh;
+        } else {
+            free(fresh); // another thread attached one first; refs now holds it
+        }
+    }
+    atomic_fetch_add_explicit(refs, 1, memory_order_relaxed);
+
+    c->data = src->data;
+    c->w = src->w;
+    c->h = src->h;
+    c->map_len = src->map_len;
+    atomic_init(&c->refs, refs);
+
+    MTX_LOG("Matrix cloned");
+    return c;
+}
+
+int mtx_is_shared(const matrix *mtx) {
+    if (!mtx) return 0;
+    atomic_size_t *refs = atomic_load(&mtx->refs);
+    return refs && atomic_load_explicit(refs, memory_order_acquire) > 1;
+}
+
+int mtx_unshare(matrix *mtx, int keep) {
+    atomic_size_t *refs = atomic_load(&mtx->refs);
+    if (!refs) return 0;
+
+    if (atomic_load_explicit(refs, memory_order_acquire) == 1) {
+        // Every other handle is gone: the data is ours again
+        atomic_store(&mtx->refs, NULL);
+        free(refs);
+        return 0;
+    }
+
+    const size_t bytes = mtx->w * mtx->h * sizeof(double);
+    size_t map_len;
+    double *data = mtx_data_alloc(bytes, &mtx_context_current()->policy, &map_len);
+    if (!data) {
+        MTX_LOG_ERROR("Failed to allocate private copy of shared matrix");
+        return -2;
+    }
+    if (keep) memcpy(data, mtx->data, bytes);
+
+    // Copy first, then let go: whoever drops the count to zero frees the old data
+    if (atomic_fetch_sub_explicit(refs, 1, memory_order_acq_rel) == 1) {
+        mtx_data_release(mtx->data, mtx->map_len);
+        free(refs);
+    }
+    mtx->data = data;
+    mtx->map_len = map_len;
+    atomic_store(&mtx->refs, NULL);
+    return 0;
+}
+
 void mtx_free(matrix *mtx) {
     if (!mtx) {
         MTX_LOG_ERROR("Attempt to free NULL matrix");
         return;
     }
 
-    free(mtx->data);
+    atomic_size_t *refs = atomic_load(&mtx->refs);
+    if (!refs || atomic_fetch_sub_explicit(refs, 1, memory_order_acq_rel) == 1) {
+        mtx_data_release(mtx->data, mtx->map_len);
+        free(refs);
+    }
     free(mtx);
     MTX_LOG("Freed matrix");
 }
 
+int mtx_reserve_data(matrix *mtx, size_t count) {
+    const size_t bytes = count * sizeof(double);
+    if (mtx_unshare(mtx, 1) != 0) return -2;
+
+    if (mtx->map_len == MTX_DATA_BORROWED) {
+        // The caller's buffer cannot grow: move the data to the library's heap
+        if (bytes <= mtx->w * mtx->h * sizeof(double)) return 0;
+        double *data = malloc(bytes);
+        if (!data) return -2;
+        memcpy(data, mtx->data, mtx->w * mtx->h * sizeof(double));
+        mtx->data = data;
+        mtx->map_len = 0;
+        return 0;
+    }
+
+#ifdef __linux__
+    if (mtx->map_len) {
+        if (bytes <= mtx->map_len) return 0;
+        const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        const size_t len = (bytes + page - 1) / page * page;
+        void *addr = mremap(mtx->data, mtx->map_len, len, MREMAP_MAYMOVE);
+        if (addr != MAP_FAILED) {
+            mtx->data = addr;
+            mtx->map_len = len;
+            return 0;
+        }
+
+        // Huge page mappings cannot always grow; move the data to the heap
+        double *data = malloc(bytes);
+        if (!data) return -2;
+        memcpy(data, mtx->data, mtx->w * mtx->h * sizeof(double));
+        munmap(mtx->data, mtx->map_len);
+        mtx->data = data;
+        mtx->map_len = 0;
+        return 0;
+    }
+#endif
+
+    double *data = realloc(mtx->data, bytes);
+    if (!data) return bytes <= mtx->w * mtx->h * sizeof(double) ? 0 : -2;
+    mtx->data = data;
+    return 0;
+}
+
+typedef struct {
+    double *data;
+    size_t cap;
+} mtx_scratch_buf;
+
+static pthread_key_t mtx_scratch_key;
+static pthread_once_t mtx_scratch_once = PTHREAD_ONCE_INIT;
+
+static void mtx_scratch_release(void *p) {
+    mtx_scratch_buf *buf = p;
+    free(buf->data);
+    free(buf);
+}
+
+static void mtx_scratch_init(void) {
+    pthread_key_create(&mtx_scratch_key, mtx_scratch_release);
+}
+
+double *mtx_scratch(size_t count) {
+    pthread_once(&mtx_scratch_once, mtx_scratch_init);
+
+    mtx_scratch_buf *buf = pthread_getspecific(mtx_scratch_key);
+    if (!buf) {
+        buf = calloc(1, sizeof(mtx_scratch_buf));
+        if (!buf || pthread_setspecific(mtx_scratch_key, buf) != 0) {
+            free(buf);
+            return NULL;
+        }
+    }
+
+    if (buf->cap < count) {
+        double *data = realloc(buf->data, count * sizeof(double));
+        if (!data) return NULL;
+        buf->data = data;
+        buf->cap = count;
+    }
+    return buf->data;
+}
+
 double* mtx_ptr(matrix* mtx, size_t i, size_t j) {
     if (!mtx || !mtx->data) {
         MTX_LOG_ERROR("Invalid matrix access attempt");
         return NULL;
     }
+    if (mtx_unshare(mtx, 1) != 0) return NULL;
     return mtx->data + mtx->w * i + j;
 }
 
@@ -102,13 +487,16 @@ const double* mtx_cptr(const matrix* mtx, size_t i, size_t j) {
 }
 
 void mtx_set_zero(matrix *mtx) {
+    MTX_METRIC_BEGIN(SET_ZERO);
     if (!mtx || !mtx->data) {
         MTX_LOG_ERROR("Invalid matrix in set_zero");
         return;
     } 
+    if (mtx_unshare(mtx, 0) != 0) return;
     
     memset(mtx->data, 0, mtx->w * mtx->h * sizeof(double));
     MTX_LOG("Matrix set to zero");
+    MTX_METRIC_END(SET_ZERO, mtx->w * mtx->h * sizeof(double), 0);
 }
 
 void mtx_set_id(matrix *mtx) {
@@ -125,7 +513,7 @@ void mtx_set_id(matrix *mtx) {
     } 
     
     for (size_t i = 0; i < mtx->w; i++) {
-        *mtx_ptr(mtx, i, i) = 1.0;  
+        *mtx_at(mtx, i, i) = 1.0;
     }
 
     MTX_LOG("Matrix set to identity");
@@ -158,6 +546,7 @@ int mtx_input(matrix *mtx) {
         MTX_LOG_ERROR("Invalid matrix in input");
         return -1;
     } 
+    if (mtx_unshare(mtx, 1) != 0) return -2;
 
     printf("Enter the matrix %zux%zu:\n", mtx->h, mtx->w);
     for (size_t i = 0; i < mtx->h; i++) {
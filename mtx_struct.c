@@ -0,0 +1,763 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "mtx_struct.h"
+#include "mtx_logs.h"
+#include "mtx_metrics.h"
+#include "mtx_internal.h"
+
+struct smatrix
+{
+    mtx_layout layout;
+    size_t n, kl, ku;   // kl, ku used by MTX_BANDED only
+    size_t len;         // number of stored entries
+    double *data;
+};
+
+static smatrix *mtx_struct_alloc(mtx_layout layout, size_t n, size_t kl, size_t ku, size_t len) {
+    if (n == 0) {
+        MTX_LOG_ERROR("Attempt to allocate structured matrix with zero order");
+        return NULL;
+    }
+
+    smatrix *s = malloc(sizeof(smatrix));
+    if (!s) {
+        MTX_LOG_ERROR("Failed to allocate structured matrix struct");
+        return NULL;
+    }
+
+    s->data = calloc(len, sizeof(double));
+    if (!s->data) {
+        MTX_LOG_ERROR("Failed to allocate structured matrix data");
+        free(s);
+        return NULL;
+    }
+
+    s->layout = layout;
+    s->n = n;
+    s->kl = kl;
+    s->ku = ku;
+    s->len = len;
+    MTX_LOG("Allocated structured matrix.");
+    return s;
+}
+
+smatrix *mtx_diag_alloc(size_t n) {
+    return mtx_struct_alloc(MTX_DIAG, n, 0, 0, n);
+}
+
+smatrix *mtx_diag_alloc_id(size_t n) {
+    smatrix *s = mtx_diag_alloc(n);
+    if (!s) {
+        MTX_LOG_ERROR("Failed to allocate identity matrix");
+        return NULL;
+    }
+    for (size_t i = 0; i < n; i++) s->data[i] = 1.0;
+    return s;
+}
+
+smatrix *mtx_band_alloc(size_t n, size_t kl, size_t ku) {
+    if (kl >= n || ku >= n) {
+        MTX_LOG_ERROR("Bandwidth exceeds matrix order");
+        return NULL;
+    }
+    return mtx_struct_alloc(MTX_BANDED, n, kl, ku, n * (kl + ku + 1));
+}
+
+smatrix *mtx_sym_alloc(size_t n) {
+    return mtx_struct_alloc(MTX_SYM_PACKED, n, 0, 0, n * (n + 1) / 2);
+}
+
+smatrix *mtx_tri_alloc(size_t n, int upper) {
+    return mtx_struct_alloc(upper ? MTX_TRI_UPPER : MTX_TRI_LOWER, n, 0, 0, n * (n + 1) / 2);
+}
+
+void mtx_struct_free(smatrix *s) {
+    if (!s) {
+        MTX_LOG_ERROR("Attempt to free NULL structured matrix");
+        return;
+    }
+
+    free(s->data);
+    free(s);
+    MTX_LOG("Freed structured matrix");
+}
+
+mtx_layout mtx_struct_layout(const smatrix *s) {
+    if (!s) {
+        MTX_LOG_ERROR("Structured matrix is Null. Layout cannot be gotten");
+        return MTX_DIAG;
+    }
+    return s->layout;
+}
+
+size_t mtx_struct_order(const smatrix *s) {
+    if (!s) {
+        MTX_LOG_ERROR("Structured matrix is Null. Order cannot be gotten");
+        return 0;
+    }
+    return s->n;
+}
+
+/**
+ * @brief Start of the stored part of row i
+ */
+static inline size_t mtx_struct_row(const smatrix *s, size_t i) {
+    switch (s->layout) {
+    case MTX_BANDED:
+        return (s->kl + s->ku + 1) * i;
+    case MTX_SYM_PACKED:
+    case MTX_TRI_LOWER:
+        return i * (i + 1) / 2;
+    case MTX_TRI_UPPER:
+        return i * s->n - i * (i - 1) / 2;
+    default:
+        return i;
+    }
+}
+
+/**
+ * @brief First and one-past-last stored column of row i
+ */
+static inline void mtx_struct_cols(const smatrix *s, size_t i, size_t *j0, size_t *j1) {
+    switch (s->layout) {
+    case MTX_BANDED:
+        *j0 = i > s->kl ? i - s->kl : 0;
+        *j1 = i + s->ku + 1 < s->n ? i + s->ku + 1 : s->n;
+        break;
+    case MTX_SYM_PACKED:
+    case MTX_TRI_LOWER:
+        *j0 = 0;
+        *j1 = i + 1;
+        break;
+    case MTX_TRI_UPPER:
+        *j0 = i;
+        *j1 = s->n;
+        break;
+    default:
+        *j0 = i;
+        *j1 = i + 1;
+    }
+}
+
+/**
+ * @brief Unchecked pointer to stored element (i, j) of row i, j within mtx_struct_cols
+ */
+static inline double *mtx_struct_at(const smatrix *s, size_t i, size_t j) {
+    switch (s->layout) {
+    case MTX_BANDED:
+        return s->data + mtx_struct_row(s, i) + (j + s->kl - i);
+    case MTX_TRI_UPPER:
+        return s->data + mtx_struct_row(s, i) + (j - i);
+    case MTX_DIAG:
+        return s->data + i;
+    default:
+        return s->data + mtx_struct_row(s, i) + j;
+    }
+}
+
+double *mtx_struct_ptr(smatrix *s, size_t i, size_t j) {
+    if (!s || i >= s->n || j >= s->n) {
+        MTX_LOG_ERROR("Invalid structured matrix access attempt");
+        return NULL;
+    }
+    if (s->layout == MTX_SYM_PACKED && j > i) {
+        size_t t = i;
+        i = j;
+        j = t;
+    }
+
+    size_t j0, j1;
+    mtx_struct_cols(s, i, &j0, &j1);
+    if (j < j0 || j >= j1) return NULL;
+    return mtx_struct_at(s, i, j);
+}
+
+double mtx_struct_get(const smatrix *s, size_t i, size_t j) {
+    if (!s || i >= s->n || j >= s->n) {
+        MTX_LOG_ERROR("Invalid structured matrix access attempt (const)");
+        return 0.0;
+    }
+    if (s->layout == MTX_SYM_PACKED && j > i) {
+        size_t t = i;
+        i = j;
+        j = t;
+    }
+
+    size_t j0, j1;
+    mtx_struct_cols(s, i, &j0, &j1);
+    return j < j0 || j >= j1 ? 0.0 : *mtx_struct_at(s, i, j);
+}
+
+smatrix *mtx_struct_from_dense(const matrix *mtx, mtx_layout layout, size_t kl, size_t ku) {
+    if (!mtx || !mtx->data) {
+        MTX_LOG_ERROR("Invalid source matrix for structured conversion");
+        return NULL;
+    }
+    if (mtx->w != mtx->h) {
+        MTX_LOG_ERROR("Structured conversion requires a square matrix");
+        return NULL;
+    }
+
+    const size_t n = mtx->h;
+    smatrix *s;
+    switch (layout) {
+    case MTX_BANDED: s = mtx_band_alloc(n, kl, ku); break;
+    case MTX_SYM_PACKED: s = mtx_sym_alloc(n); break;
+    case MTX_TRI_LOWER: s = mtx_tri_alloc(n, 0); break;
+    case MTX_TRI_UPPER: s = mtx_tri_alloc(n, 1); break;
+    default: s = mtx_diag_alloc(n);
+    }
+    if (!s) return NULL;
+
+    for (size_t i = 0; i < n; i++) {
+        size_t j0, j1;
+        mtx_struct_cols(s, i, &j0, &j1);
+        memcpy(mtx_struct_at(s, i, j0), mtx_cat(mtx, i, j0), (j1 - j0) * sizeof(double));
+    }
+
+    MTX_LOG("Dense matrix converted to structured storage");
+    return s;
+}
+
+matrix *mtx_struct_to_dense(const smatrix *s) {
+    if (!s) {
+        MTX_LOG_ERROR("Invalid structured matrix for dense conversion");
+        return NULL;
+    }
+
+    matrix *mtx = mtx_alloc_zero(s->n, s->n);
+    if (!mtx) {
+        MTX_LOG_ERROR("Failed to allocate dense matrix");
+        return NULL;
+    }
+
+    for (size_t i = 0; i < s->n; i++) {
+        size_t j0, j1;
+        mtx_struct_cols(s, i, &j0, &j1);
+        memcpy(mtx_at(mtx, i, j0), mtx_struct_at(s, i, j0), (j1 - j0) * sizeof(double));
+        if (s->layout == MTX_SYM_PACKED) {
+            for (size_t j = j0; j < i; j++) *mtx_at(mtx, j, i) = *mtx_struct_at(s, i, j);
+        }
+    }
+
+    MTX_LOG("Structured matrix converted to dense storage");
+    return mtx;
+}
+
+int mtx_struct_mul(matrix *res, const smatrix *s, const matrix *B) {
+    MTX_METRIC_BEGIN(STRUCT_MUL);
+    if (!res || !res->data || !s || !B || !B->data) {
+        MTX_LOG_ERROR("Null pointer in structured mul");
+        return 1;
+    }
+    if (B->h != s->n || res->h != s->n || res->w != B->w || res == B) {
+        MTX_LOG_ERROR("Incompatible matrix sizes for structured mul");
+        return -1;
+    }
+    if (mtx_unshare(res, 1) != 0) return -2;
+
+    const size_t n = s->n, m = B->w;
+
+    if (s->layout == MTX_SYM_PACKED) {
+        // Each stored a_ij (j < i) contributes to rows i and j, so this one scatters
+        memset(res->data, 0, n * m * sizeof(double));
+        for (size_t i = 0; i < n; i++) {
+            const double *a = mtx_struct_at(s, i, 0);
+            double *ri = mtx_row(res, i);
+            const double *bi = mtx_crow(B, i);
+            for (size_t j = 0; j < i; j++) {
+                if (a[j] == 0.0) continue;
+                mtx_row_axpy(ri, mtx_crow(B, j), a[j], m);
+                mtx_row_axpy(mtx_row(res, j), bi, a[j], m);
+            }
+            mtx_row_axpy(ri, bi, a[i], m);
+        }
+    } else {
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < n; i++) {
+            size_t j0, j1;
+            mtx_struct_cols(s, i, &j0, &j1);
+            const double *a = mtx_struct_at(s, i, j0);
+            double *ri = mtx_row(res, i);
+
+            memset(ri, 0, m * sizeof(double));
+            for (size_t j = j0; j < j1; j++) {
+                if (a[j - j0] != 0.0) mtx_row_axpy(ri, mtx_crow(B, j), a[j - j0], m);
+            }
+        }
+    }
+
+    MTX_LOG("Structured multiplication completed");
+    MTX_METRIC_END(STRUCT_MUL, (s->len + 2 * n * m) * sizeof(double),
+                   (s->layout == MTX_SYM_PACKED ? 2 * s->len - n : s->len) * 2 * m);
+    return 0;
+}
+
+int mtx_struct_add(matrix *mtx, const smatrix *s) {
+    if (!mtx || !mtx->data || !s) {
+        MTX_LOG_ERROR("Null pointer in structured add");
+        return 1;
+    }
+    if (mtx->w != s->n || mtx->h != s->n) {
+        MTX_LOG_ERROR("Matrix size mismatch in structured add");
+        return -1;
+    }
+    if (mtx_unshare(mtx, 1) != 0) return -2;
+
+    for (size_t i = 0; i < s->n; i++) {
+        size_t j0, j1;
+        mtx_struct_cols(s, i, &j0, &j1);
+        mtx_row_axpy(mtx_at(mtx, i, j0), mtx_struct_at(s, i, j0), 1.0, j1 - j0);
+        if (s->layout == MTX_SYM_PACKED) {
+            for (size_t j = j0; j < i; j++) *mtx_at(mtx, j, i) += *mtx_struct_at(s, i, j);
+        }
+    }
+
+    MTX_LOG("Structured addition completed");
+    return 0;
+}
+
+int mtx_struct_add2(smatrix *res, const smatrix *a, const smatrix *b) {
+    if (!res || !a || !b) {
+        MTX_LOG_ERROR("Null pointer in structured add2");
+        return 1;
+    }
+    if (a->layout != b->layout || res->layout != a->layout || a->n != b->n || res->n != a->n ||
+        a->kl != b->kl || a->ku != b->ku || res->kl != a->kl || res->ku != a->ku) {
+        MTX_LOG_ERROR("Layout or size mismatch in structured add2");
+        return -1;
+    }
+
+    for (size_t k = 0; k < res->len; k++) {
+        res->data[k] = a->data[k] + b->data[k];
+    }
+
+    MTX_LOG("Structured addition completed");
+    return 0;
+}
+
+/**
+ * @brief Packed Cholesky (A = L L^T) followed by two triangular solves
+ */
+static int mtx_struct_chol_solve(const smatrix *s, matrix *B) {
+    const size_t n = s->n, m = B->w;
+    double *L = malloc(s->len * sizeof(double));
+    if (!L) return -2;
+    memcpy(L, s->data, s->len * sizeof(double));
+
+    for (size_t i = 0; i < n; i++) {
+        double *li = L + i * (i + 1) / 2;
+        for (size_t j = 0; j <= i; j++) {
+            const double *lj = L + j * (j + 1) / 2;
+            double sum = li[j];
+            for (size_t k = 0; k < j; k++) sum -= li[k] * lj[k];
+            if (j < i) {
+                li[j] = sum / lj[j];
+            } else if (sum <= 0.0) {
+                free(L);
+                return -3;
+            } else {
+                li[i] = sqrt(sum);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        const double *li = L + i * (i + 1) / 2;
+        double *bi = mtx_row(B, i);
+        for (size_t k = 0; k < i; k++) {
+            if (li[k] != 0.0) mtx_row_axpy(bi, mtx_crow(B, k), -li[k], m);
+        }
+        for (size_t c = 0; c < m; c++) bi[c] /= li[i];
+    }
+    for (size_t i = n; i-- > 0;) {
+        const double *li = L + i * (i + 1) / 2;
+        double *bi = mtx_row(B, i);
+        for (size_t c = 0; c < m; c++) bi[c] /= li[i];
+        for (size_t k = 0; k < i; k++) {
+            if (li[k] != 0.0) mtx_row_axpy(mtx_row(B, k), bi, -li[k], m);
+        }
+    }
+
+    free(L);
+    return 0;
+}
+
+int mtx_struct_solve(const smatrix *s, matrix *B) {
+    MTX_METRIC_BEGIN(STRUCT_SOLVE);
+    if (!s || !B || !B->data) {
+        MTX_LOG_ERROR("Null pointer in structured solve");
+        return 1;
+    }
+    if (B->h != s->n) {
+        MTX_LOG_ERROR("Dimension mismatch between S and B");
+        return -1;
+    }
+    if (mtx_unshare(B, 1) != 0) return -2;
+
+    const size_t n = s->n, m = B->w;
+    int rc = 0;
+
+    switch (s->layout) {
+    case MTX_BANDED: {
+        // Factorization logs its own failure (allocation or zero pivot)
+        mtx_band_lu *lu = mtx_band_factor(s);
+        if (!lu) return -3;
+        mtx_band_lu_solve(lu, B);
+        mtx_band_lu_free(lu);
+        break;
+    }
+    case MTX_SYM_PACKED:
+        rc = mtx_struct_chol_solve(s, B);
+        break;
+    case MTX_TRI_LOWER:
+    case MTX_TRI_UPPER: {
+        const int upper = s->layout == MTX_TRI_UPPER;
+        for (size_t step = 0; step < n && rc == 0; step++) {
+            const size_t i = upper ? n - 1 - step : step;
+            size_t j0, j1;
+            mtx_struct_cols(s, i, &j0, &j1);
+            const double *a = mtx_struct_at(s, i, j0);
+            const double d = a[i - j0];
+            if (fabs(d) < MTX_MIN_DIVISOR) {
+                rc = -3;
+                break;
+            }
+
+            double *bi = mtx_row(B, i);
+            for (size_t j = j0; j < j1; j++) {
+                if (j != i && a[j - j0] != 0.0) mtx_row_axpy(bi, mtx_crow(B, j), -a[j - j0], m);
+            }
+            for (size_t c = 0; c < m; c++) bi[c] /= d;
+        }
+        break;
+    }
+    default:
+        for (size_t i = 0; i < n; i++) {
+            if (fabs(s->data[i]) < MTX_MIN_DIVISOR) {
+                rc = -3;
+                break;
+            }
+        }
+        if (rc != 0) break;
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < n; i++) {
+            double *bi = mtx_row(B, i);
+            for (size_t c = 0; c < m; c++) bi[c] /= s->data[i];
+        }
+    }
+
+    if (rc == -2) {
+        MTX_LOG_ERROR("Allocation in structured solve failed");
+        return rc;
+    }
+    if (rc == -3) {
+        MTX_LOG_ERROR("Matrix is singular (zero pivot)");
+        return rc;
+    }
+
+    MTX_LOG("Structured solve completed");
+    MTX_METRIC_END(STRUCT_SOLVE, (s->len + 2 * n * m) * sizeof(double), 2 * s->len * m);
+    return 0;
+}
+
+/* ================== Banded Solvers ================== */
+
+struct mtx_band_lu
+{
+    size_t n, kl, ku;
+    size_t W;           // window width 2kl + ku + 1
+    double *work;       // row i holds columns i - kl .. i + ku + kl
+    size_t *piv;        // row k was swapped with row piv[k]
+};
+
+#define MTX_BAND(f, i, j) ((f)->work[(f)->W * (i) + ((j) + (f)->kl - (i))])
+
+void mtx_band_lu_free(mtx_band_lu *lu) {
+    if (!lu) return;
+    free(lu->work);
+    free(lu->piv);
+    free(lu);
+}
+
+mtx_band_lu *mtx_band_factor(const smatrix *s) {
+    MTX_METRIC_BEGIN(BAND_FACTOR);
+    if (!s || s->layout != MTX_BANDED) {
+        MTX_LOG_ERROR("Banded factorization requires a banded matrix");
+        return NULL;
+    }
+
+    const size_t n = s->n, kl = s->kl, ku = s->ku;
+    mtx_band_lu *f = malloc(sizeof(mtx_band_lu));
+    if (!f) {
+        MTX_LOG_ERROR("Allocation in banded factorization failed");
+        return NULL;
+    }
+    f->n = n;
+    f->kl = kl;
+    f->ku = ku;
+    f->W = 2 * kl + ku + 1;
+    f->work = calloc(n * f->W, sizeof(double));
+    f->piv = malloc(n * sizeof(size_t));
+    if (!f->work || !f->piv) {
+        MTX_LOG_ERROR("Allocation in banded factorization failed");
+        mtx_band_lu_free(f);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        size_t j0, j1;
+        mtx_struct_cols(s, i, &j0, &j1);
+        memcpy(&MTX_BAND(f, i, j0), mtx_struct_at(s, i, j0), (j1 - j0) * sizeof(double));
+    }
+
+    // Swaps only touch columns >= k, so multipliers stay in the row they were
+    // computed for and the solve replays swaps and eliminations step by step
+    for (size_t k = 0; k < n; k++) {
+        const size_t i_end = k + kl + 1 < n ? k + kl + 1 : n;
+        const size_t j_end = k + ku + kl + 1 < n ? k + ku + kl + 1 : n;
+
+        size_t p = k;
+        for (size_t i = k + 1; i < i_end; i++) {
+            if (fabs(MTX_BAND(f, i, k)) > fabs(MTX_BAND(f, p, k))) p = i;
+        }
+        f->piv[k] = p;
+        if (fabs(MTX_BAND(f, p, k)) < MTX_MIN_DIVISOR) {
+            MTX_LOG_ERROR("Matrix is singular (zero pivot)");
+            mtx_band_lu_free(f);
+            return NULL;
+        }
+        if (p != k) {
+            for (size_t j = k; j < j_end; j++) {
+                double t = MTX_BAND(f, k, j);
+                MTX_BAND(f, k, j) = MTX_BAND(f, p, j);
+                MTX_BAND(f, p, j) = t;
+            }
+        }
+
+        const double pivot = MTX_BAND(f, k, k);
+        for (size_t i = k + 1; i < i_end; i++) {
+            const double l = MTX_BAND(f, i, k) / pivot;
+            MTX_BAND(f, i, k) = l;
+            if (l != 0.0) mtx_row_axpy(&MTX_BAND(f, i, k + 1), &MTX_BAND(f, k, k + 1), -l, j_end - k - 1);
+        }
+    }
+
+    MTX_LOG("Banded LU factorization completed");
+    MTX_METRIC_END(BAND_FACTOR, n * f->W * sizeof(double), 2 * n * kl * (kl + ku + 1));
+    return f;
+}
+
+int mtx_band_lu_solve(const mtx_band_lu *f, matrix *B) {
+    if (!f || !B || !B->data) {
+        MTX_LOG_ERROR("Null pointer in banded solve");
+        return 1;
+    }
+    if (B->h != f->n) {
+        MTX_LOG_ERROR("Dimension mismatch between LU and B");
+        return -1;
+    }
+    if (mtx_unshare(B, 1) != 0) return -2;
+
+    const size_t n = f->n, kl = f->kl, ku = f->ku, m = B->w;
+
+    for (size_t k = 0; k < n; k++) {
+        if (f->piv[k] != k) mtx_row_swap(mtx_row(B, k), mtx_row(B, f->piv[k]), m);
+        const size_t i_end = k + kl + 1 < n ? k + kl + 1 : n;
+        for (size_t i = k + 1; i < i_end; i++) {
+            const double l = MTX_BAND(f, i, k);
+            if (l != 0.0) mtx_row_axpy(mtx_row(B, i), mtx_crow(B, k), -l, m);
+        }
+    }
+
+    for (size_t i = n; i-- > 0;) {
+        const size_t j_end = i + ku + kl + 1 < n ? i + ku + kl + 1 : n;
+        double *bi = mtx_row(B, i);
+        for (size_t j = i + 1; j < j_end; j++) {
+            const double u = MTX_BAND(f, i, j);
+            if (u != 0.0) mtx_row_axpy(bi, mtx_crow(B, j), -u, m);
+        }
+        const double d = MTX_BAND(f, i, i);
+        for (size_t c = 0; c < m; c++) bi[c] /= d;
+    }
+
+    MTX_LOG("Banded LU solve completed");
+    return 0;
+}
+
+/**
+ * @brief Thomas forward sweep on rows [s, e) taken as an independent system
+ * @param cp Output modified superdiagonal
+ * @param inv Output reciprocals of the modified diagonal
+ * @return 0 on success, -3 on zero pivot
+ */
+static int mtx_thomas_factor(const double *dl, const double *d, const double *du,
+                             size_t s, size_t e, double *cp, double *inv) {
+    double denom = d[s];
+    for (size_t i = s; i < e; i++) {
+        if (i > s) denom = d[i] - dl[i] * cp[i - 1];
+        if (fabs(denom) < MTX_MIN_DIVISOR) return -3;
+        inv[i] = 1.0 / denom;
+        cp[i] = i + 1 < e ? du[i] * inv[i] : 0.0;
+    }
+    return 0;
+}
+
+/**
+ * @brief Applies a factored block [s, e) to m interleaved right-hand sides y (row stride m)
+ */
+static void mtx_thomas_apply(const double *dl, const double *cp, const double *inv,
+                             size_t s, size_t e, double *y, size_t m) {
+    for (size_t c = 0; c < m; c++) y[m * s + c] *= inv[s];
+    for (size_t i = s + 1; i < e; i++) {
+        double *yi = y + m * i;
+        const double *yp = y + m * (i - 1);
+        for (size_t c = 0; c < m; c++) yi[c] = (yi[c] - dl[i] * yp[c]) * inv[i];
+    }
+    for (size_t i = e - 1; i-- > s;) {
+        double *yi = y + m * i;
+        const double *yn = y + m * (i + 1);
+        for (size_t c = 0; c < m; c++) yi[c] -= cp[i] * yn[c];
+    }
+}
+
+int mtx_tridiag_solve(const double *dl, const double *d, const double *du, matrix *B) {
+    MTX_METRIC_BEGIN(TRIDIAG_SOLVE);
+    if (!dl || !d || !du || !B || !B->data) {
+        MTX_LOG_ERROR("Null pointer in tridiagonal solve");
+        return 1;
+    }
+    if (mtx_unshare(B, 1) != 0) return -2;
+
+    const size_t n = B->h, m = B->w;
+    double *cp = malloc(2 * n * sizeof(double));
+    if (!cp) {
+        MTX_LOG_ERROR("Allocation in tridiagonal solve failed");
+        return -2;
+    }
+    double *inv = cp + n;
+
+    if (mtx_thomas_factor(dl, d, du, 0, n, cp, inv) != 0) {
+        free(cp);
+        MTX_LOG_ERROR("Matrix is singular (zero pivot)");
+        return -3;
+    }
+    mtx_thomas_apply(dl, cp, inv, 0, n, B->data, m);
+
+    free(cp);
+    MTX_LOG("Tridiagonal solve completed");
+    MTX_METRIC_END(TRIDIAG_SOLVE, (3 + 2 * m) * n * sizeof(double), (3 + 5 * m) * n);
+    return 0;
+}
+
+int mtx_tridiag_solve_par(const double *dl, const double *d, const double *du, matrix *B, size_t parts) {
+    MTX_METRIC_BEGIN(TRIDIAG_SOLVE);
+    if (!dl || !d || !du || !B || !B->data) {
+        MTX_LOG_ERROR("Null pointer in parallel tridiagonal solve");
+        return 1;
+    }
+    if (mtx_unshare(B, 1) != 0) return -2;
+
+    const size_t n = B->h, m = B->w;
+    if (parts == 0) {
+#ifdef _OPENMP
+        parts = (size_t)omp_get_max_threads();
+#else
+        parts = 1;
+#endif
+    }
+    if (parts > n / 2) parts = n / 2;
+    if (parts < 2) return mtx_tridiag_solve(dl, d, du, B);
+
+    // Per row: modified superdiagonal, reciprocal pivot, left spike v, right spike w
+    double *ws = malloc(4 * n * sizeof(double));
+    matrix *red = mtx_alloc(m, 2 * parts);
+    smatrix *R = mtx_band_alloc(2 * parts, 2, 2);
+    if (!ws || !red || !R) {
+        free(ws);
+        if (red) mtx_free(red);
+        if (R) mtx_struct_free(R);
+        MTX_LOG_ERROR("Allocation in parallel tridiagonal solve failed");
+        return -2;
+    }
+    double *cp = ws, *inv = ws + n, *v = ws + 2 * n, *w = ws + 3 * n;
+    int rc = 0;
+
+    // 1. Independent block solves: B_p := T_p^-1 B_p and the coupling spikes
+    #pragma omp parallel for schedule(static) reduction(min : rc)
+    for (size_t p = 0; p < parts; p++) {
+        const size_t s = n * p / parts, e = n * (p + 1) / parts;
+        if (mtx_thomas_factor(dl, d, du, s, e, cp, inv) != 0) {
+            rc = -3;
+            continue;
+        }
+        mtx_thomas_apply(dl, cp, inv, s, e, B->data, m);
+
+        for (size_t i = s; i < e; i++) v[i] = w[i] = 0.0;
+        if (p > 0) {
+            v[s] = dl[s];
+            mtx_thomas_apply(dl, cp, inv, s, e, v, 1);
+        }
+        if (p + 1 < parts) {
+            w[e - 1] = du[e - 1];
+            mtx_thomas_apply(dl, cp, inv, s, e, w, 1);
+        }
+    }
+
+    if (rc == 0) {
+        // 2. Reduced system on the first (top) and last (bottom) row of each block:
+        //    x_t(p) + v_t(p) x_b(p-1) + w_t(p) x_t(p+1) = g_t(p), same for the bottom row
+        for (size_t p = 0; p < parts; p++) {
+            const size_t s = n * p / parts, e = n * (p + 1) / parts;
+            const size_t t = 2 * p, b = 2 * p + 1;
+
+            *mtx_struct_ptr(R, t, t) = 1.0;
+            *mtx_struct_ptr(R, b, b) = 1.0;
+            if (p > 0) {
+                *mtx_struct_ptr(R, t, t - 1) = v[s];
+                *mtx_struct_ptr(R, b, t - 1) = v[e - 1];
+            }
+            if (p + 1 < parts) {
+                *mtx_struct_ptr(R, t, t + 2) = w[s];
+                *mtx_struct_ptr(R, b, t + 2) = w[e - 1];
+            }
+            memcpy(mtx_row(red, t), mtx_crow(B, s), m * sizeof(double));
+            memcpy(mtx_row(red, b), mtx_crow(B, e - 1), m * sizeof(double));
+        }
+
+        mtx_band_lu *lu = mtx_band_factor(R);
+        if (!lu || mtx_band_lu_solve(lu, red) != 0) rc = -3;
+        mtx_band_lu_free(lu);
+    }
+
+    if (rc == 0) {
+        // 3. Independent corrections x = g - v x_b(p-1) - w x_t(p+1)
+        #pragma omp parallel for schedule(static)
+        for (size_t p = 0; p < parts; p++) {
+            const size_t s = n * p / parts, e = n * (p + 1) / parts;
+            const double *xl = p > 0 ? mtx_crow(red, 2 * p - 1) : NULL;
+            const double *xr = p + 1 < parts ? mtx_crow(red, 2 * p + 2) : NULL;
+            for (size_t i = s; i < e; i++) {
+                double *bi = mtx_row(B, i);
+                if (xl && v[i] != 0.0) mtx_row_axpy(bi, xl, -v[i], m);
+                if (xr && w[i] != 0.0) mtx_row_axpy(bi, xr, -w[i], m);
+            }
+        }
+    }
+
+    free(ws);
+    mtx_free(red);
+    mtx_struct_free(R);
+    if (rc != 0) {
+        MTX_LOG_ERROR("Matrix is singular (zero pivot)");
+        return rc;
+    }
+
+    MTX_LOG("Parallel tridiagonal solve completed");
+    MTX_METRIC_END(TRIDIAG_SOLVE, (7 + 4 * m) * n * sizeof(double), (11 + 9 * m) * n);
+    return 0;
+}
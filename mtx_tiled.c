@@ -0,0 +1,435 @@
+#include <stdlib.h>
+#include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "mtx_tiled.h"
+#include "mtx_logs.h"
+#include "mtx_metrics.h"
+#include "mtx_internal.h"
+
+/**
+ * @brief Doubles per tile
+ */
+#define MTX_TILE_LEN (MTX_TILE * MTX_TILE)
+
+/**
+ * @brief Alignment of the tile storage; keeps each tile page aligned
+ */
+#define MTX_TILE_ALIGN 4096
+
+struct mtx_tiled
+{
+    double *data;       // tile (ti, tj) at data + MTX_TILE_LEN * (ntw * ti + tj)
+    size_t w, h;
+    size_t nth, ntw;    // tile rows and columns
+};
+
+static inline double *mtx_tile_at(mtx_tiled *t, size_t ti, size_t tj) {
+    return t->data + MTX_TILE_LEN * (t->ntw * ti + tj);
+}
+
+static inline const double *mtx_tile_cat(const mtx_tiled *t, size_t ti, size_t tj) {
+    return t->data + MTX_TILE_LEN * (t->ntw * ti + tj);
+}
+
+/**
+ * @brief Number of rows (or columns) of tile t inside a dimension of length len
+ */
+static inline size_t mtx_tile_extent(size_t len, size_t t) {
+    return len - MTX_TILE * t < MTX_TILE ? len - MTX_TILE * t : MTX_TILE;
+}
+
+/* ================== Storage ================== */
+
+mtx_tiled *mtx_tiled_alloc(size_t w, size_t h) {
+    if (w == 0 || h == 0) {
+        MTX_LOG_ERROR("Attempt to allocate tiled matrix with zero dimensions");
+        return NULL;
+    }
+
+    mtx_tiled *t = malloc(sizeof(mtx_tiled));
+    if (!t) {
+        MTX_LOG_ERROR("Failed to allocate tiled matrix struct");
+        return NULL;
+    }
+
+    t->w = w;
+    t->h = h;
+    t->nth = (h + MTX_TILE - 1) / MTX_TILE;
+    t->ntw = (w + MTX_TILE - 1) / MTX_TILE;
+    const size_t bytes = t->nth * t->ntw * MTX_TILE_LEN * sizeof(double);
+    t->data = aligned_alloc(MTX_TILE_ALIGN, bytes);
+    if (!t->data) {
+        MTX_LOG_ERROR("Failed to allocate tiled matrix data");
+        free(t);
+        return NULL;
+    }
+
+    // Each thread zeroes, and so first touches, the tiles it later works on
+    const size_t nt = t->nth * t->ntw;
+    #pragma omp parallel for schedule(static)
+    for (size_t k = 0; k < nt; k++) memset(t->data + MTX_TILE_LEN * k, 0, MTX_TILE_LEN * sizeof(double));
+
+    MTX_LOG("Tiled matrix was allocated");
+    return t;
+}
+
+void mtx_tiled_free(mtx_tiled *t) {
+    if (!t) return;
+    free(t->data);
+    free(t);
+}
+
+size_t mtx_tiled_get_width(const mtx_tiled *t) {
+    if (!t) {
+        MTX_LOG_ERROR("Tiled matrix is Null. Width cannot be gotten");
+        return 0;
+    }
+    return t->w;
+}
+
+size_t mtx_tiled_get_height(const mtx_tiled *t) {
+    if (!t) {
+        MTX_LOG_ERROR("Tiled matrix is Null. Height cannot be gotten");
+        return 0;
+    }
+    return t->h;
+}
+
+double *mtx_tiled_ptr(mtx_tiled *t, size_t i, size_t j) {
+    if (!t || i >= t->h || j >= t->w) {
+        MTX_LOG_ERROR("Invalid tiled matrix access attempt");
+        return NULL;
+    }
+    return mtx_tile_at(t, i / MTX_TILE, j / MTX_TILE) + MTX_TILE * (i % MTX_TILE) + j % MTX_TILE;
+}
+
+double *mtx_tiled_tile(mtx_tiled *t, size_t ti, size_t tj) {
+    if (!t || ti >= t->nth || tj >= t->ntw) {
+        MTX_LOG_ERROR("Invalid tile access attempt");
+        return NULL;
+    }
+    return mtx_tile_at(t, ti, tj);
+}
+
+int mtx_tiled_from_matrix(mtx_tiled *dst, const matrix *src) {
+    if (!dst || !src || !src->data) {
+        MTX_LOG_ERROR("Null pointer in conversion to tiled matrix");
+        return 1;
+    }
+    if (dst->w != src->w || dst->h != src->h) {
+        MTX_LOG_ERROR("Size mismatch in conversion to tiled matrix");
+        return -1;
+    }
+
+    // One tile row per iteration: source rows are read once, front to back
+    #pragma omp parallel for schedule(static)
+    for (size_t ti = 0; ti < dst->nth; ti++) {
+        const size_t rh = mtx_tile_extent(dst->h, ti);
+        for (size_t r = 0; r < rh; r++) {
+            const double *row = mtx_crow(src, MTX_TILE * ti + r);
+            for (size_t tj = 0; tj < dst->ntw; tj++) {
+                memcpy(mtx_tile_at(dst, ti, tj) + MTX_TILE * r, row + MTX_TILE * tj,
+                       mtx_tile_extent(dst->w, tj) * sizeof(double));
+            }
+        }
+    }
+
+    MTX_LOG("Matrix converted to tiled layout");
+    return 0;
+}
+
+int mtx_tiled_to_matrix(matrix *dst, const mtx_tiled *src) {
+    if (!dst || !dst->data || !src) {
+        MTX_LOG_ERROR("Null pointer in conversion from tiled matrix");
+        return 1;
+    }
+    if (dst->w != src->w || dst->h != src->h) {
+        MTX_LOG_ERROR("Size mismatch in conversion from tiled matrix");
+        return -1;
+    }
+    if (mtx_unshare(dst, 0) != 0) return -2;
+
+    #pragma omp parallel for schedule(static)
+    for (size_t ti = 0; ti < src->nth; ti++) {
+        const size_t rh = mtx_tile_extent(src->h, ti);
+        for (size_t r = 0; r < rh; r++) {
+            double *row = mtx_row(dst, MTX_TILE * ti + r);
+            for (size_t tj = 0; tj < src->ntw; tj++) {
+                memcpy(row + MTX_TILE * tj, mtx_tile_cat(src, ti, tj) + MTX_TILE * r,
+                       mtx_tile_extent(src->w, tj) * sizeof(double));
+            }
+        }
+    }
+
+    MTX_LOG("Tiled matrix converted to row-major layout");
+    return 0;
+}
+
+/* ================== Element-wise Operations ================== */
+
+/**
+ * @brief res = a + f * b, or res = f * a when b is NULL, on the entries inside the matrix
+ * @note Padding is skipped, so it stays zero even for infinite or NaN operands
+ */
+static void mtx_tiled_axpy(mtx_tiled *res, const mtx_tiled *a, const mtx_tiled *b, double f) {
+    const size_t nt = res->nth * res->ntw;
+    #pragma omp parallel for schedule(static)
+    for (size_t k = 0; k < nt; k++) {
+        const size_t rh = mtx_tile_extent(res->h, k / res->ntw);
+        const size_t cw = mtx_tile_extent(res->w, k % res->ntw);
+        double *r = res->data + MTX_TILE_LEN * k;
+        const double *x = a->data + MTX_TILE_LEN * k;
+        const double *y = b ? b->data + MTX_TILE_LEN * k : NULL;
+        for (size_t i = 0; i < rh; i++) {
+            double *ri = r + MTX_TILE * i;
+            const double *xi = x + MTX_TILE * i;
+            if (y) {
+                const double *yi = y + MTX_TILE * i;
+                for (size_t j = 0; j < cw; j++) ri[j] = xi[j] + f * yi[j];
+            } else {
+                for (size_t j = 0; j < cw; j++) ri[j] = f * xi[j];
+            }
+        }
+    }
+}
+
+int mtx_tiled_add2(mtx_tiled *res, const mtx_tiled *a, const mtx_tiled *b) {
+    if (!res || !a || !b) {
+        MTX_LOG_ERROR("Null pointer in tiled addition");
+        return 1;
+    }
+    if (a->w != b->w || a->h != b->h || res->w != a->w || res->h != a->h) {
+        MTX_LOG_ERROR("Size mismatch in tiled addition");
+        return -1;
+    }
+
+    mtx_tiled_axpy(res, a, b, 1.0);
+    MTX_LOG("Tiled addition completed");
+    return 0;
+}
+
+int mtx_tiled_sub2(mtx_tiled *res, const mtx_tiled *a, const mtx_tiled *b) {
+    if (!res || !a || !b) {
+        MTX_LOG_ERROR("Null pointer in tiled subtraction");
+        return 1;
+    }
+    if (a->w != b->w || a->h != b->h || res->w != a->w || res->h != a->h) {
+        MTX_LOG_ERROR("Size mismatch in tiled subtraction");
+        return -1;
+    }
+
+    mtx_tiled_axpy(res, a, b, -1.0);
+    MTX_LOG("Tiled subtraction completed");
+    return 0;
+}
+
+int mtx_tiled_smul2(mtx_tiled *res, const mtx_tiled *a, double d) {
+    if (!res || !a) {
+        MTX_LOG_ERROR("Null pointer in tiled scalar multiplication");
+        return 1;
+    }
+    if (res->w != a->w || res->h != a->h) {
+        MTX_LOG_ERROR("Size mismatch in tiled scalar multiplication");
+        return -1;
+    }
+
+    mtx_tiled_axpy(res, a, NULL, d);
+    MTX_LOG("Tiled scalar multiplication completed");
+    return 0;
+}
+
+/* ================== Tiled Algorithms ================== */
+
+int mtx_tiled_transpose(mtx_tiled *res, const mtx_tiled *src) {
+    if (!res || !src) {
+        MTX_LOG_ERROR("Null pointer in tiled transposition");
+        return 1;
+    }
+    if (res == src || res->w != src->h || res->h != src->w) {
+        MTX_LOG_ERROR("Size mismatch in tiled transposition");
+        return -1;
+    }
+
+    // Padding maps onto padding, so whole tiles are transposed
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (size_t ti = 0; ti < src->nth; ti++) {
+        for (size_t tj = 0; tj < src->ntw; tj++) {
+            const double *restrict s = mtx_tile_cat(src, ti, tj);
+            double *restrict d = mtx_tile_at(res, tj, ti);
+            for (size_t i = 0; i < MTX_TILE; i++) {
+                for (size_t j = 0; j < MTX_TILE; j++) d[MTX_TILE * j + i] = s[MTX_TILE * i + j];
+            }
+        }
+    }
+
+    MTX_LOG("Tiled transposition completed");
+    return 0;
+}
+
+int mtx_tiled_mul(mtx_tiled *C, const mtx_tiled *A, const mtx_tiled *B) {
+    MTX_METRIC_BEGIN(TILED_MUL);
+    if (!C || !A || !B) {
+        MTX_LOG_ERROR("Null pointer in tiled multiplication");
+        return 1;
+    }
+    if (C == A || C == B) {
+        MTX_LOG_ERROR("Output tiled matrix aliases an operand");
+        return -1;
+    }
+    if (A->w != B->h || C->h != A->h || C->w != B->w) {
+        MTX_LOG_ERROR("Size mismatch in tiled multiplication");
+        return -1;
+    }
+
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (size_t ti = 0; ti < C->nth; ti++) {
+        for (size_t tj = 0; tj < C->ntw; tj++) {
+            double *c = mtx_tile_at(C, ti, tj);
+            memset(c, 0, MTX_TILE_LEN * sizeof(double));
+            for (size_t tk = 0; tk < A->ntw; tk++) {
+                mtx_tile_gemm(c, mtx_tile_cat(A, ti, tk), mtx_tile_cat(B, tk, tj), MTX_TILE, MTX_TILE, 1.0);
+            }
+        }
+    }
+
+    MTX_LOG("Tiled multiplication completed");
+    MTX_METRIC_END(TILED_MUL, MTX_MUL_BYTES(C->h, A->w, C->w), MTX_MUL_FLOPS(C->h, A->w, C->w));
+    return 0;
+}
+
+/**
+ * @brief Swaps global rows r1 and r2 inside tile column tj
+ */
+static void mtx_tiled_swap_rows(mtx_tiled *t, size_t tj, size_t r1, size_t r2) {
+    mtx_row_swap(mtx_tile_at(t, r1 / MTX_TILE, tj) + MTX_TILE * (r1 % MTX_TILE),
+                 mtx_tile_at(t, r2 / MTX_TILE, tj) + MTX_TILE * (r2 % MTX_TILE), MTX_TILE);
+}
+
+/**
+ * @brief Factors tile column K in place (unblocked LU with partial pivoting on the panel)
+ * @return 0 on success, -3 if singular
+ */
+static int mtx_tiled_panel(mtx_tiled *A, size_t K, size_t *piv) {
+    const size_t n = A->h;
+    const size_t c0 = K * MTX_TILE;
+    const size_t c1 = c0 + MTX_TILE < n ? c0 + MTX_TILE : n;
+
+    for (size_t c = c0; c < c1; c++) {
+        const size_t lc = c - c0;
+
+        // Pivot search down column c
+        size_t p = c;
+        double best = -1.0;
+        for (size_t I = c / MTX_TILE; I < A->nth; I++) {
+            const size_t b0 = I * MTX_TILE;
+            mtx_tile_pivot(mtx_tile_cat(A, I, K), MTX_TILE, lc, (b0 > c ? b0 : c) - b0,
+                           mtx_tile_extent(n, I), b0, &best, &p);
+        }
+
+        piv[c] = p;
+        if (best < MTX_MIN_DIVISOR) {
+            MTX_LOG_ERROR("Matrix is singular (zero pivot)");
+            return -3;
+        }
+        if (p != c) mtx_tiled_swap_rows(A, K, c, p);
+
+        // Multipliers and rank-1 update of the rest of the panel
+        const double *prow = mtx_tile_cat(A, c / MTX_TILE, K) + MTX_TILE * (c % MTX_TILE);
+        for (size_t I = c / MTX_TILE; I < A->nth; I++) {
+            const size_t b0 = I * MTX_TILE;
+            mtx_tile_eliminate(mtx_tile_at(A, I, K), prow, MTX_TILE, lc, (b0 > c + 1 ? b0 : c + 1) - b0,
+                               mtx_tile_extent(n, I));
+        }
+    }
+    return 0;
+}
+
+int mtx_tiled_lu(mtx_tiled *A, size_t *piv) {
+    MTX_METRIC_BEGIN(TILED_LU);
+    if (!A || !piv) {
+        MTX_LOG_ERROR("Null pointer in tiled LU");
+        return 1;
+    }
+    if (A->w != A->h) {
+        MTX_LOG_ERROR("Tiled LU requires a square matrix");
+        return -1;
+    }
+
+    const size_t n = A->h, nt = A->nth;
+    for (size_t K = 0; K < nt; K++) {
+        const size_t c0 = K * MTX_TILE;
+        const size_t c1 = c0 + MTX_TILE < n ? c0 + MTX_TILE : n;
+
+        const int rc = mtx_tiled_panel(A, K, piv);
+        if (rc != 0) return rc;
+
+        // Apply this panel's interchanges to every other tile column
+        #pragma omp parallel for schedule(static)
+        for (size_t J = 0; J < nt; J++) {
+            if (J == K) continue;
+            for (size_t c = c0; c < c1; c++) {
+                if (piv[c] != c) mtx_tiled_swap_rows(A, J, c, piv[c]);
+            }
+        }
+
+        // U(K, J) = L(K, K)^-1 * A(K, J)
+        #pragma omp parallel for schedule(static)
+        for (size_t J = K + 1; J < nt; J++) {
+            mtx_tile_trsm(mtx_tile_cat(A, K, K), mtx_tile_at(A, K, J), c1 - c0, MTX_TILE);
+        }
+
+        // A(I, J) -= L(I, K) * U(K, J)
+        #pragma omp parallel for collapse(2) schedule(static)
+        for (size_t I = K + 1; I < nt; I++) {
+            for (size_t J = K + 1; J < nt; J++) {
+                mtx_tile_gemm(mtx_tile_at(A, I, J), mtx_tile_cat(A, I, K), mtx_tile_cat(A, K, J),
+                              MTX_TILE, MTX_TILE, -1.0);
+            }
+        }
+    }
+
+    MTX_LOG("Tiled LU factorization completed");
+    MTX_METRIC_END(TILED_LU, 2 * n * n * sizeof(double), 2 * n * n * n / 3);
+    return 0;
+}
+
+int mtx_tiled_lu_solve(const mtx_tiled *LU, const size_t *piv, matrix *B) {
+    if (!LU || !piv || !B || !B->data) {
+        MTX_LOG_ERROR("Null pointer in tiled LU solve");
+        return 1;
+    }
+    if (LU->w != LU->h || LU->h != B->h) {
+        MTX_LOG_ERROR("Size mismatch in tiled LU solve");
+        return -1;
+    }
+    if (mtx_unshare(B, 1) != 0) return -2;
+
+    const size_t n = LU->h, nt = LU->nth, m = B->w;
+
+    for (size_t c = 0; c < n; c++) {
+        if (piv[c] != c) mtx_row_swap(mtx_row(B, c), mtx_row(B, piv[c]), m);
+    }
+
+    // Forward substitution with unit lower L
+    for (size_t I = 0; I < nt; I++) {
+        const size_t r0 = I * MTX_TILE, rows = mtx_tile_extent(n, I);
+        for (size_t J = 0; J < I; J++) {
+            mtx_tile_subst(mtx_tile_cat(LU, I, J), MTX_TILE, B, r0, rows, J * MTX_TILE, mtx_tile_extent(n, J));
+        }
+        mtx_tile_lower_subst(mtx_tile_cat(LU, I, I), MTX_TILE, B, r0, rows);
+    }
+
+    // Backward substitution with U
+    for (size_t I = nt; I-- > 0;) {
+        const size_t r0 = I * MTX_TILE, rows = mtx_tile_extent(n, I);
+        for (size_t J = nt; J-- > I + 1;) {
+            mtx_tile_subst(mtx_tile_cat(LU, I, J), MTX_TILE, B, r0, rows, J * MTX_TILE, mtx_tile_extent(n, J));
+        }
+        mtx_tile_upper_subst(mtx_tile_cat(LU, I, I), MTX_TILE, B, r0, rows);
+    }
+
+    MTX_LOG("Tiled LU solve completed");
+    return 0;
+}
@@ -0,0 +1,512 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <cpuid.h>
+#define MTX_HAVE_CPUID 1
+#endif
+#include "mtx_tune.h"
+#include "mtx_arithmetic.h"
+#include "mtx_logs.h"
+#include "mtx_internal.h"
+
+#define MTX_TUNE_MAX_BLOCK 4096
+#define MTX_TUNE_PATH_MAX 4096
+#define MTX_TUNE_CPU_MAX 256
+
+static pthread_once_t mtx_tune_once = PTHREAD_ONCE_INIT;
+
+static int mtx_tune_read(const char *path, int quiet, mtx_tune_params *out);
+
+/* ================== Machine Detection ================== */
+
+/**
+ * @brief Parses a sysfs cache size ("48K", "2048K", "32M")
+ */
+static size_t mtx_parse_size(const char *s) {
+    char *end;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (*end == 'K') v <<= 10;
+    else if (*end == 'M') v <<= 20;
+    else if (*end == 'G') v <<= 30;
+    return (size_t)v;
+}
+
+/**
+ * @brief Reads a one-line sysfs attribute into buf
+ * @return 0 on success, -1 if missing
+ */
+static int mtx_read_attr(const char *dir, const char *name, char *buf, size_t len) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    int ok = fgets(buf, (int)len, f) != NULL;
+    fclose(f);
+    if (!ok) return -1;
+    buf[strcspn(buf, "\n")] = '\0';
+    return 0;
+}
+
+static void mtx_cache_sysfs(size_t *l1, size_t *l2, size_t *l3) {
+    char dir[128], level[16], type[32], size[32];
+    for (int i = 0; i < 16; i++) {
+        snprintf(dir, sizeof(dir), "/sys/devices/system/cpu/cpu0/cache/index%d", i);
+        if (mtx_read_attr(dir, "level", level, sizeof(level)) != 0) break;
+        if (mtx_read_attr(dir, "type", type, sizeof(type)) != 0) continue;
+        if (mtx_read_attr(dir, "size", size, sizeof(size)) != 0) continue;
+        if (strcmp(type, "Instruction") == 0) continue;
+
+        const size_t bytes = mtx_parse_size(size);
+        switch (atoi(level)) {
+        case 1: *l1 = bytes; break;
+        case 2: *l2 = bytes; break;
+        case 3: *l3 = bytes; break;
+        default: break;
+        }
+    }
+}
+
+#ifdef MTX_HAVE_CPUID
+/**
+ * @brief Deterministic cache parameters: leaf 4 on Intel, 0x8000001D on AMD
+ */
+static void mtx_cache_cpuid(size_t *l1, size_t *l2, size_t *l3) {
+    static const unsigned leaves[] = {4, 0x8000001D};
+    unsigned eax, ebx, ecx, edx;
+
+    for (size_t l = 0; l < sizeof(leaves) / sizeof(leaves[0]); l++) {
+        if (__get_cpuid_max(leaves[l] & 0x80000000u, NULL) < leaves[l]) continue;
+        for (unsigned sub = 0; sub < 16; sub++) {
+            if (!__get_cpuid_count(leaves[l], sub, &eax, &ebx, &ecx, &edx)) break;
+            const unsigned type = eax & 0x1f; // 1 data, 2 instruction, 3 unified
+            if (type == 0) break;
+            if (type == 2) continue;
+
+            const size_t bytes = (size_t)((ebx >> 22) + 1) * (((ebx >> 12) & 0x3ff) + 1) *
+                                 ((ebx & 0xfff) + 1) * ((size_t)ecx + 1);
+            switch ((eax >> 5) & 7) {
+            case 1: if (!*l1) *l1 = bytes; break;
+            case 2: if (!*l2) *l2 = bytes; break;
+            case 3: if (!*l3) *l3 = bytes; break;
+            default: break;
+            }
+        }
+        if (*l1) return;
+    }
+}
+#endif
+
+/**
+ * @brief CPU model name from /proc/cpuinfo, "unknown" if not found
+ */
+static void mtx_cpu_model(char *buf, size_t len) {
+    snprintf(buf, len, "unknown");
+    FILE *f = fopen("/proc/cpuinfo", "r");
+    if (!f) return;
+
+    char line[512];
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "model name", 10) != 0) continue;
+        const char *v = strchr(line, ':');
+        if (!v) continue;
+        v++;
+        while (*v == ' ' || *v == '\t') v++;
+        snprintf(buf, len, "%s", v);
+        buf[strcspn(buf, "\n")] = '\0';
+        break;
+    }
+    fclose(f);
+}
+
+/* ================== Parameters ================== */
+
+void mtx_tune_defaults(mtx_tune_params *params) {
+    if (!params) {
+        MTX_LOG_ERROR("Null pointer in tune defaults");
+        return;
+    }
+
+    size_t l1 = 0, l2 = 0, l3 = 0;
+    mtx_cache_sysfs(&l1, &l2, &l3);
+#ifdef MTX_HAVE_CPUID
+    if (!l1 || !l2) mtx_cache_cpuid(&l1, &l2, &l3);
+#endif
+
+    size_t b = MTX_BLOCK_SIZE, bj = MTX_BLOCK_SIZE;
+    if (l1) {
+        // Square A and B tiles together in half of L1
+        b = 8;
+        while (2 * (2 * b) * (2 * b) * sizeof(double) <= l1 / 2 && b < 256) b *= 2;
+        bj = b;
+        // Longer rows of B for the vectorized inner loop, keeping B and C tiles in a quarter of L2
+        while (l2 && 2 * b * (2 * bj) * sizeof(double) <= l2 / 4 && bj < 128) bj *= 2;
+    }
+
+    *params = (mtx_tune_params){
+        .block_i = b, .block_k = b, .block_j = bj,
+        .skinny_width = MTX_SKINNY_WIDTH,
+        .par_min = MTX_SKINNY_PAR_MIN,
+        .l1 = l1, .l2 = l2, .l3 = l3
+    };
+}
+
+static int mtx_tune_valid(const mtx_tune_params *p) {
+    return p->block_i && p->block_i <= MTX_TUNE_MAX_BLOCK &&
+           p->block_k && p->block_k <= MTX_TUNE_MAX_BLOCK &&
+           p->block_j && p->block_j <= MTX_TUNE_MAX_BLOCK &&
+           p->skinny_width && p->skinny_width <= MTX_SKINNY_WIDTH;
+}
+
+/**
+ * @brief Loads the profile into the default context; contexts created later copy it
+ */
+static void mtx_tune_init(void) {
+    mtx_tune_params *p = &mtx_context_default()->tune;
+    mtx_tune_defaults(p);
+    mtx_tune_read(NULL, 1, p);
+}
+
+/**
+ * @brief Parameters of the calling thread's current context
+ */
+static mtx_tune_params *mtx_tune_active(void) {
+    pthread_once(&mtx_tune_once, mtx_tune_init);
+    return &mtx_context_current()->tune;
+}
+
+const mtx_tune_params *mtx_tune_get(void) {
+    return mtx_tune_active();
+}
+
+int mtx_tune_set(const mtx_tune_params *params) {
+    return mtx_context_set_tune(mtx_context_current(), params);
+}
+
+int mtx_context_set_tune(mtx_context *ctx, const mtx_tune_params *params) {
+    if (!ctx) {
+        MTX_LOG_ERROR("Null context in set_tune");
+        return 1;
+    }
+    pthread_once(&mtx_tune_once, mtx_tune_init);
+    if (!params) {
+        mtx_tune_defaults(&ctx->tune);
+        MTX_LOG("Tuning parameters reset to defaults");
+        return 0;
+    }
+    if (!mtx_tune_valid(params)) {
+        MTX_LOG_ERROR("Tuning parameter out of range");
+        return -1;
+    }
+
+    ctx->tune = *params;
+    MTX_LOG("Tuning parameters changed");
+    return 0;
+}
+
+const mtx_tune_params *mtx_context_get_tune(const mtx_context *ctx) {
+    if (!ctx) {
+        MTX_LOG_ERROR("Null context in get_tune");
+        return NULL;
+    }
+    pthread_once(&mtx_tune_once, mtx_tune_init);
+    return &ctx->tune;
+}
+
+/* ================== Profiles ================== */
+
+/**
+ * @brief Resolves the profile location
+ * @return 0 on success, 1 if neither MTX_TUNE_PROFILE nor HOME is set
+ */
+static int mtx_tune_path(const char *path, char *buf, size_t len) {
+    if (path) {
+        snprintf(buf, len, "%s", path);
+        return 0;
+    }
+    const char *env = getenv(MTX_TUNE_ENV);
+    if (env && *env) {
+        snprintf(buf, len, "%s", env);
+        return 0;
+    }
+    const char *home = getenv("HOME");
+    if (!home || !*home) return 1;
+    snprintf(buf, len, "%s/.mtx_tune", home);
+    return 0;
+}
+
+static int mtx_tune_read(const char *path, int quiet, mtx_tune_params *out) {
+    char file[MTX_TUNE_PATH_MAX];
+    if (mtx_tune_path(path, file, sizeof(file)) != 0) {
+        if (!quiet) MTX_LOG_ERROR("No profile location (set MTX_TUNE_PROFILE or HOME)");
+        return 1;
+    }
+
+    FILE *f = fopen(file, "r");
+    if (!f) {
+        if (!quiet) MTX_LOG_ERROR("Failed to open tuning profile");
+        return -2;
+    }
+
+    char cpu[MTX_TUNE_CPU_MAX], line[512];
+    mtx_cpu_model(cpu, sizeof(cpu));
+    mtx_tune_params p = *out;
+    int same_cpu = 0;
+
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\n")] = '\0';
+        if (line[0] == '#' || line[0] == '\0') continue;
+
+        char *val = strchr(line, ' ');
+        if (!val) continue;
+        *val++ = '\0';
+
+        if (strcmp(line, "cpu") == 0) {
+            same_cpu = strcmp(val, cpu) == 0;
+            continue;
+        }
+
+        const size_t v = (size_t)strtoull(val, NULL, 10);
+        if (strcmp(line, "block_i") == 0) p.block_i = v;
+        else if (strcmp(line, "block_k") == 0) p.block_k = v;
+        else if (strcmp(line, "block_j") == 0) p.block_j = v;
+        else if (strcmp(line, "skinny_width") == 0) p.skinny_width = v;
+        else if (strcmp(line, "par_min") == 0) p.par_min = v;
+        else if (strcmp(line, "l1") == 0) p.l1 = v;
+        else if (strcmp(line, "l2") == 0) p.l2 = v;
+        else if (strcmp(line, "l3") == 0) p.l3 = v;
+    }
+    fclose(f);
+
+    if (!same_cpu) {
+        if (!quiet) MTX_LOG_ERROR("Tuning profile was written on another CPU model");
+        return -1;
+    }
+    if (!mtx_tune_valid(&p)) {
+        if (!quiet) MTX_LOG_ERROR("Malformed tuning profile");
+        return -1;
+    }
+
+    *out = p;
+    MTX_LOG("Tuning profile loaded");
+    return 0;
+}
+
+int mtx_tune_load(const char *path) {
+    return mtx_tune_read(path, 0, mtx_tune_active());
+}
+
+int mtx_tune_save(const char *path) {
+    const mtx_tune_params *p = mtx_tune_get();
+
+    char file[MTX_TUNE_PATH_MAX];
+    if (mtx_tune_path(path, file, sizeof(file)) != 0) {
+        MTX_LOG_ERROR("No profile location (set MTX_TUNE_PROFILE or HOME)");
+        return 1;
+    }
+
+    FILE *f = fopen(file, "w");
+    if (!f) {
+        MTX_LOG_ERROR("Failed to create tuning profile");
+        return -2;
+    }
+
+    char cpu[MTX_TUNE_CPU_MAX];
+    mtx_cpu_model(cpu, sizeof(cpu));
+    fprintf(f, "# mtx tuning profile\n");
+    fprintf(f, "cpu %s\n", cpu);
+    fprintf(f, "block_i %zu\nblock_k %zu\nblock_j %zu\n", p->block_i, p->block_k, p->block_j);
+    fprintf(f, "skinny_width %zu\npar_min %zu\n", p->skinny_width, p->par_min);
+    fprintf(f, "l1 %zu\nl2 %zu\nl3 %zu\n", p->l1, p->l2, p->l3);
+
+    if (fclose(f) != 0) {
+        MTX_LOG_ERROR("Failed to write tuning profile");
+        return -2;
+    }
+    MTX_LOG("Tuning profile saved");
+    return 0;
+}
+
+/* ================== Benchmarks ================== */
+
+static double mtx_tune_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Best time of reps runs of dest = A * B with the active parameters
+ */
+static double mtx_tune_time(matrix *dest, const matrix *A, const matrix *B, int reps,
+                            void (*kernel)(matrix *, const matrix *, const matrix *)) {
+    double best = 1e300;
+    for (int r = 0; r < reps; r++) {
+        const double t = mtx_tune_now();
+        kernel(dest, A, B);
+        const double dt = mtx_tune_now() - t;
+        if (dt < best) best = dt;
+    }
+    return best;
+}
+
+static void mtx_tune_fill(matrix *m) {
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < m->w * m->h; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        m->data[i] = (double)(x >> 11) * 0x1.0p-53 - 0.5;
+    }
+}
+
+/**
+ * @return 0 on success, -2 if allocation failed
+ */
+static int mtx_tune_blocks(mtx_tune_params *best) {
+    static const size_t ci[] = {16, 32, 64};
+    static const size_t ck[] = {32, 64, 128, 256};
+    static const size_t cj[] = {32, 64, 128, 256};
+    const size_t n = 384;
+    mtx_tune_params *cur = mtx_tune_active();
+
+    int rc = -2;
+    matrix *A = mtx_alloc(n, n), *B = mtx_alloc(n, n), *C = mtx_alloc(n, n);
+    if (!A || !B || !C) goto out;
+    mtx_tune_fill(A);
+    mtx_tune_fill(B);
+
+    double best_t = mtx_tune_time(C, A, B, 3, mtx_block_mul);
+    for (size_t a = 0; a < sizeof(ci) / sizeof(ci[0]); a++)
+    for (size_t b = 0; b < sizeof(ck) / sizeof(ck[0]); b++)
+    for (size_t c = 0; c < sizeof(cj) / sizeof(cj[0]); c++) {
+        // Skip B tiles that cannot stay in L2
+        if (best->l2 && ck[b] * cj[c] * sizeof(double) > best->l2) continue;
+        cur->block_i = ci[a];
+        cur->block_k = ck[b];
+        cur->block_j = cj[c];
+        const double t = mtx_tune_time(C, A, B, 3, mtx_block_mul);
+        if (t < best_t) {
+            best_t = t;
+            best->block_i = ci[a];
+            best->block_k = ck[b];
+            best->block_j = cj[c];
+        }
+    }
+    *cur = *best;
+    rc = 0;
+
+out:
+    if (A) mtx_free(A);
+    if (B) mtx_free(B);
+    if (C) mtx_free(C);
+    return rc;
+}
+
+/**
+ * @return 0 on success, -2 if allocation failed
+ */
+static int mtx_tune_skinny(mtx_tune_params *best) {
+    const size_t n = 1024;
+    int rc = -2;
+    matrix *A = mtx_alloc(n, n), *B = mtx_alloc(MTX_SKINNY_WIDTH, n), *C = mtx_alloc(MTX_SKINNY_WIDTH, n);
+    if (!A || !B || !C) goto out;
+    mtx_tune_fill(A);
+    mtx_tune_fill(B);
+
+    best->skinny_width = 1;
+    for (size_t w = 2; w <= MTX_SKINNY_WIDTH; w++) {
+        // Narrow views of the same buffers
+        const matrix b = {.data = B->data, .w = w, .h = n, .map_len = 0};
+        matrix c = {.data = C->data, .w = w, .h = n, .map_len = 0};
+        const double ts = mtx_tune_time(&c, A, &b, 3, mtx_mul_kernel);
+        const double tb = mtx_tune_time(&c, A, &b, 3, mtx_block_mul);
+        if (ts > tb) break;
+        best->skinny_width = w;
+    }
+    rc = 0;
+
+out:
+    if (A) mtx_free(A);
+    if (B) mtx_free(B);
+    if (C) mtx_free(C);
+    return rc;
+}
+
+/**
+ * @return 0 on success, -2 if allocation failed
+ */
+static int mtx_tune_threads(mtx_tune_params *best) {
+#ifdef _OPENMP
+    if (omp_get_max_threads() < 2) return 0; // nothing to measure, keep the default
+    const size_t nmax = 2048;
+    mtx_tune_params *cur = mtx_tune_active();
+    int rc = -2;
+    matrix *A = mtx_alloc(nmax, nmax), *x = mtx_alloc(1, nmax), *y = mtx_alloc(1, nmax);
+    if (!A || !x || !y) goto out;
+    mtx_tune_fill(A);
+    mtx_tune_fill(x);
+
+    best->par_min = nmax * nmax;
+    for (size_t n = 32; n <= nmax; n *= 2) {
+        const matrix a = {.data = A->data, .w = n, .h = n, .map_len = 0};
+        const matrix v = {.data = x->data, .w = 1, .h = n, .map_len = 0};
+        matrix r = {.data = y->data, .w = 1, .h = n, .map_len = 0};
+
+        cur->par_min = SIZE_MAX;
+        const double serial = mtx_tune_time(&r, &a, &v, 5, mtx_mul_kernel);
+        cur->par_min = 0;
+        const double threaded = mtx_tune_time(&r, &a, &v, 5, mtx_mul_kernel);
+        if (threaded < serial) {
+            best->par_min = n * n / 2;
+            break;
+        }
+    }
+    *cur = *best;
+    rc = 0;
+
+out:
+    if (A) mtx_free(A);
+    if (x) mtx_free(x);
+    if (y) mtx_free(y);
+    return rc;
+#else
+    (void)best;
+    return 0;
+#endif
+}
+
+int mtx_tune_run(const char *path) {
+    mtx_tune_params best;
+    mtx_tune_defaults(&best);
+    mtx_tune_params *cur = mtx_tune_active();
+    *cur = best;
+
+    MTX_LOG("Tuning blocked multiply");
+    int rc = mtx_tune_blocks(&best);
+    if (rc == 0) {
+        MTX_LOG("Tuning skinny kernel crossover");
+        rc = mtx_tune_skinny(&best);
+    }
+    if (rc == 0) {
+        MTX_LOG("Tuning thread threshold");
+        rc = mtx_tune_threads(&best);
+    }
+
+    // Keep what was measured, but never save a partly tuned profile for this CPU
+    *cur = best;
+    if (rc != 0) {
+        MTX_LOG_ERROR("Allocation in tuning failed");
+        return rc;
+    }
+    MTX_LOG("Tuning completed");
+    return path ? mtx_tune_save(path) : 0;
+}